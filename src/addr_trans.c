@@ -32,6 +32,7 @@
 #include "debug/debug_macros.h"
 #include "globals/assert.h"
 #include "globals/utils.h"
+#include "general.param.h"
 #include "memory/memory.param.h"
 #include "ramulator.param.h"
 
@@ -56,7 +57,10 @@ Addr addr_translate(Addr virt_addr) {
    * address bits are redundant because they are the output of sign extension
    * (i.e., all 0s or all 1s). */
   uns  num_page_offset_bits = LOG2(VA_PAGE_SIZE_BYTES);
-  Addr page_index           = virt_addr >> num_page_offset_bits;
+  /* in a shared address space all cores map a page to the same frame */
+  Addr page_index = (SHARED_ADDRESS_SPACE ? convert_to_cmp_addr(0, virt_addr) :
+                                            virt_addr) >>
+                    num_page_offset_bits;
   // we already use the 6 highest bits to store the proc_id.
   // NUM_ADDR_NON_SIGN_EXTEND_BITS tells us how many bits we actually need to
   // keep, and the bits that are left are used to store the original bits after
@@ -265,6 +265,7 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
   op->oracle_info.pred_addr         = addr;
   op->oracle_info.btb_miss_resolved = FALSE;
   op->cf_within_fetch               = br_num;
+  bp_data->btb_bubble               = 0;
 
   /* initialize recovery information---this stuff might be
      overwritten by a prediction function that uses and
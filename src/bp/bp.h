@@ -34,6 +34,8 @@
 #include "libs/hash_lib.h"
 #include "op.h"
 
+#define BTB_ML_MAX_LEVELS 3
+
 /**************************************************************************************/
 // Branch prediction recovery information
 
@@ -141,6 +143,9 @@ typedef struct Bp_Data_struct {
 
   uns32 global_hist;
   Cache btb;
+  Cache btb_ml[BTB_ML_MAX_LEVELS];  // levels of the multi-level btb
+  Cache btb_ml_bundles;  // branches seen in each icache line, for prefill
+  uns   btb_bubble;      // fetch bubbles before the last btb target is known
 
   struct {
     Crs_Entry* entries;
@@ -186,6 +191,7 @@ typedef enum Bp_Id_enum {
 
 typedef enum Btb_Id_enum {
   GENERIC_BTB,
+  MULTILEVEL_BTB,
   NUM_BTB,
 } Btb_Id;
 
@@ -42,6 +42,7 @@
 #include "bp/bp.param.h"
 #include "core.param.h"
 #include "debug/debug.param.h"
+#include "memory/memory.param.h"
 #include "statistics.h"
 
 
@@ -53,6 +54,34 @@
 #define DEBUGU_CRS(proc_id, args...) _DEBUGU(proc_id, DEBUG_CRS, ##args)
 #define DEBUG_BTB(proc_id, args...) _DEBUG(proc_id, DEBUG_BTB, ##args)
 
+#define BTB_ML_BUNDLE_BRANCHES 4
+
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Btb_Ml_Entry_struct {
+  Addr    target;  // must stay first, pred hands out a pointer to it
+  Cf_Type cf_type;
+  Flag    prefilled;  // inserted by prefill and not yet used
+} Btb_Ml_Entry;
+
+typedef struct Btb_Ml_Bundle_struct {
+  uns          count;
+  uns          next;  // round-robin victim once the bundle is full
+  Addr         addr[BTB_ML_BUNDLE_BRANCHES];
+  Btb_Ml_Entry entry[BTB_ML_BUNDLE_BRANCHES];
+} Btb_Ml_Bundle;
+
+
+/**************************************************************************************/
+/* Prototypes */
+
+static uns           btb_ml_bubble(uns level);
+static Flag          btb_ml_allowed(uns level, Cf_Type cf_type);
+static Btb_Ml_Entry* btb_ml_insert(Bp_Data* bp_data, uns level, Addr addr);
+static void btb_ml_record(Bp_Data* bp_data, Addr addr, Btb_Ml_Entry* entry);
+
 
 /**************************************************************************************/
 /* bp_crs_push: */
@@ -309,6 +338,230 @@ void bp_btb_gen_update(Bp_Data* bp_data, Op* op) {
 }
 
 
+/**************************************************************************************/
+/* Multi-level BTB: a small L0 backed by larger levels that need more cycles
+   to deliver a target.  All levels are looked up together and the closest
+   level that hits sets the fetch bubbles a taken prediction pays (see
+   icache_issue_ops).  A hit below L0 is copied into the levels above it, and
+   a branch that misses everywhere is written into every level once its
+   target is known.
+
+   With BTB_ML_TYPE_AWARE, conditional branches are kept out of the last
+   level, which then only holds unconditional branches, calls and returns
+   (the Shotgun split between a large U-BTB and a small C-BTB).
+
+   With BTB_ML_PREFILL, a line-indexed bundle table remembers up to
+   BTB_ML_BUNDLE_BRANCHES branches per icache line.  An icache miss copies
+   the bundle of the missing line into BTB_ML_PREFILL_LEVEL, so its branches
+   are there before fetch reaches them. */
+
+static uns btb_ml_bubble(uns level) {
+  switch(level) {
+    case 0:
+      return BTB_ML_L0_BUBBLE;
+    case 1:
+      return BTB_ML_L1_BUBBLE;
+    default:
+      return BTB_ML_L2_BUBBLE;
+  }
+}
+
+static Flag btb_ml_allowed(uns level, Cf_Type cf_type) {
+  return !(BTB_ML_TYPE_AWARE && BTB_ML_LEVELS > 1 &&
+           level == BTB_ML_LEVELS - 1 && cf_type == CF_CBR);
+}
+
+static Btb_Ml_Entry* btb_ml_insert(Bp_Data* bp_data, uns level, Addr addr) {
+  Addr          line_addr, repl_line_addr;
+  Btb_Ml_Entry* entry;
+
+  entry = (Btb_Ml_Entry*)cache_access(&bp_data->btb_ml[level], addr,
+                                      &line_addr, FALSE);
+  if(!entry)
+    entry = (Btb_Ml_Entry*)cache_insert(&bp_data->btb_ml[level],
+                                        bp_data->proc_id, addr, &line_addr,
+                                        &repl_line_addr);
+  return entry;
+}
+
+static void btb_ml_record(Bp_Data* bp_data, Addr addr, Btb_Ml_Entry* entry) {
+  Addr           line_addr, repl_line_addr;
+  Btb_Ml_Bundle* bundle;
+  uns            ii;
+
+  bundle = (Btb_Ml_Bundle*)cache_access(&bp_data->btb_ml_bundles, addr,
+                                        &line_addr, TRUE);
+  if(!bundle) {
+    bundle = (Btb_Ml_Bundle*)cache_insert(&bp_data->btb_ml_bundles,
+                                          bp_data->proc_id, addr, &line_addr,
+                                          &repl_line_addr);
+    memset(bundle, 0, sizeof(Btb_Ml_Bundle));
+  }
+
+  for(ii = 0; ii < bundle->count; ii++)
+    if(bundle->addr[ii] == addr)
+      break;
+  if(ii == bundle->count) {
+    if(bundle->count < BTB_ML_BUNDLE_BRANCHES)
+      bundle->count++;
+    else {
+      ii           = bundle->next;
+      bundle->next = (bundle->next + 1) % BTB_ML_BUNDLE_BRANCHES;
+    }
+  }
+  bundle->addr[ii]            = addr;
+  bundle->entry[ii]           = *entry;
+  bundle->entry[ii].prefilled = FALSE;
+}
+
+
+/**************************************************************************************/
+/* bp_btb_ml_init: */
+
+void bp_btb_ml_init(Bp_Data* bp_data) {
+  const uns entries[BTB_ML_MAX_LEVELS] = {BTB_ML_L0_ENTRIES, BTB_ML_L1_ENTRIES,
+                                          BTB_ML_L2_ENTRIES};
+  const uns assoc[BTB_ML_MAX_LEVELS]   = {BTB_ML_L0_ASSOC, BTB_ML_L1_ASSOC,
+                                        BTB_ML_L2_ASSOC};
+  static const char* names[BTB_ML_MAX_LEVELS] = {"BTB_L0", "BTB_L1",
+                                                 "BTB_L2"};
+  uns                level;
+
+  ASSERTM(bp_data->proc_id,
+          BTB_ML_LEVELS >= 1 && BTB_ML_LEVELS <= BTB_ML_MAX_LEVELS,
+          "BTB_ML_LEVELS must be between 1 and %d\n", BTB_ML_MAX_LEVELS);
+  ASSERTM(bp_data->proc_id,
+          !BTB_ML_PREFILL || BTB_ML_PREFILL_LEVEL < BTB_ML_LEVELS,
+          "BTB_ML_PREFILL_LEVEL must be one of the BTB_ML_LEVELS levels\n");
+
+  // btb line size set to 1
+  for(level = 0; level < BTB_ML_LEVELS; level++)
+    init_cache(&bp_data->btb_ml[level], names[level], entries[level],
+               assoc[level], 1, sizeof(Btb_Ml_Entry), REPL_TRUE_LRU);
+
+  if(BTB_ML_PREFILL)
+    init_cache(&bp_data->btb_ml_bundles, "BTB_BUNDLES", BTB_ML_PREFILL_LINES,
+               BTB_ML_PREFILL_ASSOC, ICACHE_LINE_SIZE, sizeof(Btb_Ml_Bundle),
+               REPL_TRUE_LRU);
+}
+
+
+/**************************************************************************************/
+/* bp_btb_ml_pred: */
+
+Addr* bp_btb_ml_pred(Bp_Data* bp_data, Op* op) {
+  Addr          addr  = op->oracle_info.pred_addr;
+  Btb_Ml_Entry* entry = NULL;
+  Addr          line_addr;
+  uns           level, ii;
+
+  if(PERFECT_BTB)
+    return &op->oracle_info.target;
+
+  for(level = 0; level < BTB_ML_LEVELS; level++) {
+    entry = (Btb_Ml_Entry*)cache_access(&bp_data->btb_ml[level], addr,
+                                        &line_addr, TRUE);
+    if(entry)
+      break;
+  }
+
+  if(!op->off_path) {
+    STAT_EVENT(op->proc_id, entry ? BTB_ML_L0_HIT + level : BTB_ML_MISS);
+    for(ii = 0; ii < level; ii++)
+      STAT_EVENT(op->proc_id, BTB_ML_L0_MPKI + ii);
+  }
+
+  if(!entry)
+    return NULL;
+
+  DEBUG_BTB(bp_data->proc_id, "BTB L%d hit  addr:0x%s  target:0x%s\n", level,
+            hexstr64s(addr), hexstr64s(entry->target));
+
+  if(entry->prefilled) {
+    entry->prefilled = FALSE;
+    if(!op->off_path)
+      STAT_EVENT(op->proc_id, BTB_ML_PREFILL_USEFUL);
+  }
+
+  bp_data->btb_bubble = btb_ml_bubble(level);
+
+  if(level > 0 && (BTB_OFF_PATH_WRITES || !op->off_path)) {
+    for(ii = 0; ii < level; ii++)
+      if(btb_ml_allowed(ii, entry->cf_type))
+        *btb_ml_insert(bp_data, ii, addr) = *entry;
+  }
+
+  return &entry->target;
+}
+
+
+/**************************************************************************************/
+/* bp_btb_ml_update: */
+
+void bp_btb_ml_update(Bp_Data* bp_data, Op* op) {
+  Addr         addr = op->oracle_info.pred_addr;
+  Btb_Ml_Entry entry;
+  uns          level;
+
+  ASSERT(bp_data->proc_id, bp_data->proc_id == op->proc_id);
+  if(!BTB_OFF_PATH_WRITES && op->off_path)
+    return;
+
+  DEBUG_BTB(bp_data->proc_id, "Writing BTB  addr:0x%s  target:0x%s\n",
+            hexstr64s(addr), hexstr64s(op->oracle_info.target));
+  STAT_EVENT(op->proc_id, BTB_ON_PATH_WRITE + op->off_path);
+
+  entry.target    = op->oracle_info.target;
+  entry.cf_type   = op->table_info->cf_type;
+  entry.prefilled = FALSE;
+  for(level = 0; level < BTB_ML_LEVELS; level++)
+    if(btb_ml_allowed(level, entry.cf_type))
+      *btb_ml_insert(bp_data, level, addr) = entry;
+
+  if(BTB_ML_PREFILL)
+    btb_ml_record(bp_data, addr, &entry);
+}
+
+
+/**************************************************************************************/
+/* bp_btb_ml_prefill: called on an icache miss to copy the branches known to
+   live in the missing line into the btb ahead of fetch. A branch that may not
+   live in BTB_ML_PREFILL_LEVEL goes to the closest faster level. */
+
+void bp_btb_ml_prefill(Bp_Data* bp_data, Addr line_addr) {
+  Btb_Ml_Bundle* bundle;
+  Btb_Ml_Entry*  entry;
+  Addr           bundle_addr, entry_addr;
+  uns            ii, level;
+
+  if(!BTB_ML_PREFILL || bp_data->bp_btb->id != MULTILEVEL_BTB)
+    return;
+
+  bundle = (Btb_Ml_Bundle*)cache_access(&bp_data->btb_ml_bundles, line_addr,
+                                        &bundle_addr, FALSE);
+  if(!bundle)
+    return;
+
+  STAT_EVENT(bp_data->proc_id, BTB_ML_PREFILL_LINE);
+  for(ii = 0; ii < bundle->count; ii++) {
+    for(level = BTB_ML_PREFILL_LEVEL;
+        level > 0 && !btb_ml_allowed(level, bundle->entry[ii].cf_type);
+        level--)
+      ;
+    entry = (Btb_Ml_Entry*)cache_access(&bp_data->btb_ml[level],
+                                        bundle->addr[ii], &entry_addr, FALSE);
+    if(entry)
+      continue;
+    entry            = btb_ml_insert(bp_data, level, bundle->addr[ii]);
+    *entry           = bundle->entry[ii];
+    entry->prefilled = TRUE;
+    STAT_EVENT(bp_data->proc_id, BTB_ML_PREFILL_INSERT);
+    DEBUG_BTB(bp_data->proc_id, "Prefill BTB L%d  addr:0x%s  target:0x%s\n",
+              level, hexstr64s(bundle->addr[ii]), hexstr64s(entry->target));
+  }
+}
+
+
 /**************************************************************************************/
 /* bp_tc_tagged_init: */
 
@@ -46,6 +46,11 @@ void  bp_btb_gen_init(Bp_Data*);
 Addr* bp_btb_gen_pred(Bp_Data*, Op*);
 void  bp_btb_gen_update(Bp_Data*, Op*);
 
+void  bp_btb_ml_init(Bp_Data*);
+Addr* bp_btb_ml_pred(Bp_Data*, Op*);
+void  bp_btb_ml_update(Bp_Data*, Op*);
+void  bp_btb_ml_prefill(Bp_Data*, Addr);
+
 void bp_ibtb_tc_tagged_init(Bp_Data*);
 Addr bp_ibtb_tc_tagged_pred(Bp_Data*, Op*);
 void bp_ibtb_tc_tagged_update(Bp_Data*, Op*);
@@ -26,6 +26,8 @@ template <typename CBP_CLASS>
 class CBP_To_Scarab_Intf {
   std::vector<CBP_CLASS> cbp_predictors;
 
+  CBP_CLASS& predictor(uns proc_id) { return cbp_predictors.at(proc_id); }
+
  public:
   void init() {
     if(cbp_predictors.size() == 0) {
@@ -33,6 +35,11 @@ class CBP_To_Scarab_Intf {
       for(uns i = 0; i < NUM_CORES; ++i) {
         cbp_predictors.emplace_back();
       }
+      if(cbp_shared_across_cores<CBP_CLASS>()) {
+        for(uns i = 1; i < NUM_CORES; ++i) {
+          cbp_share_tables(cbp_predictors[i], cbp_predictors[0]);
+        }
+      }
     }
     ASSERTM(0, cbp_predictors.size() == NUM_CORES,
             "cbp_predictors not initialized correctly");
@@ -47,7 +54,7 @@ class CBP_To_Scarab_Intf {
     uns proc_id = op->proc_id;
     if(op->off_path)
       return op->oracle_info.dir;
-    return cbp_predictors.at(proc_id).GetPrediction(op->inst_info->addr);
+    return predictor(proc_id).GetPrediction(op->inst_info->addr);
   }
 
   void spec_update(Op* op) {
@@ -59,13 +66,13 @@ class CBP_To_Scarab_Intf {
     OpType optype  = scarab_to_cbp_optype(op);
 
     if(is_conditional_branch(op)) {
-      cbp_predictors.at(proc_id).UpdatePredictor(
+      predictor(proc_id).UpdatePredictor(
         op->inst_info->addr, optype, op->oracle_info.dir, op->oracle_info.pred,
         op->oracle_info.target);
     } else {
-      cbp_predictors.at(proc_id).TrackOtherInst(op->inst_info->addr, optype,
-                                                op->oracle_info.dir,
-                                                op->oracle_info.target);
+      predictor(proc_id).TrackOtherInst(op->inst_info->addr, optype,
+                                        op->oracle_info.dir,
+                                        op->oracle_info.target);
     }
   }
 
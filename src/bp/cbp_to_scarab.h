@@ -73,6 +73,19 @@ extern "C" {
 
 #ifdef __cplusplus
 }
+
+/* A predictor whose tables can serve every core (e.g. when all cores run the
+ * same binary) specializes this to return its own param. */
+template <typename CBP_CLASS>
+inline bool cbp_shared_across_cores() {
+  return false;
+}
+
+/* Called for every core but the first when cbp_shared_across_cores<>() is
+ * set: pred drops its own prediction tables and uses those of owner. Only
+ * the tables may be shared; histories and speculative state stay per core. */
+template <typename CBP_CLASS>
+inline void cbp_share_tables(CBP_CLASS& pred, CBP_CLASS& owner) {}
 #endif
 
 /*************CPB 2016 UTILS**********************/
@@ -30,13 +30,15 @@ extern "C" {
 #include "statistics.h"
 }
 
+#include "bp/template_lib/utils.h"
+
 #define PHT_INIT_VALUE (0x1 << (PHT_CTR_BITS - 1)) /* weakly taken */
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_BP_DIR, ##args)
 
 namespace {
 
 struct Gshare_State {
-  std::vector<uns8> pht;
+  Packed_Counter_Table pht;
 };
 
 std::vector<Gshare_State> gshare_state_all_cores;
@@ -59,7 +61,7 @@ void bp_gshare_retire(Op* op) {}
 void bp_gshare_init() {
   gshare_state_all_cores.resize(NUM_CORES);
   for(auto& gshare_state : gshare_state_all_cores) {
-    gshare_state.pht.resize(1 << HIST_LENGTH, PHT_INIT_VALUE);
+    gshare_state.pht.init(1 << HIST_LENGTH, 1, PHT_CTR_BITS, PHT_INIT_VALUE);
   }
 }
 
@@ -70,7 +72,7 @@ uns8 bp_gshare_pred(Op* op) {
   const Addr  addr      = op->oracle_info.pred_addr;
   const uns32 hist      = op->oracle_info.pred_global_hist;
   const uns32 pht_index = get_pht_index(addr, hist);
-  const uns8  pht_entry = gshare_state.pht[pht_index];
+  const uns8  pht_entry = gshare_state.pht.get(pht_index, 0);
   const uns8  pred      = pht_entry >> (PHT_CTR_BITS - 1) & 0x1;
 
   DEBUG(proc_id, "Predicting with gshare for  op_num:%s  index:%d\n",
@@ -92,17 +94,12 @@ void bp_gshare_update(Op* op) {
   const Addr  addr         = op->oracle_info.pred_addr;
   const uns32 hist         = op->oracle_info.pred_global_hist;
   const uns32 pht_index    = get_pht_index(addr, hist);
-  const uns8  pht_entry    = gshare_state.pht[pht_index];
 
   DEBUG(proc_id, "Writing gshare PHT for  op_num:%s  index:%d  dir:%d\n",
         unsstr64(op->op_num), pht_index, op->oracle_info.dir);
 
-  if(op->oracle_info.dir) {
-    gshare_state.pht[pht_index] = SAT_INC(pht_entry, N_BIT_MASK(PHT_CTR_BITS));
-  } else {
-    gshare_state.pht[pht_index] = SAT_DEC(pht_entry, 0);
-  }
+  gshare_state.pht.update(pht_index, 0, op->oracle_info.dir);
 
   DEBUG(proc_id, "Updating addr:%s  pht:%u  ent:%u  dir:%d\n", hexstr64s(addr),
-        pht_index, gshare_state.pht[pht_index], op->oracle_info.dir);
+        pht_index, gshare_state.pht.get(pht_index, 0), op->oracle_info.dir);
 }
@@ -0,0 +1,236 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bp/harness/bp_harness.cc
+ * Author       : HPS Research Group
+ * Date         :
+ * Description  : Standalone branch predictor harness. Replays a branch stream
+ *                (see branch_stream.h) through the Bp interface of the
+ *                predictor selected by --bp_mech and reports MPKI and the
+ *                host throughput of the predictor.
+ *
+ *                Branches are fetched one per cycle and resolved, updated and
+ *                retired BP_HARNESS_RESOLVE_LATENCY cycles later. Fetch stalls
+ *                behind a mispredicted branch until it resolves, at which
+ *                point the predictor is recovered like bp_recover_op() does.
+ *                The stream has no wrong-path branches, so nothing younger is
+ *                ever flushed.
+ *
+ *                Usage: bp_harness --bp_harness_stream <stream> [scarab params]
+ ***************************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+
+#include "bp/bp.h"
+#include "bp/bp.param.h"
+#include "core.param.h"
+#include "param_parser.h"
+#include "statistics.h"
+}
+
+#include "bp/harness/branch_stream.h"
+
+namespace {
+
+// An in-flight branch.
+struct Harness_Slot {
+  Op         op;
+  Inst_Info  inst_info;
+  Table_Info table_info;
+  Counter    fetch_cycle;
+  bool       mispredicted;
+};
+
+struct Harness_Results {
+  uint64_t num_branches             = 0;
+  uint64_t num_conditional_branches = 0;
+  uint64_t num_instructions         = 0;
+  uint64_t num_mispredictions       = 0;
+  double   seconds                  = 0;
+};
+
+class Bp_Harness {
+ public:
+  Bp_Harness(Bp* bp, uns window_size) :
+      bp_(bp), slots_(window_size), global_hist_(0), op_num_(0) {}
+
+  Harness_Results run(const std::vector<Branch_Record>& stream);
+
+ private:
+  void fetch(const Branch_Record& record, Harness_Slot* slot);
+  void resolve(Harness_Slot* slot);
+
+  Bp*                       bp_;
+  std::vector<Harness_Slot> slots_;
+  uns32                     global_hist_;  // as maintained by bp.c
+  Counter                   op_num_;
+  Harness_Results           results_;
+};
+
+Harness_Results Bp_Harness::run(const std::vector<Branch_Record>& stream) {
+  const size_t window_size = slots_.size();
+  size_t       next_record = 0;
+  size_t       head        = 0;  // oldest in-flight branch
+  size_t       num_inflight = 0;
+  bool         fetch_stalled = false;
+
+  const auto start_time = std::chrono::steady_clock::now();
+  while(next_record < stream.size() || num_inflight > 0) {
+    cycle_count++;
+
+    while(num_inflight > 0 && cycle_count - slots_[head].fetch_cycle >=
+                                BP_HARNESS_RESOLVE_LATENCY) {
+      if(slots_[head].mispredicted) {
+        fetch_stalled = false;
+      }
+      resolve(&slots_[head]);
+      head = (head + 1) % window_size;
+      num_inflight--;
+    }
+
+    if(!fetch_stalled && next_record < stream.size() &&
+       num_inflight < window_size) {
+      Harness_Slot* slot = &slots_[(head + num_inflight) % window_size];
+      fetch(stream[next_record++], slot);
+      num_inflight++;
+      fetch_stalled = slot->mispredicted;
+    }
+  }
+  results_.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start_time)
+                       .count();
+  return results_;
+}
+
+// Mirrors the direction predictor calls of bp_predict_op().
+void Bp_Harness::fetch(const Branch_Record& record, Harness_Slot* slot) {
+  memset(slot, 0, sizeof(*slot));
+  Op* op          = &slot->op;
+  op->proc_id     = 0;
+  op->op_num      = ++op_num_;
+  op->off_path    = FALSE;
+  op->table_info  = &slot->table_info;
+  op->inst_info   = &slot->inst_info;
+  op->fetch_cycle = cycle_count;
+  op->bp_cycle    = cycle_count;
+  slot->inst_info.addr       = record.pc;
+  slot->inst_info.table_info = &slot->table_info;
+  slot->table_info.cf_type   = record.cf_type;
+  slot->fetch_cycle          = cycle_count;
+
+  op->oracle_info.dir       = record.taken;
+  op->oracle_info.target    = record.target;
+  op->oracle_info.pred_addr = record.pc;
+
+  op->recovery_info.proc_id          = op->proc_id;
+  op->recovery_info.pred_global_hist = global_hist_;
+  op->recovery_info.new_dir          = record.taken;
+  op->recovery_info.op_num           = op->op_num;
+  op->recovery_info.PC               = record.pc;
+  op->recovery_info.cf_type          = record.cf_type;
+  op->recovery_info.oracle_dir       = record.taken;
+  op->recovery_info.branchTarget     = record.target;
+
+  bp_->timestamp_func(op);
+  if(record.cf_type == CF_CBR) {
+    op->oracle_info.pred_global_hist = global_hist_;
+    op->oracle_info.pred             = bp_->pred_func(op);
+    global_hist_ = (global_hist_ >> 1) | (op->oracle_info.pred << 31);
+  } else {
+    op->oracle_info.pred = TAKEN;
+  }
+  bp_->spec_update_func(op);
+
+  slot->mispredicted      = op->oracle_info.pred != op->oracle_info.dir;
+  op->oracle_info.mispred = slot->mispredicted;
+
+  results_.num_branches++;
+  results_.num_conditional_branches += record.cf_type == CF_CBR;
+  results_.num_instructions += record.num_insts;
+  results_.num_mispredictions += slot->mispredicted;
+}
+
+// Mirrors bp_resolve_op(), bp_recover_op() and bp_retire_op().
+void Bp_Harness::resolve(Harness_Slot* slot) {
+  Op* op         = &slot->op;
+  op->exec_cycle = cycle_count;
+  bp_->update_func(op);
+  if(slot->mispredicted) {
+    global_hist_ = (op->recovery_info.pred_global_hist >> 1) |
+                   (op->recovery_info.new_dir << 31);
+    bp_->recover_func(&op->recovery_info);
+  }
+  bp_->retire_func(op);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  mystdout = stdout;
+  mystderr = stderr;
+  mystatus = NULL;
+
+  get_params(argc, argv);
+  ASSERTM(0, BP_HARNESS_STREAM, "Specify a stream with --bp_harness_stream\n");
+  ASSERTM(0, NUM_CORES == 1, "The harness models a single core\n");
+  ASSERTM(0, BP_HARNESS_RESOLVE_LATENCY > DECODE_CYCLES,
+          "bp_harness_resolve_latency must be larger than decode_cycles\n");
+
+  std::vector<Branch_Record> stream;
+  if(!read_branch_stream(BP_HARNESS_STREAM, &stream)) {
+    return 1;
+  }
+
+  init_global_stats_array();
+  init_global_stats(0);
+
+  Bp* bp = &bp_table[BP_MECH];
+  bp->init_func();
+  Bp_Harness            harness(bp, NODE_TABLE_SIZE);
+  const Harness_Results results = harness.run(stream);
+
+  printf("bp_harness: %s on %s\n", bp->name, BP_HARNESS_STREAM);
+  printf("  branches          %llu (%llu conditional)\n",
+         (unsigned long long)results.num_branches,
+         (unsigned long long)results.num_conditional_branches);
+  printf("  instructions      %llu\n",
+         (unsigned long long)results.num_instructions);
+  printf("  mispredictions    %llu\n",
+         (unsigned long long)results.num_mispredictions);
+  printf("  MPKI              %.4f\n",
+         results.num_instructions ?
+           1000.0 * results.num_mispredictions / results.num_instructions :
+           0.0);
+  printf("  host time         %.3f s\n", results.seconds);
+  printf("  throughput        %.0f branches/s\n",
+         results.seconds > 0 ? results.num_branches / results.seconds : 0.0);
+  return 0;
+}
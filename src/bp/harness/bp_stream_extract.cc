@@ -0,0 +1,102 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bp/harness/bp_stream_extract.cc
+ * Author       : HPS Research Group
+ * Date         :
+ * Description  : Extracts the branch stream of a pin trace for the standalone
+ *                branch predictor harness.
+ *
+ *                Usage: bp_stream_extract <trace.bz2> <stream[.bz2]> [max_branches]
+ ***************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "bp/harness/branch_stream.h"
+#include "ctype_pin_inst.h"
+#include "frontend/pin_trace_read.h"
+
+int main(int argc, char* argv[]) {
+  if(argc < 3 || argc > 4) {
+    fprintf(stderr,
+            "Usage: %s <pin trace> <branch stream> [max branches]\n"
+            "Writes one line per dynamic branch of the trace. The stream is\n"
+            "compressed if its name ends in .bz2 or .gz.\n",
+            argv[0]);
+    return 1;
+  }
+  const char*   trace_name   = argv[1];
+  const char*   stream_name  = argv[2];
+  unsigned long max_branches = argc == 4 ? strtoul(argv[3], NULL, 0) : 0;
+
+  pin_trace_file_pointer_init(1);
+  pin_trace_open(0, trace_name);
+  FILE* stream = open_branch_stream_for_writing(stream_name);
+  if(!stream) {
+    fprintf(stderr, "Cannot open branch stream: %s\n", stream_name);
+    return 1;
+  }
+  fprintf(stream, "# branch stream of %s\n", trace_name);
+
+  ctype_pin_inst inst;
+  unsigned long  num_branches = 0;
+  unsigned long  num_insts    = 0;
+  uint32_t       insts_since_last_branch = 0;
+  while(pin_trace_read(0, &inst)) {
+    if(inst.fake_inst || inst.is_sentinel) {
+      continue;
+    }
+    if(inst.cf_type >= NUM_CF_TYPES) {
+      fprintf(stderr,
+              "Invalid cf_type %d at instruction %lu, the trace does not match "
+              "the current ctype_pin_inst layout\n",
+              inst.cf_type, num_insts);
+      close_branch_stream(stream, stream_name);
+      return 1;
+    }
+    num_insts++;
+    insts_since_last_branch++;
+    if(inst.cf_type != NOT_CF) {
+      Branch_Record record;
+      record.pc        = inst.instruction_addr;
+      record.target    = inst.branch_target;
+      record.cf_type   = (Cf_Type)inst.cf_type;
+      record.taken     = inst.actually_taken;
+      record.num_insts = insts_since_last_branch;
+      write_branch_record(stream, record);
+      insts_since_last_branch = 0;
+      if(++num_branches == max_branches) {
+        break;
+      }
+    }
+    if(inst.exit) {
+      break;
+    }
+  }
+
+  close_branch_stream(stream, stream_name);
+  pin_trace_close(0);
+  printf("Extracted %lu branches from %lu instructions\n", num_branches,
+         num_insts);
+  return 0;
+}
@@ -0,0 +1,134 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bp/harness/branch_stream.cc
+ * Author       : HPS Research Group
+ * Date         :
+ * Description  : Reading and writing branch streams (see branch_stream.h).
+ ***************************************************************************************/
+
+#include "bp/harness/branch_stream.h"
+
+#include <cinttypes>
+#include <cstring>
+#include <string>
+
+namespace {
+
+const char* const cf_type_stream_names[NUM_CF_TYPES] = {
+  "NOT_CF", "CF_BR",  "CF_CBR", "CF_CALL", "CF_IBR",
+  "CF_ICALL", "CF_ICO", "CF_RET", "CF_SYS"};
+
+bool has_suffix(const std::string& name, const std::string& suffix) {
+  return name.size() >= suffix.size() &&
+         name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Compressed streams go through bzip2/gzip the same way pin traces do.
+const char* get_compressor(const std::string& name) {
+  if(has_suffix(name, ".bz2")) {
+    return "bzip2";
+  } else if(has_suffix(name, ".gz")) {
+    return "gzip";
+  }
+  return NULL;
+}
+
+bool parse_cf_type(const char* name, Cf_Type* cf_type) {
+  for(int i = CF_BR; i < NUM_CF_TYPES; ++i) {
+    if(strcmp(name, cf_type_stream_names[i]) == 0) {
+      *cf_type = (Cf_Type)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+bool read_branch_stream(const char*                 file_name,
+                        std::vector<Branch_Record>* records) {
+  const char* compressor = get_compressor(file_name);
+  FILE*       file;
+  if(compressor) {
+    std::string cmdline = std::string(compressor) + " -dc " + file_name;
+    file                = popen(cmdline.c_str(), "r");
+  } else {
+    file = fopen(file_name, "r");
+  }
+  if(!file) {
+    fprintf(stderr, "Cannot open branch stream: %s\n", file_name);
+    return false;
+  }
+
+  char line[256];
+  char cf_type_name[16];
+  int  line_num = 0;
+  bool ok       = true;
+  while(fgets(line, sizeof(line), file)) {
+    line_num++;
+    if(line[0] == '#' || line[0] == '\n') {
+      continue;
+    }
+    Branch_Record record;
+    unsigned      taken;
+    if(sscanf(line, "%" SCNx64 " %" SCNx64 " %15s %u %" SCNu32, &record.pc,
+              &record.target, cf_type_name, &taken, &record.num_insts) != 5 ||
+       !parse_cf_type(cf_type_name, &record.cf_type) || taken > 1) {
+      fprintf(stderr, "%s:%d: malformed branch record\n", file_name, line_num);
+      ok = false;
+      break;
+    }
+    record.taken = taken;
+    records->push_back(record);
+  }
+
+  if(compressor) {
+    pclose(file);
+  } else {
+    fclose(file);
+  }
+  return ok;
+}
+
+FILE* open_branch_stream_for_writing(const char* file_name) {
+  const char* compressor = get_compressor(file_name);
+  if(compressor) {
+    std::string cmdline = std::string(compressor) + " -c > " + file_name;
+    return popen(cmdline.c_str(), "w");
+  }
+  return fopen(file_name, "w");
+}
+
+void write_branch_record(FILE* stream, const Branch_Record& record) {
+  fprintf(stream, "%" PRIx64 " %" PRIx64 " %s %d %" PRIu32 "\n", record.pc,
+          record.target, cf_type_stream_names[record.cf_type], record.taken,
+          record.num_insts);
+}
+
+void close_branch_stream(FILE* stream, const char* file_name) {
+  if(get_compressor(file_name)) {
+    pclose(stream);
+  } else {
+    fclose(stream);
+  }
+}
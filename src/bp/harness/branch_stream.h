@@ -0,0 +1,68 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bp/harness/branch_stream.h
+ * Author       : HPS Research Group
+ * Date         :
+ * Description  : Branch streams replayed by the standalone branch predictor
+ *                harness. A stream is a text file (optionally bzip2 or gzip
+ *                compressed) with one dynamic branch per line:
+ *
+ *                  <pc> <target> <cf_type> <taken> <num_insts>
+ *
+ *                pc and target are hex, cf_type is a Cf_Type name (e.g.
+ *                CF_CBR), taken is 0 or 1 and num_insts is the number of
+ *                instructions since the previous branch, including this one.
+ *                Lines starting with '#' are comments.
+ ***************************************************************************************/
+
+#ifndef __BRANCH_STREAM_H__
+#define __BRANCH_STREAM_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+extern "C" {
+#include "table_info.h"
+}
+
+struct Branch_Record {
+  uint64_t pc;
+  uint64_t target;  // taken target
+  Cf_Type  cf_type;
+  bool     taken;
+  uint32_t num_insts;  // instructions since the previous branch (inclusive)
+};
+
+// Reads a whole branch stream into records. Returns false (after printing an
+// error) if the file cannot be opened or is malformed.
+bool read_branch_stream(const char* file_name,
+                        std::vector<Branch_Record>* records);
+
+// Opens a branch stream for writing, compressing it if the name ends in .bz2
+// or .gz. Returns NULL on failure. close_branch_stream() needs the same name.
+FILE* open_branch_stream_for_writing(const char* file_name);
+void  write_branch_record(FILE* stream, const Branch_Record& record);
+void  close_branch_stream(FILE* stream, const char* file_name);
+
+#endif
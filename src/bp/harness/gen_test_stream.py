@@ -0,0 +1,108 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""
+Author: HPS Research Group
+Date: 10/18/2026
+Description: Generates test_stream.bps.bz2, the branch stream bp_bench replays.
+  The stream is a deterministic walk of a small synthetic program with
+  counted loops, branches correlated with earlier outcomes, data-dependent
+  (biased random) branches, calls/returns and an indirect dispatch, so that
+  it exercises the history based predictors without needing a trace.
+"""
+
+import argparse
+import bz2
+import random
+
+class Stream_Writer:
+  def __init__(self, out, limit):
+    self.out = out
+    self.limit = limit
+    self.count = 0
+    self.insts = 0
+
+  def full(self):
+    return self.count >= self.limit
+
+  def emit(self, pc, target, cf_type, taken, insts):
+    if self.full():
+      return
+    self.out.write("{:x} {:x} {} {} {}\n".format(pc, target, cf_type,
+                                                int(taken), insts).encode())
+    self.count += 1
+
+def run_program(w, rng):
+  base = 0x400000
+  history = []
+
+  def cbr(pc, taken, insts):
+    w.emit(pc, pc + 0x40, "CF_CBR", taken, insts)
+    history.append(taken)
+
+  def call(pc, func):
+    w.emit(pc, func, "CF_CALL", True, 3)
+
+  def ret(pc, to):
+    w.emit(pc, to, "CF_RET", True, 2)
+
+  iteration = 0
+  while not w.full():
+    iteration += 1
+    # outer loop over "records", trip count varies in a short pattern
+    trip = (8, 8, 12, 8, 16)[iteration % 5]
+    for i in range(trip):
+      # inner counted loop
+      for j in range(4):
+        cbr(base + 0x100, j != 3, 5)
+      # correlated with the inner loop exit and the outer index
+      cbr(base + 0x140, (i & 1) == 0, 3)
+      cbr(base + 0x180, history[-1] and (i % 3 != 0), 4)
+      # data dependent, strongly biased
+      cbr(base + 0x1c0, rng.random() < 0.9, 6)
+      # helper call with an early-out branch inside
+      call(base + 0x200, base + 0x1000)
+      cbr(base + 0x1010, rng.random() < 0.25, 7)
+      ret(base + 0x1040, base + 0x205)
+      # switch-like indirect dispatch on a slowly changing value
+      case = (iteration // 3 + i) % 4
+      w.emit(base + 0x240, base + 0x2000 + case * 0x40, "CF_IBR", True, 4)
+      w.emit(base + 0x2010 + case * 0x40, base + 0x280, "CF_BR", True, 2)
+      # outer loop back edge
+      cbr(base + 0x2c0, i != trip - 1, 2)
+    # periodic branch with a long period
+    cbr(base + 0x300, iteration % 7 == 0, 9)
+    if len(history) > 64:
+      del history[:-64]
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument("--branches", type=int, default=50000)
+  parser.add_argument("--seed", type=int, default=1)
+  parser.add_argument("--output", default="test_stream.bps.bz2")
+  args = parser.parse_args()
+
+  rng = random.Random(args.seed)
+  with bz2.open(args.output, "wb") as out:
+    out.write(b"# synthetic branch stream generated by gen_test_stream.py\n")
+    run_program(Stream_Writer(out, args.branches), rng)
+
+if __name__ == "__main__":
+  main()
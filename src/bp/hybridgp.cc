@@ -46,13 +46,20 @@ struct Hybridgp_In_Flight_State {
 };
 
 struct Hybridgp_State {
-  Cache              bht;
-  Hash_Table         bht_hash;
-  std::vector<uns8>  hybspht;
-  std::vector<uns8>  hybgpht;
-  std::vector<uns8>  hybppht;
-  Hash_Table         hybgpht_hash;
-  std::vector<uns32> filter;
+  Cache                bht;
+  Hash_Table           bht_hash;
+  Packed_Counter_Table hybspht;
+  Packed_Counter_Table hybgpht;
+  Packed_Counter_Table hybppht;
+  Hash_Table           hybgpht_hash;
+  std::vector<uns32>   filter;
+
+  // When the selector and the global table are indexed alike, the global
+  // counters are kept next to the selector ones (way 1 of hybspht), so that
+  // a branch reads both from the same host cache line.
+  bool sgpht_shared;
+  Packed_Counter_Table& gpht() { return sgpht_shared ? hybspht : hybgpht; }
+  unsigned gpht_way() const { return sgpht_shared ? 1 : 0; }
 
   // Used for update and recovery (checkpointing).
   Circular_Buffer<Hybridgp_In_Flight_State> in_flight;
@@ -227,7 +234,7 @@ void update_loop_filter(Op* op, Hybridgp_State& hybridgp_state,
 }
 
 bool get_spred(const Hybridgp_State& hybridgp_state, const uns32 spht_index) {
-  const auto spht_entry = hybridgp_state.hybspht[spht_index];
+  const auto spht_entry = hybridgp_state.hybspht.get(spht_index, 0);
   return spht_entry >> (PHT_CTR_BITS - 1);
 }
 
@@ -245,43 +252,49 @@ bool get_gpred(Op* op, Hybridgp_State& hybridgp_state, const Addr addr,
     gpht_entry                      = *entry;
     op->oracle_info.pred_gpht_entry = entry;  // need for update
   } else {
-    gpht_entry = hybridgp_state.hybgpht[gpht_index];
+    gpht_entry = hybridgp_state.gpht().get(gpht_index,
+                                           hybridgp_state.gpht_way());
   }
   return gpht_entry >> (PHT_CTR_BITS - 1);
 }
 
 bool get_ppred(const Hybridgp_State& hybridgp_state, const uns32 ppht_index) {
-  const auto ppht_entry = hybridgp_state.hybppht[ppht_index];
+  const auto ppht_entry = hybridgp_state.hybppht.get(ppht_index, 0);
   return ppht_entry >> (PHT_CTR_BITS - 1);
 }
 
 void update_all_phts(const Op* op, Hybridgp_State& hybridgp_state,
                      const Hybridgp_Indices& indices) {
-  uns8* gpht_entry = INF_HYBRIDGP ? op->oracle_info.pred_gpht_entry :
-                                    &hybridgp_state.hybgpht[indices.gpht];
-  uns8* spht_entry = &hybridgp_state.hybspht[indices.spht];
-  uns8* ppht_entry = &hybridgp_state.hybppht[indices.ppht];
-
-  const uns8 gpred = USE_FILTER ? (*gpht_entry >> (PHT_CTR_BITS - 1)) :
+  uns8* inf_gpht_entry = INF_HYBRIDGP ? op->oracle_info.pred_gpht_entry :
+                                        NULL;
+  const uns8 gpht_entry = INF_HYBRIDGP ?
+                            *inf_gpht_entry :
+                            hybridgp_state.gpht().get(indices.gpht,
+                                                      hybridgp_state.gpht_way());
+  const uns8 ppht_entry = hybridgp_state.hybppht.get(indices.ppht, 0);
+
+  const uns8 gpred = USE_FILTER ? (gpht_entry >> (PHT_CTR_BITS - 1)) :
                                   op->oracle_info.hybridgp_gpred;
-  const uns8 ppred = *ppht_entry >> (PHT_CTR_BITS - 1);
+  const uns8 ppred = ppht_entry >> (PHT_CTR_BITS - 1);
 
   DEBUG(op->proc_id, "Writing hybridgp PHT for op_num:%s\n",
         unsstr64(op->op_num));
 
 
-  if(op->oracle_info.dir) {
-    *gpht_entry = SAT_INC(*gpht_entry, N_BIT_MASK(PHT_CTR_BITS));
-    *ppht_entry = SAT_INC(*ppht_entry, N_BIT_MASK(PHT_CTR_BITS));
+  if(INF_HYBRIDGP) {
+    *inf_gpht_entry = op->oracle_info.dir ?
+                        SAT_INC(gpht_entry, N_BIT_MASK(PHT_CTR_BITS)) :
+                        SAT_DEC(gpht_entry, 0);
   } else {
-    *gpht_entry = SAT_DEC(*gpht_entry, 0);
-    *ppht_entry = SAT_DEC(*ppht_entry, 0);
+    hybridgp_state.gpht().update(indices.gpht, hybridgp_state.gpht_way(),
+                                 op->oracle_info.dir);
   }
+  hybridgp_state.hybppht.update(indices.ppht, 0, op->oracle_info.dir);
 
   if((gpred == op->oracle_info.dir) && (ppred != op->oracle_info.dir)) {
-    *spht_entry = SAT_INC(*spht_entry, N_BIT_MASK(PHT_CTR_BITS));
+    hybridgp_state.hybspht.update(indices.spht, 0, true);
   } else if((gpred != op->oracle_info.dir) && (ppred == op->oracle_info.dir)) {
-    *spht_entry = SAT_DEC(*spht_entry, 0);
+    hybridgp_state.hybspht.update(indices.spht, 0, false);
   }
 }
 
@@ -292,8 +305,13 @@ void bp_hybridgp_init() {
     hybridgp_state_all_cores.emplace_back(NODE_TABLE_SIZE);
   }
   for(auto& hybridgp_state : hybridgp_state_all_cores) {
-    hybridgp_state.hybspht.resize(1 << HYBRIDS_INDEX_LENGTH, PHT_INIT_VALUE);
-    hybridgp_state.hybppht.resize(1 << HYBRIDP_HIST_LENGTH, PHT_INIT_VALUE);
+    hybridgp_state.sgpht_shared = !INF_HYBRIDGP &&
+                                  HYBRIDS_INDEX_LENGTH == HYBRIDG_HIST_LENGTH;
+    hybridgp_state.hybspht.init(1 << HYBRIDS_INDEX_LENGTH,
+                                hybridgp_state.sgpht_shared ? 2 : 1,
+                                PHT_CTR_BITS, PHT_INIT_VALUE);
+    hybridgp_state.hybppht.init(1 << HYBRIDP_HIST_LENGTH, 1, PHT_CTR_BITS,
+                                PHT_INIT_VALUE);
     if(INF_HYBRIDGP) {
       // only the gpht and the bht are interference free
       init_hash_table(&hybridgp_state.bht_hash, "", 1 << 16, sizeof(uns32));
@@ -302,7 +320,9 @@ void bp_hybridgp_init() {
       // line size for table set to 1
       init_cache(&hybridgp_state.bht, "BHT", BHT_ENTRIES, BHT_ASSOC, 1,
                  sizeof(Addr), REPL_TRUE_LRU);
-      hybridgp_state.hybgpht.resize(1 << HYBRIDG_HIST_LENGTH, PHT_INIT_VALUE);
+      if(!hybridgp_state.sgpht_shared)
+        hybridgp_state.hybgpht.init(1 << HYBRIDG_HIST_LENGTH, 1, PHT_CTR_BITS,
+                                    PHT_INIT_VALUE);
     }
 
     hybridgp_state.filter.resize(1 << FILTER_INDEX_LENGTH, 0);
@@ -525,8 +525,21 @@ int8_t& coltentry::ctr(bool predtaken[NPRED]) {
 }
 
 
+colt::colt() {
+  c       = NULL;
+  logsize = 0;
+}
+
+
+void colt::init(int log) {
+  // entries start at nonzero counters, so COLT cannot be left sparse
+  logsize = log;
+  c       = new coltentry[1 << logsize];
+}
+
+
 int8_t& colt::ctr(uint64_t pc, bool predtaken[NPRED]) {
-  int i = pc & ((1 << LOGCOLT) - 1);
+  int i = pc & ((1 << logsize) - 1);
   return c[i].ctr(predtaken);
 }
 
@@ -542,15 +555,20 @@ void colt::update(uint64_t pc, bool predtaken[NPRED], bool taken) {
 
 
 bftable::bftable() {
-  for(int i = 0; i < BFTSIZE; i++) {
-    freq[i] = 0;
-  }
+  freq = NULL;
+  size = 0;
+}
+
+
+void bftable::init(int log) {
+  size = 1 << log;
+  freq = (int*)calloc(size, sizeof(int));
 }
 
 
 int& bftable::getfreq(uint64_t pc) {
-  int i = pc % BFTSIZE;
-  MTAGE_ASSERT((i >= 0) && (i < BFTSIZE));
+  int i = pc & (size - 1);
+  MTAGE_ASSERT((i >= 0) && (i < size));
   return freq[i];
 }
 
@@ -698,13 +716,12 @@ void tage::init(const char* nm, int ng, int logb, int logg, int tagb, int ctrb,
   ctrbits   = ctrb;
   postpbits = ppb;
   postpsize = 1 << (2 * ctrbits + 1);
-  b         = new int8_t[bsize];
-  for(int i = 0; i < bsize; i++) {
-    b[i] = 0;
-  }
+  // the bimodal and tagged tables start all-zero (see gentry()), so calloc
+  // them and let the host map only the pages the trace actually touches
+  b = (int8_t*)calloc(bsize, sizeof(int8_t));
   g = new gentry*[numg];
   for(int i = 0; i < numg; i++) {
-    g[i] = new gentry[gsize];
+    g[i] = (gentry*)calloc(gsize, sizeof(gentry));
   }
   gi    = new int[numg];
   postp = new int8_t[postpsize];
@@ -924,6 +941,20 @@ void tage::printconfig(subpath& p) {
 }
 
 
+void tage::share_tables(tage& owner) {
+  // only the bimodal and tagged tables are shared; the indices, hits and
+  // post-predictor of the last prediction stay with this instance
+  MTAGE_ASSERT(bsize == owner.bsize && gsize == owner.gsize &&
+               numg == owner.numg);
+  free(b);
+  b = owner.b;
+  for(int i = 0; i < numg; i++) {
+    free(g[i]);
+    g[i] = owner.g[i];
+  }
+}
+
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 
@@ -947,37 +978,161 @@ void folded_history::update(uint8_t* h, int PT) {
 /////////////////////////////////////////////////////////////
 
 
+static const int mtage_numg[NPRED] = {P0_NUMG, P1_NUMG, P2_NUMG,
+                                      P3_NUMG, P4_NUMG, P5_NUMG};
+
+
+static uint64_t mtage_bimodal_bytes(int logb) {
+  return (uint64_t)sizeof(int8_t) << logb;
+}
+
+
+static uint64_t mtage_tagged_bytes(int i, int logg) {
+  return ((uint64_t)mtage_numg[i] * sizeof(gentry)) << logg;
+}
+
+
+static uint64_t mtage_colt_bytes(int logcolt) {
+  return (uint64_t)sizeof(coltentry) << logcolt;
+}
+
+
+static uint64_t mtage_bft_bytes(int logbft) {
+  return (uint64_t)sizeof(int) << logbft;
+}
+
+
+static uint64_t mtage_table_bytes(int logb[NPRED], int logg[NPRED],
+                                  int logcolt, int logbft) {
+  uint64_t bytes = mtage_colt_bytes(logcolt) + mtage_bft_bytes(logbft);
+  for(int i = 0; i < NPRED; i++) {
+    bytes += mtage_bimodal_bytes(logb[i]) + mtage_tagged_bytes(i, logg[i]);
+  }
+  return bytes;
+}
+
+
+// Shrinks a component of 'bytes' bytes at 2^log entries to its share
+// (scale) of the budget. Returns the new log2 size.
+static int mtage_budget_log(int log, uint64_t bytes, double scale) {
+  uint64_t share = (uint64_t)(bytes * scale);
+  while(log > MTAGE_MIN_LOG && bytes > share) {
+    log--;
+    bytes >>= 1;
+  }
+  return log;
+}
+
+
 MTAGE::MTAGE(void) {
-  sp[0].init(P0_SPSIZE, P0_NUMG, P0_MINHIST, P0_MAXHIST, P0_LOGG, TAGBITS,
+  int logb[NPRED] = {P0_LOGB, P1_LOGB, P2_LOGB, P3_LOGB, P4_LOGB, P5_LOGB};
+  int logg[NPRED] = {P0_LOGG, P1_LOGG, P2_LOGG, P3_LOGG, P4_LOGG, P5_LOGG};
+  int logcolt     = LOGCOLT;
+  int logbft      = LOGBFT;
+
+  // MTAGE_BUDGET_MB bounds the tables one instance owns; each component
+  // gets a share of it proportional to its CBP size
+  uint64_t full   = mtage_table_bytes(logb, logg, logcolt, logbft);
+  uint64_t budget = (uint64_t)MTAGE_BUDGET_MB << 20;
+  if(budget && full > budget) {
+    double scale = (double)budget / full;
+    for(int i = 0; i < NPRED; i++) {
+      logb[i] = mtage_budget_log(logb[i], mtage_bimodal_bytes(logb[i]), scale);
+      logg[i] = mtage_budget_log(logg[i], mtage_tagged_bytes(i, logg[i]),
+                                 scale);
+    }
+    logcolt = mtage_budget_log(logcolt, mtage_colt_bytes(logcolt), scale);
+    logbft  = mtage_budget_log(logbft, mtage_bft_bytes(logbft), scale);
+  }
+
+  sp[0].init(P0_SPSIZE, P0_NUMG, P0_MINHIST, P0_MAXHIST, logg[0], TAGBITS,
              PATHBITS, P0_HASHPARAM);
-  sp[1].init(P1_SPSIZE, P1_NUMG, P1_MINHIST, P1_MAXHIST, P1_LOGG, TAGBITS,
+  sp[1].init(P1_SPSIZE, P1_NUMG, P1_MINHIST, P1_MAXHIST, logg[1], TAGBITS,
              PATHBITS, P1_HASHPARAM);
-  sp[2].init(P2_SPSIZE, P2_NUMG, P2_MINHIST, P2_MAXHIST, P2_LOGG, TAGBITS,
+  sp[2].init(P2_SPSIZE, P2_NUMG, P2_MINHIST, P2_MAXHIST, logg[2], TAGBITS,
              PATHBITS, P2_HASHPARAM);
-  sp[3].init(P3_SPSIZE, P3_NUMG, P3_MINHIST, P3_MAXHIST, P3_LOGG, TAGBITS,
+  sp[3].init(P3_SPSIZE, P3_NUMG, P3_MINHIST, P3_MAXHIST, logg[3], TAGBITS,
              PATHBITS, P3_HASHPARAM);
-  sp[4].init(P4_SPSIZE, P4_NUMG, P4_MINHIST, P4_MAXHIST, P4_LOGG, TAGBITS,
+  sp[4].init(P4_SPSIZE, P4_NUMG, P4_MINHIST, P4_MAXHIST, logg[4], TAGBITS,
              PATHBITS, P4_HASHPARAM);
-  sp[5].init(P5_SPSIZE, P5_NUMG, P5_MINHIST, P5_MAXHIST, P5_LOGG, TAGBITS,
+  sp[5].init(P5_SPSIZE, P5_NUMG, P5_MINHIST, P5_MAXHIST, logg[5], TAGBITS,
              PATHBITS, P5_HASHPARAM);
 
-  pred[0].init("G", P0_NUMG, P0_LOGB, P0_LOGG, TAGBITS, CTRBITS, POSTPBITS,
+  pred[0].init("G", P0_NUMG, logb[0], logg[0], TAGBITS, CTRBITS, POSTPBITS,
                P0_RAMPUP, CAPHIST);
-  pred[1].init("A", P1_NUMG, P1_LOGB, P1_LOGG, TAGBITS, CTRBITS, POSTPBITS,
+  pred[1].init("A", P1_NUMG, logb[1], logg[1], TAGBITS, CTRBITS, POSTPBITS,
                P1_RAMPUP, CAPHIST);
-  pred[2].init("S", P2_NUMG, P2_LOGB, P2_LOGG, TAGBITS, CTRBITS, POSTPBITS,
+  pred[2].init("S", P2_NUMG, logb[2], logg[2], TAGBITS, CTRBITS, POSTPBITS,
                P2_RAMPUP, CAPHIST);
-  pred[3].init("s", P3_NUMG, P3_LOGB, P3_LOGG, TAGBITS, CTRBITS, POSTPBITS,
+  pred[3].init("s", P3_NUMG, logb[3], logg[3], TAGBITS, CTRBITS, POSTPBITS,
                P3_RAMPUP, CAPHIST);
-  pred[4].init("F", P4_NUMG, P4_LOGB, P4_LOGG, TAGBITS, CTRBITS, POSTPBITS,
+  pred[4].init("F", P4_NUMG, logb[4], logg[4], TAGBITS, CTRBITS, POSTPBITS,
                P4_RAMPUP, CAPHIST);
 
-  pred[5].init("g", P5_NUMG, P5_LOGB, P5_LOGG, TAGBITS, CTRBITS, POSTPBITS,
+  pred[5].init("g", P5_NUMG, logb[5], logg[5], TAGBITS, CTRBITS, POSTPBITS,
                P5_RAMPUP, CAPHIST);
 
   bfreq.init(P4_SPSIZE);  // number of frequency bins = P4 spectrum size
+  bft.init(logbft);
+  co.init(logcolt);
 
   initSC();
+
+  PrintStorage(logb, logg, logcolt, logbft, budget);
+}
+
+
+void MTAGE::ShareTables(MTAGE& owner) {
+  // path histories, subpaths, COLT and the BFT are per core state
+  for(int i = 0; i < NPRED; i++) {
+    pred[i].share_tables(owner.pred[i]);
+  }
+}
+
+
+void MTAGE::PrintStorage(int logb[NPRED], int logg[NPRED], int logcolt,
+                         int logbft, uint64_t budget) {
+  // every instance is built from the same params, so report only the first
+  static bool printed = false;
+  if(printed)
+    return;
+  printed = true;
+
+  uint64_t bimodal = 0, tagged = 0, paths = 0;
+  for(int i = 0; i < NPRED; i++) {
+    bimodal += mtage_bimodal_bytes(logb[i]);
+    tagged += mtage_tagged_bytes(i, logg[i]);
+    subpath& p = sp[i].p[0];
+    paths += (uint64_t)sp[i].size *
+             (p.ph.hlength * sizeof(unsigned) +
+              4 * p.numg * sizeof(compressed_history));
+  }
+  uint64_t colt_bytes = mtage_colt_bytes(logcolt);
+  uint64_t bft_bytes  = mtage_bft_bytes(logbft);
+  uint64_t tables     = bimodal + tagged;
+  uint64_t per_core   = colt_bytes + bft_bytes + paths;
+  uint64_t total      = (MTAGE_SHARED ? tables : NUM_CORES * tables) +
+                        NUM_CORES * per_core;
+  double   mb         = 1024.0 * 1024.0;
+
+  fprintf(mystdout,
+          "mtage: tagged %.1f MB, bimodal %.1f MB (%s), colt %.1f MB, "
+          "bft %.1f MB, paths %.1f MB (per core), total for %u cores "
+          "%.1f MB\n",
+          tagged / mb, bimodal / mb,
+          MTAGE_SHARED ? "shared by all cores" : "per core", colt_bytes / mb,
+          bft_bytes / mb, paths / mb, NUM_CORES, total / mb);
+  fprintf(mystdout,
+          "mtage: tagged, bimodal and bft tables are mapped on first touch; "
+          "SC tables are static and already shared by all cores\n");
+
+  // MTAGE_MIN_LOG stops the budget from shrinking a table any further
+  uint64_t budgeted = mtage_table_bytes(logb, logg, logcolt, logbft);
+  if(budget && budgeted > budget)
+    fprintf(mystderr,
+            "mtage: WARNING: tables need %.1f MB, over the %u MB "
+            "mtage_budget_mb, because no table shrinks below 2^%d entries\n",
+            budgeted / mb, MTAGE_BUDGET_MB, MTAGE_MIN_LOG);
 }
 
 
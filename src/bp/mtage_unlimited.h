@@ -28,6 +28,11 @@
 
 #include "cbp_to_scarab.h"
 
+extern "C" {
+#include "bp/bp.param.h"
+#include "globals/global_vars.h"
+}
+
 /*************Code From CBP 2016***************/
 
 // initial code by P.Michaud for the CBP4 poTAGE  and poTAGE +SC
@@ -131,8 +136,8 @@
 #define MAXALLOC 3
 #define CAPHIST 200
 
-// BFTSIZE = number of entries in the branch frequency table (BFT)
-#define BFTSIZE (1 << 20)
+// LOGBFT = log2 of the number of entries in the branch frequency table (BFT)
+#define LOGBFT 20
 
 // FRATIOBITS = log2 of the ratio between adjacent frequency bins (predictor P3)
 #define FRATIOBITS 1
@@ -143,6 +148,10 @@
 #define LOGCOLT 20
 #define COLTBITS 5
 
+// MTAGE_MIN_LOG = smallest log2 table size MTAGE_BUDGET_MB may shrink a
+// component to
+#define MTAGE_MIN_LOG 10
+
 
 using namespace std;
 
@@ -192,18 +201,23 @@ class colt {
   // This is COLT, a method invented by Gabriel Loh and Dana Henry
   // for combining several different predictors (see PACT 2002)
  public:
-  coltentry c[1 << LOGCOLT];
-  int8_t&   ctr(uint64_t pc, bool predtaken[NPRED]);
-  bool      predict(uint64_t pc, bool predtaken[NPRED]);
-  void      update(uint64_t pc, bool predtaken[NPRED], bool taken);
+  coltentry* c;
+  int        logsize;
+  colt();
+  void    init(int log);
+  int8_t& ctr(uint64_t pc, bool predtaken[NPRED]);
+  bool    predict(uint64_t pc, bool predtaken[NPRED]);
+  void    update(uint64_t pc, bool predtaken[NPRED], bool taken);
 };
 
 
 class bftable {
   // branch frequency table (BFT)
  public:
-  int freq[BFTSIZE];
+  int* freq;
+  int  size;
   bftable();
+  void init(int log);
   int& getfreq(uint64_t pc);
 };
 
@@ -308,6 +322,7 @@ class tage {
   void    careful_update(uint64_t pc, bool taken, subpath& p);
   bool    condbr_update(uint64_t pc, bool taken, subpath& p);
   void    printconfig(subpath& p);
+  void    share_tables(tage& owner);
 };
 
 
@@ -340,6 +355,9 @@ class MTAGE {
 
  public:
   MTAGE(void);
+  void PrintStorage(int logb[NPRED], int logg[NPRED], int logcolt, int logbft,
+                    uint64_t budget);
+  void ShareTables(MTAGE& owner);
   bool GetPrediction(uint64_t PC);
   void UpdatePredictor(uint64_t PC, OpType OPTYPE, bool resolveDir,
                        bool predDir, uint64_t branchTarget);
@@ -379,6 +397,16 @@ class MTAGE {
 };
 void PrintStat(double NumInst);
 
+template <>
+inline bool cbp_shared_across_cores<MTAGE>() {
+  return MTAGE_SHARED;
+}
+
+template <>
+inline void cbp_share_tables<MTAGE>(MTAGE& pred, MTAGE& owner) {
+  pred.ShareTables(owner);
+}
+
 
 /***********************************************************/
 #endif
@@ -28,6 +28,7 @@ extern "C" {
 #include "bp.param.h"
 #include "core.param.h"
 #include "globals/assert.h"
+#include "statistics.h"
 #include "table_info.h"
 }
 
@@ -37,6 +38,9 @@ namespace {
 // A vector of TAGE-SC-L tables. One table per core.
 std::vector<std::unique_ptr<Tage_SC_L_Base>> tagescl_predictors;
 
+// Host time already added to the stats, one per core.
+std::vector<Tage_SC_L_Host_Time> reported_host_time;
+
 // Helper function for producing a Branch_Type struct.
 Branch_Type get_branch_type(uns proc_id, Cf_Type cf_type) {
   Branch_Type br_type;
@@ -66,6 +70,21 @@ Branch_Type get_branch_type(uns proc_id, Cf_Type cf_type) {
   }
   return br_type;
 }
+
+// Adds the host time spent in the predictor since the last call to the stats.
+void report_host_time(uns proc_id) {
+  const Tage_SC_L_Host_Time& host_time =
+    tagescl_predictors.at(proc_id)->get_host_time();
+  Tage_SC_L_Host_Time& reported = reported_host_time.at(proc_id);
+  INC_STAT_EVENT(proc_id, TAGESCL_HOST_NS_TAGE,
+                 host_time.tage_ns - reported.tage_ns);
+  INC_STAT_EVENT(proc_id, TAGESCL_HOST_NS_LOOP,
+                 host_time.loop_ns - reported.loop_ns);
+  INC_STAT_EVENT(proc_id, TAGESCL_HOST_NS_SC, host_time.sc_ns - reported.sc_ns);
+  INC_STAT_EVENT(proc_id, TAGESCL_HOST_NS_RECOVERY,
+                 host_time.recovery_ns - reported.recovery_ns);
+  reported = host_time;
+}
 }  // end of anonymous namespace
 
 void bp_tagescl_init() {
@@ -79,7 +98,9 @@ void bp_tagescl_init() {
         tagescl_predictors.push_back(
           std::make_unique<Tage_SC_L<TAGE_SC_L_CONFIG_80KB>>(NODE_TABLE_SIZE));
       }
+      tagescl_predictors.back()->set_host_timing(TAGESCL_HOST_TIME_STATS);
     }
+    reported_host_time.resize(NUM_CORES);
   }
   ASSERTM(0, tagescl_predictors.size() == NUM_CORES,
           "tagescl_predictors not initialized correctly");
@@ -118,6 +139,9 @@ void bp_tagescl_retire(Op* op) {
     op->recovery_info.branch_id, op->inst_info->addr,
     get_branch_type(proc_id, op->table_info->cf_type), op->oracle_info.dir,
     op->oracle_info.target);
+  if(TAGESCL_HOST_TIME_STATS) {
+    report_host_time(proc_id);
+  }
 }
 
 void bp_tagescl_recover(Recovery_Info* recovery_info) {
@@ -126,4 +150,8 @@ void bp_tagescl_recover(Recovery_Info* recovery_info) {
     recovery_info->branch_id, recovery_info->PC,
     get_branch_type(proc_id, recovery_info->cf_type), recovery_info->new_dir,
     recovery_info->branchTarget);
+  STAT_EVENT(proc_id, TAGESCL_RECOVERIES);
+  if(TAGESCL_HOST_TIME_STATS) {
+    report_host_time(proc_id);
+  }
 }
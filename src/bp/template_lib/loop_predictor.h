@@ -38,16 +38,19 @@ struct Loop_Prediction_Info {
   // Information needed for table updates.
   Loop_Predictor_Indices indices;
   int16_t                tag;
-  Saturating_Counter<LOOP_CONFIG::ITERATION_COUNTER_WIDTH, false>
-    current_iter_checkpoint;
 };
 
 template <class LOOP_CONFIG>
 class Loop_Predictor {
  public:
-  Loop_Predictor(Random_Number_Generator& random_number_gen) :
+  // Each branch logs at most one speculative iteration update. Up to twice
+  // max_in_flight_branches can be in flight (the branch buffer is rounded up
+  // to a power of two), plus the last retired branch.
+  Loop_Predictor(Random_Number_Generator& random_number_gen,
+                 int                      max_in_flight_branches) :
       table_(1 << LOOP_CONFIG::LOG_NUM_ENTRIES),
-      random_number_gen_(random_number_gen) {}
+      random_number_gen_(random_number_gen),
+      speculative_log_(2 * max_in_flight_branches + 1) {}
 
   void get_prediction(
     uint64_t br_pc, Loop_Prediction_Info<LOOP_CONFIG>* prediction_info) const {
@@ -68,8 +71,6 @@ class Loop_Predictor {
           ((table_[index].confidence == LOOP_CONFIG::CONFIDENCE_THRESHOLD) ||
            (table_[index].confidence * table_[index].total_iterations > 128));
 
-        prediction_info->current_iter_checkpoint =
-          table_[index].speculative_current_iter.get();
         if(table_[index].speculative_current_iter.get() + 1 ==
            table_[index].total_iterations) {
           prediction_info->prediction = !table_[index].dir;
@@ -87,6 +88,9 @@ class Loop_Predictor {
     if(prediction_info.hit_bank >= 0) {
       int index = prediction_info.indices.bank[prediction_info.hit_bank];
       if(table_[index].total_iterations != 0) {
+        speculative_log_.push(
+          {index, table_[index].tag,
+           table_[index].speculative_current_iter.get()});
         table_[index].speculative_current_iter.increment();
         if(table_[index].speculative_current_iter.get() >=
            table_[index].total_iterations) {
@@ -194,17 +198,26 @@ class Loop_Predictor {
   void global_recover_speculative_state(
     const Loop_Prediction_Info<LOOP_CONFIG>& prediction_info) {}
 
-  void local_recover_speculative_state(
-    const Loop_Prediction_Info<LOOP_CONFIG>& prediction_info) {
-    if(prediction_info.hit_bank >= 0) {
-      int index = prediction_info.indices.bank[prediction_info.hit_bank];
-      if(table_[index].tag != prediction_info.tag) {
+  // Log position to pass to rewind_speculative_state() for undoing all
+  // speculative updates from now on.
+  int64_t get_speculative_log_position() const {
+    return speculative_log_.position();
+  }
+
+  // Undoes all speculative iteration updates done after log_position.
+  void rewind_speculative_state(int64_t log_position) {
+    speculative_log_.rewind(log_position, [this](const Log_Entry& entry) {
+      if(table_[entry.index].tag != entry.tag) {
         // The entry must have been replaced by anoher entry.
         return;
       }
-      table_[index].speculative_current_iter =
-        prediction_info.current_iter_checkpoint;
-    }
+      table_[entry.index].speculative_current_iter.set(entry.old_iter);
+    });
+  }
+
+  // Speculative updates done before log_position can no longer be undone.
+  void retire_speculative_state(int64_t log_position) {
+    speculative_log_.retire(log_position);
   }
 
   static void build_empty_prediction(
@@ -227,12 +240,22 @@ class Loop_Predictor {
     LoopPredictorEntry() : current_iter(0) {}
   };
 
+  // Value of speculative_current_iter before a speculative update.
+  struct Log_Entry {
+    int     index;
+    int16_t tag;
+    typename Saturating_Counter<LOOP_CONFIG::ITERATION_COUNTER_WIDTH,
+                                false>::Int_Type old_iter;
+  };
+
   Loop_Predictor_Indices get_indices(uint64_t br_pc) const;
   int                    get_tag(uint64_t br_pc) const;
 
   std::vector<LoopPredictorEntry> table_;
 
   Random_Number_Generator& random_number_gen_;
+
+  Speculative_Delta_Log<Log_Entry> speculative_log_;
 };
 
 template <class LOOP_CONFIG>
@@ -147,7 +147,7 @@ struct SC_Prediction_Info {
 template <class CONFIG>
 class Statistical_Corrector {
  public:
-  Statistical_Corrector();
+  Statistical_Corrector(int max_in_flight_branches);
 
   void get_prediction(
     uint64_t                                           br_pc,
@@ -171,25 +171,27 @@ class Statistical_Corrector {
     path_           = prediction_info.history_snapshot.path;
   }
 
-  void local_recover_speculative_state(
-    uint64_t br_pc, const SC_Prediction_Info& prediction_info) {
-    if(CONFIG::SC::USE_LOCAL_HISTORY) {
-      first_local_history_table_.get_history(
-        br_pc) = prediction_info.history_snapshot.first_local_history;
-      if(CONFIG::SC::USE_SECOND_LOCAL_HISTORY) {
-        second_local_history_table_.get_history(
-          br_pc) = prediction_info.history_snapshot.second_local_history;
-      }
-      if(CONFIG::SC::USE_THIRD_LOCAL_HISTORY) {
-        third_local_history_table_.get_history(
-          br_pc) = prediction_info.history_snapshot.third_local_history;
+  // Log position to pass to rewind_speculative_state() for undoing all
+  // speculative local history updates from now on.
+  int64_t get_speculative_log_position() const {
+    return speculative_log_.position();
+  }
+
+  // Undoes all speculative local and IMLI history updates done after
+  // log_position.
+  void rewind_speculative_state(int64_t log_position) {
+    speculative_log_.rewind(log_position, [this](const Log_Entry& entry) {
+      if(entry.history) {
+        *entry.history = entry.old_value;
+      } else {
+        imli_counter_.set(entry.old_value);
       }
-    }
-    if(CONFIG::SC::USE_IMLI) {
-      imli_counter_.set(prediction_info.history_snapshot.imli_counter);
-      imli_table_[imli_counter_.get()] =
-        prediction_info.history_snapshot.imli_local_history;
-    }
+    });
+  }
+
+  // Speculative updates done before log_position can no longer be undone.
+  void retire_speculative_state(int64_t log_position) {
+    speculative_log_.retire(log_position);
   }
 
  private:
@@ -201,6 +203,23 @@ class Statistical_Corrector {
     Threshold_Table<CONFIG::SC::VARIABLE_THRESHOLD_WIDTH,
                     CONFIG::SC::LOG_SIZE_VARIABLE_THRESHOLD_TABLE>;
 
+  // A local or IMLI history (or the IMLI counter if history is null) before
+  // a speculative update.
+  struct Log_Entry {
+    int64_t* history;
+    int64_t  old_value;
+  };
+
+  // Each branch updates three local histories, one IMLI history and the IMLI
+  // counter.
+  static constexpr int MAX_LOG_ENTRIES_PER_BRANCH = 5;
+
+  // Logs the current value of history and returns it for updating.
+  int64_t& log_history(int64_t& history) {
+    speculative_log_.push({&history, history});
+    return history;
+  }
+
   void initialize_bias_tables(void);
 
   int get_threshold_table_index(uint64_t br_pc);
@@ -320,10 +339,13 @@ class Statistical_Corrector {
   std::vector<Counter_Type> bias_table_;
   std::vector<Counter_Type> bias_sk_table_;
   std::vector<Counter_Type> bias_bank_table_;
+
+  Speculative_Delta_Log<Log_Entry> speculative_log_;
 };
 
 template <class CONFIG>
-Statistical_Corrector<CONFIG>::Statistical_Corrector() :
+Statistical_Corrector<CONFIG>::Statistical_Corrector(
+  int max_in_flight_branches) :
     first_local_history_table_(), second_local_history_table_(),
     third_local_history_table_(), imli_counter_(0), imli_table_(),
     first_high_confidence_ctr_(0), second_high_confidence_ctr_(0),
@@ -341,7 +363,9 @@ Statistical_Corrector<CONFIG>::Statistical_Corrector() :
     bias_threshold_table_(CONFIG::SC::INITIAL_VARIABLE_THRESHOLD_FOR_BIAS),
     bias_table_(1 << CONFIG::SC::LOG_BIAS_ENTRIES, Counter_Type(0)),
     bias_sk_table_(1 << CONFIG::SC::LOG_BIAS_ENTRIES, Counter_Type(0)),
-    bias_bank_table_(1 << CONFIG::SC::LOG_BIAS_ENTRIES, Counter_Type(0)) {
+    bias_bank_table_(1 << CONFIG::SC::LOG_BIAS_ENTRIES, Counter_Type(0)),
+    speculative_log_((2 * max_in_flight_branches + 1) *
+                     MAX_LOG_ENTRIES_PER_BRANCH) {
   initialize_bias_tables();
 };
 
@@ -635,10 +659,12 @@ void Statistical_Corrector<CONFIG>::update_speculative_state(
   }
 
   if((br_type.is_conditional) && CONFIG::SC::USE_IMLI) {
-    int table_index          = imli_counter_.get();
-    imli_table_[table_index] = (imli_table_[table_index] << 1) + resolve_dir;
+    int      table_index        = imli_counter_.get();
+    int64_t& imli_local_history = log_history(imli_table_[table_index]);
+    imli_local_history          = (imli_local_history << 1) + resolve_dir;
     if(br_target < br_pc) {
       // This branch corresponds to a loop
+      speculative_log_.push({nullptr, imli_counter_.get()});
       if(!resolve_dir) {
         // exit of the "loop"
         imli_counter_.set(0);
@@ -651,17 +677,17 @@ void Statistical_Corrector<CONFIG>::update_speculative_state(
   if(br_type.is_conditional) {
     global_history_ = (global_history_ << 1) +
                       (resolve_dir & (br_target < br_pc));
-    int64_t& first_local_history = first_local_history_table_.get_history(
-      br_pc);
+    int64_t& first_local_history = log_history(
+      first_local_history_table_.get_history(br_pc));
     first_local_history = (first_local_history << 1) + resolve_dir;
 
-    int64_t& second_local_history = second_local_history_table_.get_history(
-      br_pc);
+    int64_t& second_local_history = log_history(
+      second_local_history_table_.get_history(br_pc));
     second_local_history = ((second_local_history << 1) + resolve_dir) ^
                            (br_pc & 15);
 
-    int64_t& third_local_history = third_local_history_table_.get_history(
-      br_pc);
+    int64_t& third_local_history = log_history(
+      third_local_history_table_.get_history(br_pc));
     third_local_history = (third_local_history << 1) + resolve_dir;
   }
 
@@ -22,28 +22,32 @@
 #ifndef __TAGE_H_
 #define __TAGE_H_
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
 #include "utils.h"
 
 /* The main history register suitable for very large history. The history is
- * implemented as a circular buffer for efficiency. The API only allows
- * insertions of bits into the most recent position of the history and provides
- * an accessor for random access of individual bits. It also provides an API for
- * rewinding the history to support recovery from mispeculation */
+ * implemented as a circular buffer of 64-bit words for efficiency. The API only
+ * allows insertions of bits into the most recent position of the history and
+ * provides accessors for random access of individual bits or of up to 64
+ * consecutive bits. It also provides an API for rewinding the history to
+ * support recovery from mispeculation */
 template <int history_size>
 class Long_History_Register {
  public:
-  // Buffer_size needs to be a power of 2. (buffer_size - history_size) should
-  // be large enough to cover speculative branches that are not yet retired.
-  Long_History_Register(int max_in_flight_branches) : history_bits_() {
+  // Buffer_size needs to be a power of 2 (and at least one word).
+  // (buffer_size - history_size) should be large enough to cover speculative
+  // branches that are not yet retired.
+  Long_History_Register(int max_in_flight_branches) : history_words_() {
     int log_buffer_size       = get_min_num_bits_to_represent(history_size +
                                                         max_in_flight_branches);
-    buffer_size_              = 1 << log_buffer_size;
-    buffer_access_mask_       = (1 << log_buffer_size) - 1;
+    log_buffer_size           = std::max(log_buffer_size, int(LOG_WORD_BITS));
+    buffer_size_              = int64_t(1) << log_buffer_size;
+    buffer_access_mask_       = buffer_size_ - 1;
     max_num_speculative_bits_ = buffer_size_ - history_size;
-    history_bits_.resize(buffer_size_);
+    history_words_.resize(buffer_size_ >> LOG_WORD_BITS);
   }
 
   // Pushes one bit into the history at the head. Increments
@@ -53,7 +57,10 @@ class Long_History_Register {
     // TODO: it will be cleaner to mask head_ with (size_ - 1) now. But I
     // want to keep it compatible with Seznec.
     head_ -= 1;
-    history_bits_[head_ & buffer_access_mask_] = bit;
+    int64_t   pos  = head_ & buffer_access_mask_;
+    uint64_t& word = history_words_[pos >> LOG_WORD_BITS];
+    uint64_t  mask = uint64_t(1) << (pos & (WORD_BITS - 1));
+    word           = bit ? (word | mask) : (word & ~mask);
 
     num_speculative_bits_ += 1;
     assert(num_speculative_bits_ <= max_num_speculative_bits_);
@@ -73,70 +80,126 @@ class Long_History_Register {
   }
 
   // Random access interface, i=0 is the most recent branch (head).
-  bool operator[](size_t i) const {
-    return history_bits_[(head_ + i) & buffer_access_mask_];
+  bool operator[](size_t i) const { return get_bits(i, 1); }
+
+  // Returns num_bits (at most 64) consecutive history bits starting at
+  // position i. Bit j of the result is the history bit at position i + j.
+  uint64_t get_bits(int64_t i, int num_bits) const {
+    assert(num_bits > 0 && num_bits <= WORD_BITS);
+    int64_t  pos    = (head_ + i) & buffer_access_mask_;
+    int64_t  word   = pos >> LOG_WORD_BITS;
+    int      offset = pos & (WORD_BITS - 1);
+    uint64_t bits   = history_words_[word] >> offset;
+    if(offset + num_bits > WORD_BITS) {
+      int64_t next_word = (word + 1) & ((buffer_size_ >> LOG_WORD_BITS) - 1);
+      bits |= history_words_[next_word] << (WORD_BITS - offset);
+    }
+    return num_bits == WORD_BITS ? bits :
+                                   bits & ((uint64_t(1) << num_bits) - 1);
   }
 
   int64_t head_idx() const { return head_; }
 
+  static constexpr int LOG_WORD_BITS = 6;
+  static constexpr int WORD_BITS     = 1 << LOG_WORD_BITS;
+
  private:
   int num_speculative_bits_ = 0;  // keeps track of how many bits can be
                                   // discarded during a rewind without losing
                                   // bits in the most significant position.
-  std::vector<bool> history_bits_;
-  int64_t           head_ = 0;
-  int64_t           buffer_size_;
-  int64_t           buffer_access_mask_;
-  int64_t           max_num_speculative_bits_;
+  std::vector<uint64_t> history_words_;
+  int64_t               head_ = 0;
+  int64_t               buffer_size_;
+  int64_t               buffer_access_mask_;
+  int64_t               max_num_speculative_bits_;
 };
 
 /* Computes the a folded history of a large history, as bits are shifted into
- * the history. The caller should update the folded history everytime  */
+ * the history. The caller should update the folded history everytime bits
+ * are pushed into (or rewound out of) the history register.
+ *
+ * Shifting one bit in is a left rotation of the compressed_length-bit value
+ * with the new bit xored into position 0 and the bit leaving the original
+ * history xored into position outpoint_. Shifting n bits in is therefore a
+ * rotation by n with the n new bits and the n leaving bits (each folded onto
+ * compressed_length bits) xored in, which only needs a few word operations
+ * per 64 bits of n. */
 template <int history_size>
 class Folded_History {
  public:
+  Folded_History() : Folded_History(1, 1) {}
   Folded_History(int original_length, int compressed_length) :
       current_value_(0), original_length_(original_length),
       compressed_length_(compressed_length),
-      outpoint_(original_length % compressed_length) {}
+      outpoint_(original_length % compressed_length),
+      mask_((int64_t(1) << compressed_length) - 1) {}
 
   int64_t get_value() const { return current_value_; }
 
-  void update(const Long_History_Register<history_size>& history_register) {
-    // Shift in the most recent GHR bit.
-    current_value_ = (current_value_ << 1) ^ history_register[0];
-
-    // Shift out the least recent GHR bit.
-    current_value_ ^= history_register[original_length_] << outpoint_;
-
-    // Fold shifted-out bit in.
-    current_value_ ^= current_value_ >> compressed_length_;
-
-    // Mask out the unused bits.
-    current_value_ &= (1 << compressed_length_) - 1;
+  // Accounts for the num_bits most recent bits, which must have already been
+  // pushed into history_register.
+  void update(const Long_History_Register<history_size>& history_register,
+              int num_bits = 1) {
+    current_value_ = rotate_left(current_value_,
+                                 num_bits % compressed_length_) ^
+                     get_shifted_bits(history_register, num_bits);
   }
 
+  // Reverts update() for the num_bits most recent bits. Should be called
+  // before rewinding them out of history_register.
   void update_reverse(
-    const Long_History_Register<history_size>& history_register) {
-    // Fold out the most recent GHR bit.
-    current_value_ ^= history_register[0];
+    const Long_History_Register<history_size>& history_register,
+    int                                        num_bits = 1) {
+    current_value_ = rotate_left(
+      current_value_ ^ get_shifted_bits(history_register, num_bits),
+      compressed_length_ - num_bits % compressed_length_);
+  }
 
-    // Fold out the least recent GHR bit.
-    current_value_ ^= history_register[original_length_] << outpoint_;
+ private:
+  // The combined contribution of the bits shifted into and out of the
+  // original history by the last num_bits pushes.
+  int64_t get_shifted_bits(
+    const Long_History_Register<history_size>& history_register,
+    int                                        num_bits) const {
+    constexpr int word_bits =
+      Long_History_Register<history_size>::WORD_BITS;
+    int64_t bits_in  = 0;
+    int64_t bits_out = 0;
+    for(int i = 0; i < num_bits; i += word_bits) {
+      int chunk_bits = std::min(word_bits, num_bits - i);
+      int rotation   = i % compressed_length_;
+      bits_in ^= rotate_left(fold(history_register.get_bits(i, chunk_bits)),
+                             rotation);
+      bits_out ^= rotate_left(
+        fold(history_register.get_bits(original_length_ + i, chunk_bits)),
+        rotation);
+    }
+    return bits_in ^ rotate_left(bits_out, outpoint_);
+  }
 
-    // Rotate the low bit around to high bit.
-    current_value_ = ((current_value_ & 1) << (compressed_length_ - 1)) |
-                     (current_value_ >> 1);
+  // Folds a 64-bit value onto compressed_length_ bits.
+  int64_t fold(uint64_t bits) const {
+    int64_t folded = 0;
+    while(bits) {
+      folded ^= bits & mask_;
+      bits >>= compressed_length_;
+    }
+    return folded;
+  }
 
-    // Mask out the unused bits.
-    current_value_ &= (1 << compressed_length_) - 1;
+  int64_t rotate_left(int64_t value, int amount) const {
+    if(amount == 0 || amount == compressed_length_) {
+      return value;
+    }
+    return ((value << amount) | (value >> (compressed_length_ - amount))) &
+           mask_;
   }
 
- private:
   int64_t current_value_;
   int     original_length_;
   int     compressed_length_;
   int     outpoint_;
+  int64_t mask_;
 };
 
 template <class TAGE_CONFIG>
@@ -265,20 +328,42 @@ class Tage_Histories {
 
       path_history_ = (path_history_ << 1) ^ (path_hash & 127);
       path_hash >>= 1;
-
-      for(int j = 0; j < TAGE_CONFIG::NUM_HISTORIES; ++j) {
-        folded_histories_for_indices_[j].update(history_register_);
-        folded_histories_for_tags_0_[j].update(history_register_);
-        folded_histories_for_tags_1_[j].update(history_register_);
-      }
     }
 
+    // All inserted bits are folded in at once.
+    update_folded_histories(num_bit_inserts);
+
     path_history_ = path_history_ &
                     ((1 << TAGE_CONFIG::PATH_HISTORY_WIDTH) - 1);
   }
 
   void intialize_folded_history(void);
 
+  // Updates all folded histories after num_bits bits were pushed into the
+  // history register.
+  void update_folded_histories(int num_bits) {
+    Static_For<0, TAGE_CONFIG::NUM_HISTORIES>::run([&](auto j) {
+      folded_histories_for_indices_[j].update(history_register_, num_bits);
+      folded_histories_for_tags_0_[j].update(history_register_, num_bits);
+      folded_histories_for_tags_1_[j].update(history_register_, num_bits);
+    });
+  }
+
+  // Reverts all folded histories and rewinds num_bits bits out of the history
+  // register. Each folded history is reverted in a single step no matter how
+  // many bits are rewound.
+  void rewind_folded_histories(int num_bits) {
+    Static_For<0, TAGE_CONFIG::NUM_HISTORIES>::run([&](auto j) {
+      folded_histories_for_indices_[j].update_reverse(history_register_,
+                                                      num_bits);
+      folded_histories_for_tags_0_[j].update_reverse(history_register_,
+                                                     num_bits);
+      folded_histories_for_tags_1_[j].update_reverse(history_register_,
+                                                     num_bits);
+    });
+    history_register_.rewind(num_bits);
+  }
+
   // Hash function for the path history used in creating table indices.
   int64_t compute_path_hash(int64_t path_history, int max_width, int bank,
                             int index_size) const;
@@ -290,12 +375,12 @@ class Tage_Histories {
 
   // Predictor State
   Long_History_Register<TAGE_CONFIG::MAX_HISTORY_SIZE> history_register_;
-  std::vector<Folded_History<TAGE_CONFIG::MAX_HISTORY_SIZE>>
-    folded_histories_for_indices_;
-  std::vector<Folded_History<TAGE_CONFIG::MAX_HISTORY_SIZE>>
-    folded_histories_for_tags_0_;
-  std::vector<Folded_History<TAGE_CONFIG::MAX_HISTORY_SIZE>>
-    folded_histories_for_tags_1_;
+  Folded_History<TAGE_CONFIG::MAX_HISTORY_SIZE>
+    folded_histories_for_indices_[TAGE_CONFIG::NUM_HISTORIES];
+  Folded_History<TAGE_CONFIG::MAX_HISTORY_SIZE>
+    folded_histories_for_tags_0_[TAGE_CONFIG::NUM_HISTORIES];
+  Folded_History<TAGE_CONFIG::MAX_HISTORY_SIZE>
+    folded_histories_for_tags_1_[TAGE_CONFIG::NUM_HISTORIES];
 
   int64_t path_history_;
   int64_t head_old_;
@@ -586,23 +671,12 @@ class Tage {
     int64_t num_flushed_bits =
       (prediction_info.global_history_head_checkpoint_ -
        tage_histories_.history_register_.head_idx());
-    for(int i = 0; i < num_flushed_bits; ++i) {
-      for(int j = 0; j < TAGE_CONFIG::NUM_HISTORIES; ++j) {
-        tage_histories_.folded_histories_for_indices_[j].update_reverse(
-          tage_histories_.history_register_);
-        tage_histories_.folded_histories_for_tags_0_[j].update_reverse(
-          tage_histories_.history_register_);
-        tage_histories_.folded_histories_for_tags_1_[j].update_reverse(
-          tage_histories_.history_register_);
-      }
-      tage_histories_.history_register_.rewind(1);
+    if(num_flushed_bits > 0) {
+      tage_histories_.rewind_folded_histories(num_flushed_bits);
     }
     tage_histories_.path_history_ = prediction_info.path_history_checkpoint;
   }
 
-  void local_recover_speculative_state(
-    const Tage_Prediction_Info<TAGE_CONFIG>& prediction_info) {}
-
   static void build_empty_prediction(
     Tage_Prediction_Info<TAGE_CONFIG>* prediction_info) {
     *prediction_info = {};
@@ -689,19 +763,15 @@ void Tage<TAGE_CONFIG>::initialize_table_sizes(void) {
 
 template <class TAGE_CONFIG>
 void Tage_Histories<TAGE_CONFIG>::intialize_folded_history(void) {
-  // insert dummy entries for the zeroth entry of the vector
   for(int i = 0; i < TAGE_CONFIG::NUM_HISTORIES; i++) {
-    // For some reason I cannot pass LOG_ENTRIES_PER_BANK to emplace_bank()
-    // directly (gcc complains that variable is undefined), do not know why.
-    // REVISIT: since I got rid of LOG_ENTRIES_PER_BANK as a constant, this
-    // should be fine now.
-    const int LOG_ENTRIES_PER_BANK2 = TAGE_CONFIG::LOG_ENTRIES_PER_BANK;
-    folded_histories_for_indices_.emplace_back(history_sizes_.arr[i],
-                                               LOG_ENTRIES_PER_BANK2);
-    folded_histories_for_tags_0_.emplace_back(history_sizes_.arr[i],
-                                              tag_bits_.arr[i]);
-    folded_histories_for_tags_1_.emplace_back(history_sizes_.arr[i],
-                                              tag_bits_.arr[i] - 1);
+    folded_histories_for_indices_[i] = Folded_History<
+      TAGE_CONFIG::MAX_HISTORY_SIZE>(history_sizes_.arr[i],
+                                     TAGE_CONFIG::LOG_ENTRIES_PER_BANK);
+    folded_histories_for_tags_0_[i] = Folded_History<
+      TAGE_CONFIG::MAX_HISTORY_SIZE>(history_sizes_.arr[i], tag_bits_.arr[i]);
+    folded_histories_for_tags_1_[i] =
+      Folded_History<TAGE_CONFIG::MAX_HISTORY_SIZE>(history_sizes_.arr[i],
+                                                    tag_bits_.arr[i] - 1);
   }
 }
 
@@ -744,40 +814,48 @@ int64_t Tage_Histories<TAGE_CONFIG>::compute_path_hash(int64_t path_history,
 template <class TAGE_CONFIG>
 void Tage<TAGE_CONFIG>::fill_table_indices_tags(
   uint64_t br_pc, Tage_Prediction_Info<TAGE_CONFIG>* output) const {
-  // Generate tags and indices, ignore bank bits for now.
-  for(int i = 1; i <= Tage_Histories<TAGE_CONFIG>::twice_num_histories_;
-      i += 2) {
-    if(tables_enabled_.arr[i] || tables_enabled_.arr[i + 1]) {
-      int max_path_width = (tage_histories_.history_sizes_.arr[(i - 1) / 2] >
-                            TAGE_CONFIG::PATH_HISTORY_WIDTH) ?
-                             TAGE_CONFIG::PATH_HISTORY_WIDTH :
-                             tage_histories_.history_sizes_.arr[(i - 1) / 2];
+  // Generate tags and indices, ignore bank bits for now. The loop is unrolled
+  // at compile time so that all per-table shifts and masks are constants.
+  Static_For<1, Tage_Histories<TAGE_CONFIG>::twice_num_histories_ + 1, 2>::run(
+    [&](auto i_constant) {
+      constexpr int i    = decltype(i_constant)::value;
+      constexpr int hist = (i - 1) / 2;
+      if(!tables_enabled_.arr[i] && !tables_enabled_.arr[i + 1]) {
+        return;
+      }
+      constexpr int max_path_width =
+        (Tage_Histories<TAGE_CONFIG>::history_sizes_.arr[hist] >
+         TAGE_CONFIG::PATH_HISTORY_WIDTH) ?
+          TAGE_CONFIG::PATH_HISTORY_WIDTH :
+          Tage_Histories<TAGE_CONFIG>::history_sizes_.arr[hist];
+      constexpr int pc_shift = (TAGE_CONFIG::LOG_ENTRIES_PER_BANK > i ?
+                                  TAGE_CONFIG::LOG_ENTRIES_PER_BANK - i :
+                                  i - TAGE_CONFIG::LOG_ENTRIES_PER_BANK) +
+                               1;
+      constexpr int64_t index_mask = (1 << TAGE_CONFIG::LOG_ENTRIES_PER_BANK) -
+                                     1;
+      constexpr int64_t tag_mask =
+        (1 << Tage_Histories<TAGE_CONFIG>::tag_bits_.arr[hist]) - 1;
+
       int64_t path_hash = tage_histories_.compute_path_hash(
         tage_histories_.path_history_, max_path_width, i,
         TAGE_CONFIG::LOG_ENTRIES_PER_BANK);
       int64_t index = br_pc;
-      index ^= br_pc >> (std::abs(TAGE_CONFIG::LOG_ENTRIES_PER_BANK - i) + 1);
-      index ^=
-        tage_histories_.folded_histories_for_indices_[(i - 1) / 2].get_value();
+      index ^= br_pc >> pc_shift;
+      index ^= tage_histories_.folded_histories_for_indices_[hist].get_value();
       index ^= path_hash;
-      output->indices[i] = index &
-                           ((1 << TAGE_CONFIG::LOG_ENTRIES_PER_BANK) - 1);
+      output->indices[i] = index & index_mask;
 
       int64_t tag = br_pc;
-      tag ^=
-        tage_histories_.folded_histories_for_tags_0_[(i - 1) / 2].get_value();
-      tag ^=
-        tage_histories_.folded_histories_for_tags_1_[(i - 1) / 2].get_value()
-        << 1;
-      output->tags[i] = tag &
-                        ((1 << tage_histories_.tag_bits_.arr[(i - 1) / 2]) - 1);
+      tag ^= tage_histories_.folded_histories_for_tags_0_[hist].get_value();
+      tag ^= tage_histories_.folded_histories_for_tags_1_[hist].get_value()
+             << 1;
+      output->tags[i] = tag & tag_mask;
 
       output->tags[i + 1]    = output->tags[i];
       output->indices[i + 1] = output->indices[i] ^
-                               (output->tags[i] &
-                                ((1 << TAGE_CONFIG::LOG_ENTRIES_PER_BANK) - 1));
-    }
-  }
+                               (output->tags[i] & index_mask);
+    });
 
   // Now add bank bits to the indices of high history tables.
   int temp = (br_pc ^
@@ -32,6 +32,20 @@ struct Tage_SC_L_Prediction_Info {
   SC_Prediction_Info                          sc;
   bool                                        final_prediction;
   uint64_t                                    br_pc;
+
+  // Positions of the loop predictor and SC speculative logs when the branch
+  // was fetched. Recovering to the branch rewinds the logs to these positions.
+  int64_t loop_log_position;
+  int64_t sc_log_position;
+};
+
+/* Host time spent in each component of the predictor (for profiling the
+ * simulator itself). Only accumulated when enabled with set_host_timing(). */
+struct Tage_SC_L_Host_Time {
+  uint64_t tage_ns     = 0;
+  uint64_t loop_ns     = 0;
+  uint64_t sc_ns       = 0;
+  uint64_t recovery_ns = 0;
 };
 
 class Tage_SC_L_Base {
@@ -50,6 +64,9 @@ class Tage_SC_L_Base {
                                              Branch_Type br_type,
                                              bool        resolve_dir,
                                              uint64_t    br_target)      = 0;
+  virtual void set_host_timing(bool enabled)                          = 0;
+  virtual const Tage_SC_L_Host_Time& get_host_time() const            = 0;
+  virtual ~Tage_SC_L_Base() {}
 };
 
 /* Interface functions:
@@ -66,7 +83,8 @@ class Tage_SC_L : public Tage_SC_L_Base {
  public:
   Tage_SC_L(int max_in_flight_branches) :
       tage_(random_number_gen_, max_in_flight_branches),
-      statistical_corrector_(), loop_predictor_(random_number_gen_),
+      statistical_corrector_(max_in_flight_branches),
+      loop_predictor_(random_number_gen_, max_in_flight_branches),
       loop_predictor_beneficial_(-1),
       prediction_info_buffer_(max_in_flight_branches) {}
 
@@ -81,6 +99,10 @@ class Tage_SC_L : public Tage_SC_L_Base {
     Tage<typename CONFIG::TAGE>::build_empty_prediction(&prediction_info.tage);
     Loop_Predictor<typename CONFIG::LOOP>::build_empty_prediction(
       &prediction_info.loop);
+    prediction_info.loop_log_position =
+      loop_predictor_.get_speculative_log_position();
+    prediction_info.sc_log_position =
+      statistical_corrector_.get_speculative_log_position();
     return branch_id;
   }
 
@@ -116,11 +138,19 @@ class Tage_SC_L : public Tage_SC_L_Base {
   // Flushes the branch and all branches that came after it and repairs the
   // speculative state of the predictor. It invalidated all branch_id of
   // flushed
-  // branches.
+  // branches. The cost does not depend on the number of flushed branches,
+  // only on the number of speculative table updates they made.
   void flush_branch_and_repair_state(int64_t branch_id, uint64_t br_pc,
                                      Branch_Type br_type, bool resolve_dir,
                                      uint64_t br_target) override;
 
+  // Enables accumulating the host time spent in each component.
+  void set_host_timing(bool enabled) override { host_timing_ = enabled; }
+
+  const Tage_SC_L_Host_Time& get_host_time() const override {
+    return host_time_;
+  }
+
  private:
   Random_Number_Generator               random_number_gen_;
   Tage<typename CONFIG::TAGE>           tage_;
@@ -135,6 +165,9 @@ class Tage_SC_L : public Tage_SC_L_Base {
   // that
   // are needed for update.
   Circular_Buffer<Tage_SC_L_Prediction_Info<CONFIG>> prediction_info_buffer_;
+
+  bool                host_timing_ = false;
+  Tage_SC_L_Host_Time host_time_;
 };
 
 template <class CONFIG>
@@ -142,13 +175,17 @@ bool Tage_SC_L<CONFIG>::get_prediction(int64_t branch_id, uint64_t br_pc) {
   auto& prediction_info = prediction_info_buffer_[branch_id];
 
   // First, use Tage to make a prediction.
-  tage_.get_prediction(br_pc, &prediction_info.tage);
+  {
+    Scoped_Host_Timer timer(host_timing_, &host_time_.tage_ns);
+    tage_.get_prediction(br_pc, &prediction_info.tage);
+  }
   prediction_info.tage_or_loop_prediction = prediction_info.tage.prediction;
 
   if(CONFIG::USE_LOOP_PREDICTOR) {
     // Then, look up the loop predictor and override Tage's prediction if
     // the
     // loop predictor is found to be beneficial.
+    Scoped_Host_Timer timer(host_timing_, &host_time_.loop_ns);
     loop_predictor_.get_prediction(br_pc, &prediction_info.loop);
     if(loop_predictor_beneficial_.get() >= 0 && prediction_info.loop.valid) {
       prediction_info.tage_or_loop_prediction = prediction_info.loop.prediction;
@@ -158,6 +195,7 @@ bool Tage_SC_L<CONFIG>::get_prediction(int64_t branch_id, uint64_t br_pc) {
   if(!CONFIG::USE_SC) {
     prediction_info.final_prediction = prediction_info.tage_or_loop_prediction;
   } else {
+    Scoped_Host_Timer timer(host_timing_, &host_time_.sc_ns);
     statistical_corrector_.get_prediction(
       br_pc, prediction_info.tage, prediction_info.tage_or_loop_prediction,
       &prediction_info.sc);
@@ -174,12 +212,14 @@ void Tage_SC_L<CONFIG>::commit_state(int64_t branch_id, uint64_t br_pc,
   }
   auto& prediction_info = prediction_info_buffer_[branch_id];
   if(CONFIG::USE_SC) {
+    Scoped_Host_Timer timer(host_timing_, &host_time_.sc_ns);
     statistical_corrector_.commit_state(
       br_pc, resolve_dir, prediction_info.tage, prediction_info.sc,
       prediction_info.tage_or_loop_prediction);
   }
 
   if(CONFIG::USE_LOOP_PREDICTOR) {
+    Scoped_Host_Timer timer(host_timing_, &host_time_.loop_ns);
     if(prediction_info.loop.valid) {
       if(prediction_info.final_prediction != prediction_info.loop.prediction) {
         loop_predictor_beneficial_.update(resolve_dir ==
@@ -196,6 +236,7 @@ void Tage_SC_L<CONFIG>::commit_state(int64_t branch_id, uint64_t br_pc,
       prediction_info.tage.prediction);
   }
 
+  Scoped_Host_Timer timer(host_timing_, &host_time_.tage_ns);
   tage_.commit_state(br_pc, resolve_dir, prediction_info.tage,
                      prediction_info.final_prediction);
 }
@@ -206,28 +247,20 @@ void Tage_SC_L<CONFIG>::flush_branch_and_repair_state(int64_t     branch_id,
                                                       Branch_Type br_type,
                                                       bool        resolve_dir,
                                                       uint64_t    br_target) {
-  // First iterate over all flushed branches from youngest to oldest and call
-  // local recovery functions.
-  for(int64_t id = prediction_info_buffer_.back_id(); id >= branch_id; --id) {
-    auto& prediction_info = prediction_info_buffer_[id];
-    tage_.local_recover_speculative_state(prediction_info.tage);
-    if(CONFIG::USE_LOOP_PREDICTOR) {
-      loop_predictor_.local_recover_speculative_state(prediction_info.loop);
-    }
-    if(CONFIG::USE_SC) {
-      statistical_corrector_.local_recover_speculative_state(
-        prediction_info.br_pc, prediction_info.sc);
-    }
-  }
+  Scoped_Host_Timer timer(host_timing_, &host_time_.recovery_ns);
   prediction_info_buffer_.deallocate_after(branch_id);
-
-  // Now call global recovery functions.
   auto& prediction_info = prediction_info_buffer_[branch_id];
+
+  // Undo the table updates of the flushed branches (including this one) and
+  // restore the global histories.
   tage_.global_recover_speculative_state(prediction_info.tage);
   if(CONFIG::USE_LOOP_PREDICTOR) {
+    loop_predictor_.rewind_speculative_state(prediction_info.loop_log_position);
     loop_predictor_.global_recover_speculative_state(prediction_info.loop);
   }
   if(CONFIG::USE_SC) {
+    statistical_corrector_.rewind_speculative_state(
+      prediction_info.sc_log_position);
     statistical_corrector_.global_recover_speculative_state(prediction_info.sc);
   }
 
@@ -258,8 +291,13 @@ void Tage_SC_L<CONFIG>::commit_state_at_retire(int64_t     branch_id,
   //      prediction_info.tage.prediction);
   //}
   tage_.commit_state_at_retire(prediction_info.tage);
+  if(CONFIG::USE_LOOP_PREDICTOR) {
+    loop_predictor_.retire_speculative_state(prediction_info.loop_log_position);
+  }
   if(CONFIG::USE_SC) {
     statistical_corrector_.commit_state_at_retire();
+    statistical_corrector_.retire_speculative_state(
+      prediction_info.sc_log_position);
   }
   prediction_info_buffer_.deallocate_front(branch_id);
 }
@@ -271,12 +309,17 @@ void Tage_SC_L<CONFIG>::update_speculative_state(int64_t     branch_id,
                                                  bool        branch_dir,
                                                  uint64_t    br_target) {
   auto& prediction_info = prediction_info_buffer_[branch_id];
-  tage_.update_speculative_state(br_pc, br_target, br_type, branch_dir,
-                                 &prediction_info.tage);
+  {
+    Scoped_Host_Timer timer(host_timing_, &host_time_.tage_ns);
+    tage_.update_speculative_state(br_pc, br_target, br_type, branch_dir,
+                                   &prediction_info.tage);
+  }
   if(CONFIG::USE_LOOP_PREDICTOR) {
+    Scoped_Host_Timer timer(host_timing_, &host_time_.loop_ns);
     loop_predictor_.update_speculative_state(prediction_info.loop);
   }
   if(CONFIG::USE_SC) {
+    Scoped_Host_Timer timer(host_timing_, &host_time_.sc_ns);
     statistical_corrector_.update_speculative_state(
       br_pc, branch_dir, br_target, br_type, &prediction_info.sc);
   }
@@ -23,6 +23,9 @@
 #define __TAGE_SC_L_LIB_H_
 
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <vector>
 
 inline int get_min_num_bits_to_represent(int x) {
   assert(x > 0);
@@ -120,6 +123,68 @@ class Saturating_Counter {
   Int_Type counter_;
 };
 
+/* Table of unsigned saturating counters whose width is only known at run time
+ * (e.g. PHT_CTR_BITS), packed into 64-bit words instead of a byte each. Every
+ * entry holds `ways` counters stored next to each other, so a predictor that
+ * reads several counters with the same index touches one host cache line.
+ * The width and the number of ways must be powers of two and an entry must
+ * fit in a word, so entries never straddle two words. */
+class Packed_Counter_Table {
+ public:
+  void init(uint64_t num_entries, unsigned ways, unsigned width,
+            unsigned init_value) {
+    assert(width && !(width & (width - 1)) && width <= 8);
+    assert(ways && !(ways & (ways - 1)) && ways * width <= 64);
+    assert(init_value < (1u << width));
+    log_width_    = get_min_num_bits_to_represent(width + 1) - 1;
+    log_ways_     = get_min_num_bits_to_represent(ways + 1) - 1;
+    log_per_word_ = 6 - log_width_;
+    max_          = (1u << width) - 1;
+
+    uint64_t init_word = 0;
+    for(unsigned ii = 0; ii < (1u << log_per_word_); ii++) {
+      init_word |= (uint64_t)init_value << (ii << log_width_);
+    }
+    words_.assign(((num_entries << log_ways_) >> log_per_word_) + 1,
+                  init_word);
+  }
+
+  unsigned get(uint64_t index, unsigned way) const {
+    const uint64_t slot = (index << log_ways_) | way;
+    return (words_[slot >> log_per_word_] >> shift(slot)) & max_;
+  }
+
+  void set(uint64_t index, unsigned way, unsigned value) {
+    const uint64_t slot = (index << log_ways_) | way;
+    uint64_t&      word = words_[slot >> log_per_word_];
+    word &= ~((uint64_t)max_ << shift(slot));
+    word |= (uint64_t)value << shift(slot);
+  }
+
+  // Increments the counter if condition is true, otherwise decrements it.
+  // Only unsaturated counters change, so adding or subtracting one in place
+  // cannot carry into the neighbouring counters.
+  void update(uint64_t index, unsigned way, bool condition) {
+    // Branch free, as the directions fed to the tables are hard to predict.
+    const uint64_t slot  = (index << log_ways_) | way;
+    uint64_t&      word  = words_[slot >> log_per_word_];
+    const unsigned value = (word >> shift(slot)) & max_;
+    word += (uint64_t)(condition & (value < max_)) << shift(slot);
+    word -= (uint64_t)(!condition & (value > 0)) << shift(slot);
+  }
+
+ private:
+  unsigned shift(uint64_t slot) const {
+    return (slot & ((1u << log_per_word_) - 1)) << log_width_;
+  }
+
+  std::vector<uint64_t> words_;
+  unsigned              log_width_;
+  unsigned              log_ways_;
+  unsigned              log_per_word_;
+  unsigned              max_;
+};
+
 // This is an ugly way to do random number generation, but I want to keep it
 // compatible with Seznec for now.
 class Random_Number_Generator {
@@ -140,6 +205,33 @@ class Random_Number_Generator {
   int64_t* ptghist_ptr_;
 };
 
+/* A compile-time integer, passed to the body of a Static_For loop so that the
+ * loop variable can be used in constant expressions. */
+template <int value_>
+struct Int_Constant {
+  static constexpr int value = value_;
+  constexpr operator int() const { return value; }
+};
+
+/* Compile-time loop: calls func(Int_Constant<i>()) for i = begin, begin + step,
+ * ... while i < end. Used for per-table loops of the predictors whose bounds
+ * and per-table constants come from the configuration structs, so that every
+ * iteration is specialized and the loop is fully unrolled. */
+template <int begin, int end, int step = 1, bool done = (begin >= end)>
+struct Static_For {
+  template <typename Func>
+  static void run(Func&& func) {
+    func(Int_Constant<begin>());
+    Static_For<begin + step, end, step>::run(func);
+  }
+};
+
+template <int begin, int end, int step>
+struct Static_For<begin, end, step, true> {
+  template <typename Func>
+  static void run(Func&& func) {}
+};
+
 struct Branch_Type {
   bool is_conditional;
   bool is_indirect;
@@ -195,4 +287,83 @@ class Circular_Buffer {
   int64_t size_  = 0;
 };
 
+/* An undo log for speculative updates of predictor tables. Every speculative
+ * write pushes the overwritten value, and a branch remembers the log position
+ * at the time it was fetched. Recovering to that branch pops and undoes only
+ * the writes done since (youngest first), and retiring a branch releases all
+ * older log entries at once. The log never needs to be walked per in-flight
+ * branch. */
+template <typename T>
+class Speculative_Delta_Log {
+ public:
+  Speculative_Delta_Log(int64_t max_size) {
+    assert(max_size > 0);
+    int min_num_address_bits = get_min_num_bits_to_represent(max_size);
+    buffer_size_             = int64_t(1) << min_num_address_bits;
+    buffer_access_mask_      = buffer_size_ - 1;
+    buffer_.resize(buffer_size_);
+  }
+
+  // The position of the next entry. Passing it to rewind() later undoes
+  // everything pushed after this call.
+  int64_t position() const { return back_; }
+
+  void push(const T& entry) {
+    assert(back_ - front_ < buffer_size_);
+    buffer_[back_ & buffer_access_mask_] = entry;
+    back_ += 1;
+  }
+
+  // Calls undo(entry) on every entry pushed at or after position, youngest
+  // first, and drops them from the log.
+  template <typename Undo>
+  void rewind(int64_t position, Undo&& undo) {
+    assert(position >= front_);
+    while(back_ > position) {
+      back_ -= 1;
+      undo(buffer_[back_ & buffer_access_mask_]);
+    }
+  }
+
+  // Releases all entries older than position; they can no longer be undone.
+  void retire(int64_t position) {
+    if(position > front_) {
+      assert(position <= back_);
+      front_ = position;
+    }
+  }
+
+ private:
+  std::vector<T> buffer_;
+  int64_t        buffer_size_;
+  int64_t        buffer_access_mask_;
+
+  int64_t back_  = 0;
+  int64_t front_ = 0;
+};
+
+/* Adds the host (wall-clock) time spent in its scope to *nanoseconds. Does
+ * nothing when constructed with enabled == false. */
+class Scoped_Host_Timer {
+ public:
+  Scoped_Host_Timer(bool enabled, uint64_t* nanoseconds) :
+      nanoseconds_(enabled ? nanoseconds : nullptr) {
+    if(nanoseconds_) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~Scoped_Host_Timer() {
+    if(nanoseconds_) {
+      *nanoseconds_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start_)
+                         .count();
+    }
+  }
+
+ private:
+  uint64_t*                             nanoseconds_;
+  std::chrono::steady_clock::time_point start_;
+};
+
 #endif  // __TAGE_SC_L_LIB_H_
@@ -37,15 +37,21 @@
 #include "dvfs/dvfs.h"
 #include "dvfs/dvfs.param.h"
 #include "dvfs/perf_pred.h"
+#include "fdip.h"
 #include "general.param.h"
 #include "globals/assert.h"
 #include "memory/cache_part.h"
 #include "memory/memory.param.h"
+#include "memory/tlb.h"
 #include "op_pool.h"
 #include "prefetcher/pref.param.h"
 #include "prefetcher/pref_common.h"
 #include "sim.h"
+#include "smt.h"
 #include "statistics.h"
+#include "store_sets.h"
+#include "uop_cache.h"
+#include "value_pred.h"
 
 #include "freq.h"
 
@@ -59,7 +65,6 @@ static void cmp_redirect(void);
 static void cmp_measure_chip_util(void);
 static void cmp_istreams(void);
 static void cmp_cores(void);
-static void warmup_uncore(uns proc_id, Addr addr, Flag write);
 
 /**************************************************************************************/
 /* cmp_init */
@@ -121,6 +126,18 @@ void cmp_init(uns mode) {
   // init_memory will call init_uncores, which setup the partition stuffs
   init_memory();
 
+  init_tlb();
+
+  init_fdip();
+
+  init_uop_cache();
+
+  init_store_sets();
+
+  init_value_pred();
+
+  init_smt();
+
   if(DVFS_ON)
     dvfs_init();
 
@@ -194,7 +211,10 @@ void cmp_istreams(void) {
 }
 
 void cmp_cores(void) {
-  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+  update_smt();
+
+  for(uns ii = 0; ii < NUM_CORES; ii++) {
+    uns proc_id = smt_thread_order(ii);
     if(DUMB_CORE_ON && DUMB_CORE == proc_id)
       continue;
 
@@ -205,12 +225,14 @@ void cmp_cores(void) {
       set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
       cmp_set_all_stages(proc_id);
 
+      update_tlb(proc_id);
       update_dcache_stage(&exec->sd);
       update_exec_stage(&node->sd);
       update_node_stage(map->last_sd);
       update_map_stage(dec->last_sd);
       update_decode_stage(&ic->sd);
       update_icache_stage();
+      update_fdip(proc_id);
 
       node_sched_ops();
 
@@ -370,11 +392,15 @@ void cmp_retire_hook(Op* op) {
   free_op(op);
 }
 
+/**************************************************************************************/
+/* warmup_uncore: warm the L1 with one access (also used by the interval
+   model) */
+
 void warmup_uncore(uns proc_id, Addr addr, Flag write) {
   Addr dummy_line_addr;
   ASSERTM(0, !MLC_PRESENT, "Warmup for MLC not implemented\n");
 
-  Cache*   l1_cache = &(cmp_model.memory.uncores[proc_id].l1->cache);
+  Cache*   l1_cache = &(mem->uncores[proc_id].l1->cache);
   L1_Data* l1_data  = cache_access(l1_cache, addr, &dummy_line_addr, TRUE);
   if(l1_data) {  // hit
     if(write)
@@ -421,6 +447,8 @@ void cmp_warmup(Op* op) {
   Cache*      icache  = &(ic->icache);
   Inst_Info** ic_data = (Inst_Info**)cache_access(icache, ia, &dummy_line_addr,
                                                   TRUE);
+  if(TLB_ON)
+    tlb_warmup(proc_id, ia, TRUE);
   if(!ic_data) {
     warmup_uncore(proc_id, ia, FALSE);
     Addr repl_line_addr;
@@ -432,6 +460,8 @@ void cmp_warmup(Op* op) {
   Flag is_load  = op->table_info->mem_type == MEM_LD;
   Flag is_store = op->table_info->mem_type == MEM_ST;
   if(is_load || is_store) {
+    if(TLB_ON)
+      tlb_warmup(proc_id, va, FALSE);
     Cache*       dcache  = &(cmp_model.dcache_stage[proc_id].dcache);
     Dcache_Data* dc_data = cache_access(dcache, va, &dummy_line_addr, TRUE);
     if(dc_data) {
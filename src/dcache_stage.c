@@ -51,7 +51,8 @@
 #include "cmp_model.h"
 #include "prefetcher/l2l1pref.h"
 
-#include "libs/hash_lib.h"
+#include "memory/coherence.h"
+#include "memory/tlb.h"
 
 /**************************************************************************************/
 /* Macros */
@@ -59,13 +60,20 @@
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_DCACHE_STAGE, ##args)
 #define STAGE_MAX_OP_COUNT NUM_FUS
 
+/* the reuse distance histogram has one bucket per power of two of lines */
+#define REUSE_DIST_BUCKETS 15
+#define REUSE_DIST_LINES (1 << (REUSE_DIST_BUCKETS - 1))
+
 
 /**************************************************************************************/
 /* Global Variables */
 
 Dcache_Stage* dc = NULL;
-Hash_Table    seen_addresses;
-Flag          seen_addresses_initialized = FALSE;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static Flag store_forward(Op* op);
 
 /**************************************************************************************/
 /* set_dcache_stage: */
@@ -109,6 +117,10 @@ void init_dcache_stage(uns8 proc_id, const char* name) {
 
   dc->dcache.repl_pref_thresh = DCACHE_REPL_PREF_THRESH;
 
+  init_stack_dist(&dc->reuse_dist, "DCACHE_REUSE_DIST",
+                  MAX2(dc->dcache.num_lines, REUSE_DIST_LINES),
+                  DCACHE_REUSE_SEEN_BITS);
+
   if(DC_PREF_CACHE_ENABLE)
     init_cache(&dc->pref_dcache, "DC_PREF_CACHE", DC_PREF_CACHE_SIZE,
                DC_PREF_CACHE_ASSOC, DCACHE_LINE_SIZE, sizeof(Dcache_Data),
@@ -174,7 +186,8 @@ void update_dcache_stage(Stage_Data* src_sd) {
 
     Flag stall_dc_op = dc_op &&
                        (dc_op->state == OS_WAIT_DCACHE ||
-                        (STALL_ON_WAIT_MEM && dc_op->state == OS_WAIT_MEM));
+                        (STALL_ON_WAIT_MEM && (dc_op->state == OS_WAIT_MEM ||
+                                               dc_op->state == OS_WAIT_TLB)));
     if(dc_op && !stall_dc_op) {
       // unless the op stalled getting a dcache port, it's gone
       dc->sd.ops[ii] = NULL;
@@ -264,6 +277,30 @@ void update_dcache_stage(Stage_Data* src_sd) {
       continue;
     }
 
+    /* translate the address first; on a TLB miss the op waits for the
+       second level TLB or the page walk and then replays (or stalls here
+       with STALL_ON_WAIT_MEM) */
+    if(TLB_ON && !tlb_translate(dc->proc_id, op->oracle_info.va, FALSE,
+                                op->off_path)) {
+      op->state = OS_WAIT_TLB;
+      continue;
+    }
+
+    /* a load fully covered by a store still in the store queue gets its data
+       from there and never accesses the dcache */
+    if(LSQ_ON && op->table_info->mem_type == MEM_LD && store_forward(op)) {
+      STAT_EVENT(op->proc_id, STORE_FORWARD_LD);
+      if(!op->off_path)
+        STAT_EVENT(op->proc_id, STORE_FORWARD_LD_ONPATH);
+      op->state        = OS_SCHEDULED;
+      op->dcache_cycle = cycle_count;
+      op->done_cycle   = cycle_count + STORE_FORWARD_CYCLES +
+                       op->inst_info->extra_ld_latency;
+      op->wake_cycle = op->done_cycle;
+      wake_up_ops(op, REG_DATA_DEP, model->wake_hook);
+      continue;
+    }
+
     /* compute the bank---the bank bits are the lowest order cache index bits */
     bank = op->oracle_info.va >> dc->dcache.shift_bits &
            N_BIT_MASK(LOG2(DCACHE_BANKS));
@@ -352,6 +389,7 @@ void update_dcache_stage(Stage_Data* src_sd) {
       if(!op->off_path) {
         STAT_EVENT(op->proc_id, DCACHE_HIT);
         STAT_EVENT(op->proc_id, DCACHE_HIT_ONPATH);
+        stat_dcache_reuse_dist(op, line_addr);
       } else
         STAT_EVENT(op->proc_id, DCACHE_HIT_OFFPATH);
 
@@ -360,6 +398,8 @@ void update_dcache_stage(Stage_Data* src_sd) {
 
       if(!op->off_path) {
         line->dirty |= op->table_info->mem_type == MEM_ST;
+        if(op->table_info->mem_type == MEM_ST)
+          coherence_dcache_store(op->proc_id, line_addr);
       }
       line->read_count[op->off_path] = line->read_count[op->off_path] +
                                        (op->table_info->mem_type == MEM_LD);
@@ -592,32 +632,51 @@ void update_dcache_stage(Stage_Data* src_sd) {
 }
 
 /**************************************************************************************/
-/* stat_dcache_miss_type: */
+/* store_forward: can the load get its data from the store queue? The store
+   must still be in flight (not retired) and write every byte the load reads */
 
-void stat_dcache_miss_type(Op* op, Addr* line_addr) {
-  if(!seen_addresses_initialized) {
-    seen_addresses_initialized = TRUE;
-    init_hash_table(&seen_addresses, "dcache_miss_type-seen_addresses",
-                    1ULL << 20, sizeof(*line_addr));
-  }
+static Flag store_forward(Op* op) {
+  Op* st_op = op->fwd_store_op;
 
-  Flag unseen_line = FALSE;
-  hash_table_access_create(&seen_addresses, *line_addr, &unseen_line);
+  if(!st_op || !st_op->op_pool_valid ||
+     st_op->unique_num != op->fwd_store_unique ||
+     st_op->retire_cycle != MAX_CTR)
+    return FALSE;
+  return BYTE_CONTAIN(st_op->oracle_info.va, st_op->oracle_info.mem_size,
+                      op->oracle_info.va, op->oracle_info.mem_size);
+}
 
-  if(unseen_line) {
-    STAT_EVENT(op->proc_id, DCACHE_MISS_COMPULSORY);
-    return;
-  }
+/**************************************************************************************/
+/* stat_dcache_reuse_dist: push an on-path access through the LRU stack and
+   count its reuse distance */
 
-  for(int set_idx = 0; set_idx < dc->dcache.num_sets; set_idx++) {
-    for(int line_idx = 0; line_idx < dc->dcache.assoc; line_idx++) {
-      if(!dc->dcache.entries[set_idx][line_idx].valid) {
-        STAT_EVENT(op->proc_id, DCACHE_MISS_CONFLICT);
-        return;
-      }
-    }
-  }
-  STAT_EVENT(op->proc_id, DCACHE_MISS_CAPACITY);
+uns stat_dcache_reuse_dist(Op* op, Addr line_addr) {
+  uns dist = stack_dist_access(&dc->reuse_dist,
+                               line_addr >> dc->dcache.shift_bits);
+
+  if(dist == STACK_DIST_COLD)
+    STAT_EVENT(op->proc_id, DCACHE_REUSE_DIST_COLD);
+  else if(dist >= REUSE_DIST_LINES)
+    STAT_EVENT(op->proc_id, DCACHE_REUSE_DIST_FAR);
+  else
+    STAT_EVENT(op->proc_id, DCACHE_REUSE_DIST_0 + (dist ? LOG2(dist) + 1 : 0));
+  return dist;
+}
+
+/**************************************************************************************/
+/* stat_dcache_miss_type: classify an on-path miss. A miss that a
+   fully-associative LRU cache of the same size would have hit, because the
+   line is less than num_lines deep in the LRU stack, is a conflict miss. */
+
+void stat_dcache_miss_type(Op* op, Addr* line_addr) {
+  uns dist = stat_dcache_reuse_dist(op, *line_addr);
+
+  if(dist == STACK_DIST_COLD)
+    STAT_EVENT(op->proc_id, DCACHE_MISS_COMPULSORY);
+  else if(dist < dc->dcache.num_lines)
+    STAT_EVENT(op->proc_id, DCACHE_MISS_CONFLICT);
+  else
+    STAT_EVENT(op->proc_id, DCACHE_MISS_CAPACITY);
 }
 
 /**************************************************************************************/
@@ -795,6 +854,9 @@ Flag dcache_fill_line(Mem_Req* req) {
                         data->write_count[0] || data->write_count[1] ||
                         req->off_path || data->prefetch || data->HW_prefetch);
 
+  if(TLB_ON)
+    tlb_dcache_fill(dc->proc_id, req->addr);
+
   cycle_count = old_cycle_count;
   return SUCCESS;
 }
@@ -30,6 +30,7 @@
 #define __DCACHE_STAGE_H__
 
 #include "libs/cache_lib.h"
+#include "libs/stack_dist.h"
 #include "stage_data.h"
 
 /**************************************************************************************/
@@ -49,6 +50,9 @@ typedef struct Dcache_Stage_struct {
   Ports* ports;       /* read and write ports to the data cache (per bank) */
   Cache  pref_dcache; /* prefetcher cache for data cache */
 
+  Stack_Dist reuse_dist; /* LRU stack of the on-path accesses, classifies
+                            misses and tracks reuse distance */
+
   Counter idle_cycle;  /* Cycle the cache will be idle */
   Flag    mem_blocked; /* Are memory request buffers (aka MSHRs) full? */
 
@@ -99,6 +103,7 @@ void wp_process_dcache_fill(Dcache_Data* line, Mem_Req* req);
 Flag dcache_fill_line(Mem_Req*);
 void update_iso_miss(Op*);
 Flag do_oracle_dcache_access(Op*, Addr*);
+uns  stat_dcache_reuse_dist(Op*, Addr);
 void stat_dcache_miss_type(Op*, Addr*);
 
 /**************************************************************************************/
@@ -176,6 +176,13 @@ void update_decode_stage(Stage_Data* src_sd) {
   /* do the first decode stage */
   cur = &dec->sds[STAGE_MAX_DEPTH - 1];
   if(cur->op_count == 0) {
+    /* fetch packets from the uop cache skip the decoders, moving as far as
+       they can without passing older ops */
+    if(UOP_CACHE_ENABLE && src_sd->op_count && src_sd->ops[0]->uop_cache_hit) {
+      for(ii = STAGE_MAX_DEPTH - 1; ii > 0 && !dec->sds[ii - 1].op_count; ii--)
+        ;
+      cur = &dec->sds[ii];
+    }
     prev           = src_sd;
     temp           = cur->ops;
     cur->ops       = prev->ops;
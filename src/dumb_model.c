@@ -27,10 +27,32 @@
  *                generated memory requests (no core modeling)
  ***************************************************************************************/
 
+/* When DUMB_MODEL_PROFILE names a file, each dumb core replays a memory-access
+ * profile extracted from a real run instead of uniform random traffic. The
+ * file is plain text, one directive per line, '#' starts a comment:
+ *
+ *   core  <proc_id>              following lines describe this core only
+ *   reuse <max_dist> <weight>    reuse-distance histogram bin covering
+ *                                distances up to <max_dist> distinct lines
+ *   cold  <weight>               weight of first-touch (never reused) lines
+ *   stride <lines|rand> <weight> stride mix used to pick first-touch lines
+ *   rw    <reads> <writes>       read/write ratio (writes are sent as stores)
+ *   phase <cycles> <mlp> <dist>  MLP and average request distance over time;
+ *                                phases repeat in order
+ *
+ * Directives before the first 'core' line form the profile of every core that
+ * has no section of its own. Bins must be given in increasing distance order.
+ * Row hits then come from the stride mix rather than DUMB_MODEL_AVG_ROW_HITS.
+ *
+ * A cmp run with DUMB_MODEL_PROFILE_OUT writes the profile of its cores in
+ * this format (memory/mem_profile.c).
+ */
+
 #include "debug/debug_macros.h"
 #include "debug/debug_print.h"
 #include "globals/assert.h"
 #include "globals/global_vars.h"
+#include "libs/stack_dist.h"
 #include "statistics.h"
 
 #include "dumb_model.h"
@@ -38,6 +60,7 @@
 #include "model.h"
 #include "sim.h"
 
+#include <string.h>
 #include <unistd.h>
 
 #include "debug/debug.param.h"
@@ -45,9 +68,36 @@
 #include "memory/memory.param.h"
 
 
+/**************************************************************************************/
+/* Macros */
+
+#define DUMB_PROFILE_MAX_BINS 32
+#define DUMB_PROFILE_MAX_PHASES 32
+#define DUMB_PROFILE_LINE_MASK 0x7fffffffULL  // same range as the random reqs
+
 /**************************************************************************************/
 /* Types */
 
+typedef struct Dumb_Profile_struct {
+  Flag    valid;
+  uns     num_reuse_bins;
+  uns     reuse_dist[DUMB_PROFILE_MAX_BINS];  // upper bound of each bin
+  uns64   reuse_weight[DUMB_PROFILE_MAX_BINS];
+  uns64   cold_weight;
+  uns64   access_weight;  // cold plus all reuse bins
+  uns     num_strides;
+  int64   stride[DUMB_PROFILE_MAX_BINS];  // in lines
+  Flag    stride_rand[DUMB_PROFILE_MAX_BINS];
+  uns64   stride_weight[DUMB_PROFILE_MAX_BINS];
+  uns64   total_stride_weight;
+  uns     reads;
+  uns     writes;
+  uns     num_phases;
+  Counter phase_cycles[DUMB_PROFILE_MAX_PHASES];
+  uns     phase_mlp[DUMB_PROFILE_MAX_PHASES];
+  uns     phase_req_distance[DUMB_PROFILE_MAX_PHASES];
+} Dumb_Profile;
+
 typedef struct Proc_Info_struct {
   uns avg_req_distance;  // average number of cycles between reqs
   uns avg_row_hits;  // average number of row hits for every row open (incl. 1st
@@ -57,19 +107,31 @@ typedef struct Proc_Info_struct {
   uns  reqs_out;     // number of outstanding reqs
   Flag retry;        // couldn't send last mem req, keep retrying
   Flag dumb;         // is this core actually dumb
+
+  Dumb_Profile* profile;  // profile to replay (NULL for random reqs)
+  Mem_Req_Type  last_type;
+  Stack_Dist    stack;        // LRU stack of the lines this core touched
+  Addr          stream_line;  // last first-touch line (base for strides)
+  uns           phase;
+  Counter       phase_cycle;  // cycles spent in the current phase
 } Proc_Info;
 
 /**************************************************************************************/
 /* Local prototypes */
 
 static Flag dumb_req_done(Mem_Req* req);
+static void dumb_profile_read(const char* file_name);
+static void dumb_profile_start_phase(Proc_Info* info);
+static Addr dumb_profile_stride_line(Proc_Info* info);
+static Addr dumb_profile_next_addr(uns proc_id, Proc_Info* info);
 
 /**************************************************************************************/
 /* Global variables */
 
-static Proc_Info* infos;
-static Counter    req_num;
-static uns64      page_num_mask;
+static Proc_Info*    infos;
+static Counter       req_num;
+static uns64         page_num_mask;
+static Dumb_Profile* profiles;  // NUM_CORES per-core profiles, then the default
 
 /**************************************************************************************/
 /* dumb_init */
@@ -123,6 +185,26 @@ void dumb_init(uns mode) {
       }
     }
     info->last_addr = convert_to_cmp_addr(proc_id, 0);
+    info->last_type = MRT_DFETCH;
+  }
+  if(DUMB_MODEL_PROFILE) {
+    ASSERT(0, DUMB_MODEL_PROFILE_MAX_REUSE > 0);
+    dumb_profile_read(DUMB_MODEL_PROFILE);
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      Proc_Info*    info    = &infos[proc_id];
+      Dumb_Profile* profile = &profiles[proc_id];
+      if(!profile->valid)
+        profile = &profiles[NUM_CORES];
+      if(!profile->valid)
+        FATAL_ERROR(proc_id, "No profile for core %u in %s\n", proc_id,
+                    DUMB_MODEL_PROFILE);
+      info->profile = profile;
+      // only the lines in the stack are reused, so the seen filter is minimal
+      init_stack_dist(&info->stack, "DUMB_PROFILE_STACK",
+                      DUMB_MODEL_PROFILE_MAX_REUSE, 3);
+      info->stream_line = rand() & DUMB_PROFILE_LINE_MASK;
+      dumb_profile_start_phase(info);
+    }
   }
   if(SIM_MODEL == DUMB_MODEL) {
     // Only dumb model is running, initialize required subset of
@@ -163,6 +245,177 @@ Flag dumb_req_done(Mem_Req* req) {
   return TRUE;
 }
 
+/**************************************************************************************/
+/* dumb_rand64: random number wide enough for the profile weights */
+
+static inline uns64 dumb_rand64(void) {
+  return ((uns64)rand() << 31) ^ (uns64)rand();
+}
+
+/**************************************************************************************/
+/* dumb_profile_read: parse the profile file (format at the top of the file) */
+
+static void dumb_profile_read(const char* file_name) {
+  profiles = calloc(NUM_CORES + 1, sizeof(Dumb_Profile));
+  FILE* f  = fopen(file_name, "r");
+  if(!f)
+    FATAL_ERROR(0, "Could not open dumb model profile %s\n", file_name);
+
+  Dumb_Profile* profile  = &profiles[NUM_CORES];
+  uns           line_num = 0;
+  char          buf[MAX_STR_LENGTH + 1];
+  while(fgets(buf, MAX_STR_LENGTH, f)) {
+    line_num++;
+    char* comment = strchr(buf, '#');
+    if(comment)
+      *comment = '\0';
+    char* key = strtok(buf, " \t\n");
+    if(!key)
+      continue;
+    char* arg0 = strtok(NULL, " \t\n");
+    char* arg1 = strtok(NULL, " \t\n");
+    char* arg2 = strtok(NULL, " \t\n");
+    if(!arg0)
+      FATAL_ERROR(0, "%s:%u: '%s' needs an argument\n", file_name, line_num,
+                  key);
+
+    if(!strcmp(key, "core")) {
+      uns proc_id = strtoul(arg0, NULL, 0);
+      if(proc_id >= NUM_CORES)
+        FATAL_ERROR(0, "%s:%u: no core %u\n", file_name, line_num, proc_id);
+      profile = &profiles[proc_id];
+      if(profile->valid)
+        FATAL_ERROR(0, "%s:%u: core %u described twice\n", file_name,
+                    line_num, proc_id);
+    } else if(!strcmp(key, "reuse")) {
+      uns bin = profile->num_reuse_bins++;
+      if(!arg1 || bin >= DUMB_PROFILE_MAX_BINS)
+        FATAL_ERROR(0, "%s:%u: bad reuse bin\n", file_name, line_num);
+      profile->reuse_dist[bin]   = strtoul(arg0, NULL, 0);
+      profile->reuse_weight[bin] = strtoull(arg1, NULL, 0);
+      if(bin && profile->reuse_dist[bin] <= profile->reuse_dist[bin - 1])
+        FATAL_ERROR(0, "%s:%u: reuse bins out of order\n", file_name,
+                    line_num);
+    } else if(!strcmp(key, "cold")) {
+      profile->cold_weight = strtoull(arg0, NULL, 0);
+    } else if(!strcmp(key, "stride")) {
+      uns idx = profile->num_strides++;
+      if(!arg1 || idx >= DUMB_PROFILE_MAX_BINS)
+        FATAL_ERROR(0, "%s:%u: bad stride\n", file_name, line_num);
+      profile->stride_rand[idx]   = !strcmp(arg0, "rand");
+      profile->stride[idx]        = strtoll(arg0, NULL, 0);
+      profile->stride_weight[idx] = strtoull(arg1, NULL, 0);
+    } else if(!strcmp(key, "rw")) {
+      if(!arg1)
+        FATAL_ERROR(0, "%s:%u: rw needs reads and writes\n", file_name,
+                    line_num);
+      profile->reads  = strtoul(arg0, NULL, 0);
+      profile->writes = strtoul(arg1, NULL, 0);
+    } else if(!strcmp(key, "phase")) {
+      uns phase = profile->num_phases++;
+      if(!arg2 || phase >= DUMB_PROFILE_MAX_PHASES)
+        FATAL_ERROR(0, "%s:%u: bad phase\n", file_name, line_num);
+      profile->phase_cycles[phase]       = strtoull(arg0, NULL, 0);
+      profile->phase_mlp[phase]          = strtoul(arg1, NULL, 0);
+      profile->phase_req_distance[phase] = strtoul(arg2, NULL, 0);
+      if(!profile->phase_cycles[phase] || !profile->phase_mlp[phase] ||
+         !profile->phase_req_distance[phase])
+        FATAL_ERROR(0, "%s:%u: phase values must be non-zero\n", file_name,
+                    line_num);
+    } else {
+      FATAL_ERROR(0, "%s:%u: unknown directive '%s'\n", file_name, line_num,
+                  key);
+    }
+    profile->valid = TRUE;
+  }
+  ASSERT(0, feof(f));
+  fclose(f);
+
+  for(uns ii = 0; ii <= NUM_CORES; ii++) {
+    profile = &profiles[ii];
+    if(!profile->valid)
+      continue;
+    profile->access_weight = profile->cold_weight;
+    for(uns bin = 0; bin < profile->num_reuse_bins; bin++)
+      profile->access_weight += profile->reuse_weight[bin];
+    if(!profile->access_weight) {
+      // no locality given: every access touches a new line
+      profile->cold_weight = profile->access_weight = 1;
+    }
+    for(uns idx = 0; idx < profile->num_strides; idx++)
+      profile->total_stride_weight += profile->stride_weight[idx];
+    if(!profile->reads && !profile->writes)
+      profile->reads = 1;
+  }
+}
+
+/**************************************************************************************/
+/* dumb_profile_start_phase: apply the MLP and request rate of the current
+ * phase */
+
+static void dumb_profile_start_phase(Proc_Info* info) {
+  Dumb_Profile* profile = info->profile;
+  info->phase_cycle     = 0;
+  if(!profile->num_phases)
+    return;
+  info->mlp              = profile->phase_mlp[info->phase];
+  info->avg_req_distance = profile->phase_req_distance[info->phase];
+}
+
+/**************************************************************************************/
+/* dumb_profile_stride_line: pick a first-touch line from the stride mix */
+
+static Addr dumb_profile_stride_line(Proc_Info* info) {
+  Dumb_Profile* profile = info->profile;
+  Addr          line    = rand();
+  if(profile->total_stride_weight) {
+    uns64 pick = dumb_rand64() % profile->total_stride_weight;
+    uns   idx  = 0;
+    while(pick >= profile->stride_weight[idx])
+      pick -= profile->stride_weight[idx++];
+    if(!profile->stride_rand[idx])
+      line = info->stream_line + profile->stride[idx];
+  }
+  info->stream_line = line & DUMB_PROFILE_LINE_MASK;
+  return info->stream_line;
+}
+
+/**************************************************************************************/
+/* dumb_profile_next_addr: sample the reuse-distance histogram (an LRU stack of
+ * the lines this core touched), the stride mix and the read/write ratio */
+
+static Addr dumb_profile_next_addr(uns proc_id, Proc_Info* info) {
+  Dumb_Profile* profile = info->profile;
+  uns64         pick    = dumb_rand64() % profile->access_weight;
+  uns           depth   = STACK_DIST_COLD;  // unless a reuse is picked
+  if(pick >= profile->cold_weight) {
+    uns bin = 0;
+    pick -= profile->cold_weight;
+    while(pick >= profile->reuse_weight[bin])
+      pick -= profile->reuse_weight[bin++];
+    uns lo = bin ? profile->reuse_dist[bin - 1] + 1 : 0;
+    depth  = lo + rand() % (profile->reuse_dist[bin] - lo + 1);
+  }
+
+  Addr line;
+  STAT_EVENT(proc_id, DUMB_PROFILE_REQ);
+  if(stack_dist_line(&info->stack, depth, &line)) {
+    STAT_EVENT(proc_id, DUMB_PROFILE_REQ_REUSE);
+  } else {
+    // reuses deeper than the stack holds (e.g. while warming up) are cold
+    line = dumb_profile_stride_line(info);
+    STAT_EVENT(proc_id, DUMB_PROFILE_REQ_COLD);
+  }
+  stack_dist_access(&info->stack, line);  // move it to the top
+
+  info->last_type = MRT_DFETCH;
+  if(dumb_rand64() % (profile->reads + profile->writes) >= profile->reads) {
+    info->last_type = MRT_DSTORE;
+    STAT_EVENT(proc_id, DUMB_PROFILE_REQ_WRITE);
+  }
+  return convert_to_cmp_addr(proc_id, line * L1_LINE_SIZE);
+}
+
 /**************************************************************************************/
 /* dumb_cycle: */
 
@@ -173,17 +426,26 @@ void dumb_cycle() {
     if(SIM_MODEL != DUMB_MODEL && proc_id != DUMB_CORE)
       continue;
     STAT_EVENT(proc_id, NODE_CYCLE);
-    Proc_Info* info     = &infos[proc_id];
-    Flag       send_req = info->retry || (info->reqs_out < info->mlp &&
-                                    (rand() % info->avg_req_distance) == 0);
-    if(info->retry || info->reqs_out == info->mlp) {
+    Proc_Info* info = &infos[proc_id];
+    if(info->profile && info->profile->num_phases &&
+       ++info->phase_cycle >= info->profile->phase_cycles[info->phase]) {
+      info->phase = (info->phase + 1) % info->profile->num_phases;
+      dumb_profile_start_phase(info);
+      STAT_EVENT(proc_id, DUMB_PROFILE_PHASE_CHANGE);
+    }
+    // a new phase may lower the MLP below the number of reqs already out, so
+    // a retry also has to wait for a free slot
+    Flag send_req = info->reqs_out < info->mlp &&
+                    (info->retry || (rand() % info->avg_req_distance) == 0);
+    if(info->retry || info->reqs_out >= info->mlp) {
       STAT_EVENT(proc_id, FULL_WINDOW_STALL);
     }
     if(send_req) {
-      ASSERT(proc_id, info->reqs_out < info->mlp);
       Addr addr;
       if(info->retry) {
         addr = info->last_addr;
+      } else if(info->profile) {
+        addr = dumb_profile_next_addr(proc_id, info);
       } else {
         addr = convert_to_cmp_addr(proc_id, rand() * L1_LINE_SIZE);
         if(rand() % info->avg_row_hits != 0) {
@@ -196,8 +458,12 @@ void dumb_cycle() {
       ASSERT(proc_id, get_proc_id_from_cmp_addr(addr) == proc_id);
       info->last_addr    = addr;
       Counter unique_num = SIM_MODEL == DUMB_MODEL ? req_num : unique_count;
-      Flag sent = new_mem_req(MRT_DFETCH, proc_id, addr, L1_LINE_SIZE, 0, NULL,
-                              dumb_req_done, unique_num, NULL);
+      // the dumb core has no cache, so its stores dirty the memory system's
+      Flag sent = info->last_type == MRT_DSTORE ?
+                    new_mem_dirty_req(proc_id, addr, L1_LINE_SIZE, 0,
+                                      dumb_req_done, unique_num) :
+                    new_mem_req(info->last_type, proc_id, addr, L1_LINE_SIZE,
+                                0, NULL, dumb_req_done, unique_num, NULL);
       info->retry = !sent;
       if(sent) {
         req_num++;
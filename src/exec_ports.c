@@ -28,6 +28,7 @@
 
 
 #include <stdio.h>
+#include "cmp_model.h"
 #include "core.param.h"
 #include "exec_stage.h"
 #include "general.param.h"
@@ -35,17 +36,12 @@
 #include "globals/global_defs.h"
 #include "globals/utils.h"
 #include "node_stage.h"
+#include "smt.h"
 #include "table_info.h"
 
 #include "exec_ports.h"
 #include "stat_trace.h"
 
-/**************************************************************************************/
-/* Macros */
-
-// Each op_type can have non-simd and simd versions
-#define FU_TYPE_WIDTH (2 * NUM_OP_TYPES)
-
 /**************************************************************************************/
 /* Global Variables */
 uns POWER_TOTAL_RS_SIZE     = 0;
@@ -59,6 +55,7 @@ uns POWER_NUM_FPUS          = 0;
 /* Local Function Prototypes */
 void init_exec_ports_fu_list(uns, Func_Unit*);
 void init_exec_ports_rs_list(uns, Reservation_Station*, Func_Unit*);
+void init_exec_ports_fu_eligible(uns, Func_Unit*);
 Flag parse_next_elt(char*, uns64*);
 Flag is_fpu_type(uns64 fu_type);
 Flag is_mul_or_div_type(uns64 fu_type);
@@ -244,6 +241,7 @@ void init_exec_ports_rs_list(uns proc_id, Reservation_Station* rs,
     }
     ASSERTM(proc_id, NUM_FUS <= 64,
             "NUM_FUS cannot exceed 64 (using a 64 bit int for bitmask)\n");
+    rs[i].fu_mask = next;
 
     int32 num_fus     = 0;
     int32 num_fus_pre = __builtin_popcount(
@@ -279,6 +277,19 @@ void init_exec_ports_rs_list(uns proc_id, Reservation_Station* rs,
   free(rs_connections_copy);
 }
 
+/* For each FU type bit, the set of FUs (by fu_id) that can execute it, so the
+ * scheduler can intersect it with an RS's fu_mask instead of walking FUs. */
+void init_exec_ports_fu_eligible(uns proc_id, Func_Unit* fu) {
+  ASSERT(proc_id, FU_TYPE_WIDTH <= sizeof(uns64) * CHAR_BIT);
+  node->fu_eligible = (uns64*)calloc(FU_TYPE_WIDTH, sizeof(uns64));
+  for(uns32 i = 0; i < NUM_FUS; ++i) {
+    for(uns32 t = 0; t < FU_TYPE_WIDTH; ++t) {
+      if(fu[i].type & (1ull << t))
+        node->fu_eligible[t] |= 1ull << fu[i].fu_id;
+    }
+  }
+}
+
 // Note: this function must be called *after* init_node_stage and
 // init_exec_stage.
 void init_exec_ports(uns8 proc_id, const char* name) {
@@ -291,11 +302,20 @@ void init_exec_ports(uns8 proc_id, const char* name) {
 
   exec->fus = (Func_Unit*)calloc(NUM_FUS, sizeof(Func_Unit));
   init_exec_ports_fu_list(proc_id, exec->fus);
+  init_exec_ports_fu_eligible(proc_id, exec->fus);
+
+  /* the threads of an SMT core share the reservation stations of the first
+     thread */
+  uns leader = smt_core_leader(proc_id);
+  if(leader != proc_id) {
+    node->rs = cmp_model.node_stage[leader].rs;
+    return;
+  }
 
   node->rs = (Reservation_Station*)calloc(NUM_RS, sizeof(Reservation_Station));
   init_exec_ports_rs_list(proc_id, node->rs, exec->fus);
 }
 
 uns64 get_fu_type(Op_Type op_type, Flag is_simd) {
-  return (1ull << op_type) << (is_simd ? NUM_OP_TYPES : 0);
+  return 1ull << FU_TYPE_IDX(op_type, is_simd);
 }
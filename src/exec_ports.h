@@ -31,6 +31,16 @@
 
 #include "table_info.h"
 
+/**************************************************************************************/
+/* Macros */
+
+// Each op_type can have non-simd and simd versions
+#define FU_TYPE_WIDTH (2 * NUM_OP_TYPES)
+
+// Bit position of an (op_type, is_simd) pair in a Func_Unit type mask
+#define FU_TYPE_IDX(op_type, is_simd) \
+  ((op_type) + ((is_simd) ? NUM_OP_TYPES : 0))
+
 /**************************************************************************************/
 /* Type Declarations */
 void init_exec_ports(uns8, const char*);
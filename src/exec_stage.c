@@ -47,6 +47,7 @@
 #include "dvfs/perf_pred.h"
 #include "general.param.h"
 #include "memory/memory.param.h"
+#include "smt.h"
 #include "statistics.h"
 
 
@@ -144,6 +145,8 @@ void recover_exec_stage() {
       exec->sd.op_count--;
       fu->avail_cycle = cycle_count + 1;
       fu->idle_cycle  = cycle_count + 1;
+      if(SMT_THREADS > 1)
+        smt_fu_release(exec->proc_id, ii);
     }
   }
 }
@@ -222,6 +225,14 @@ void update_exec_stage(Stage_Data* src_sd) {
     }
     if(!op)
       continue;
+    if(SMT_THREADS > 1 && smt_fu_busy(exec->proc_id, ii)) {
+      // the fu is shared with another SMT thread that is using it
+      STAT_EVENT(exec->proc_id, SMT_FU_CONFLICT);
+      op->delay_bit   = 1;
+      src_sd->ops[ii] = NULL;
+      src_sd->op_count--;
+      continue;
+    }
     // }}}
 
     // {{{ dependent instruction wakeup
@@ -289,6 +300,10 @@ void update_exec_stage(Stage_Data* src_sd) {
       if(fop->table_info->mem_type) {
         fu->held_by_mem = TRUE;
         STAT_EVENT(exec->proc_id, FU_BUSY_MEM_STALL);
+        // keep the siblings out through next cycle, they may be updated
+        // before this thread
+        if(SMT_THREADS > 1)
+          smt_fu_claim(exec->proc_id, ii, cycle_count + 2);
       }
       continue;
     }
@@ -318,6 +333,8 @@ void update_exec_stage(Stage_Data* src_sd) {
     // if the op is not pipelined, then busy up the functional unit
     fu->avail_cycle = cycle_count + (latency < 0 ? -latency : 1);
     fu->idle_cycle  = cycle_count + (latency < 0 ? -latency : latency);
+    if(SMT_THREADS > 1)
+      smt_fu_claim(exec->proc_id, ii, fu->avail_cycle);
 
     // set the op's state to reflect it's execution
     if(op->table_info->mem_type == NOT_MEM || STALL_ON_WAIT_MEM) {
@@ -0,0 +1,459 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : fdip.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Fetch-directed instruction prefetching. A fetch target queue
+ *                of predicted fetch blocks runs ahead of the icache stage and
+ *                prefetches the icache lines of the queued blocks.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "fdip.h"
+#include "icache_stage.h"
+#include "libs/cache_lib.h"
+#include "memory/memory.h"
+#include "memory/memory.param.h"
+#include "statistics.h"
+
+/*
+   The oracle frontend hands out ops one at a time, in lockstep with
+   bp_predict_op, so the branch predictor cannot be run ahead of the icache
+   directly. Instead, fetch blocks are predicted at icache line granularity by
+   a fetch target buffer (FTB) that is trained on the line stream the icache
+   stage fetches, i.e. on the targets bp_predict_op (or a redirect) produced.
+   A block is a run of sequential lines keyed by its first line; its FTB entry
+   holds the number of lines and the line fetch continued at.
+
+   Every cycle the FTQ is synchronized with the icache: blocks the icache has
+   moved past are dequeued, and if the fetch line is not in the queue at all
+   (the block predictor was wrong or the core was redirected), the queue is
+   flushed and the walk restarts at the fetch line. The walk then appends up
+   to FDIP_PREDICT_WIDTH blocks, and the lines of queued blocks that are not
+   in the icache are prefetched with MRT_IPRF requests.
+*/
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_FDIP, ##args)
+
+#define FDIP_LINE(addr) ((addr) & ~(Addr)(ICACHE_LINE_SIZE - 1))
+#define FDIP_NEXT_LINE(line) ((line) + ICACHE_LINE_SIZE)
+
+/* prefetches that have not filled by then are assumed dropped by memory */
+#define FDIP_PREF_TIMEOUT 10000
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Ftb_Entry_struct {
+  uns  num_lines;   /* sequential icache lines in the block */
+  Addr target_line; /* line fetch continued at after the block */
+} Ftb_Entry;
+
+typedef struct Ftq_Block_struct {
+  Addr line_addr; /* first icache line of the block */
+  uns  num_lines;
+  uns  num_issued; /* lines already considered for prefetching */
+} Ftq_Block;
+
+typedef struct Fdip_Pref_struct {
+  Flag    valid;
+  Flag    filled;
+  Flag    demanded; /* a demand fetch already accounted for this prefetch */
+  Addr    line_addr;
+  Counter issue_cycle;
+} Fdip_Pref;
+
+typedef struct Fdip_struct {
+  Cache ftb;
+
+  Ftq_Block* ftq;
+  uns        ftq_head;
+  uns        ftq_count;
+  Addr       pred_line; /* first line of the next block to predict */
+
+  /* block the icache stage is fetching, for training the FTB */
+  Flag train_valid;
+  Addr train_start;
+  Addr train_line;
+  Addr train_addr;
+  uns  train_lines;
+
+  Fdip_Pref* prefs; /* outstanding and recently filled prefetches */
+  uns        num_prefs;
+  uns        inflight;
+} Fdip;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Fdip* fdips = NULL;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static Addr       fdip_ftb_key(Addr line_addr);
+static void       fdip_ftb_update(Fdip* fdip, uns8 proc_id, Addr target_line);
+static Ftq_Block* fdip_ftq_block(Fdip* fdip, uns idx);
+static void       fdip_sync(Fdip* fdip, Addr fetch_line);
+static void       fdip_predict(Fdip* fdip);
+static void       fdip_issue(Fdip* fdip, uns8 proc_id, Addr fetch_line);
+static Fdip_Pref* fdip_find_pref(Fdip* fdip, Addr line_addr);
+static void       fdip_add_pref(Fdip* fdip, Addr line_addr);
+static void       fdip_release_pref(Fdip* fdip, Fdip_Pref* pref);
+
+/**************************************************************************************/
+/* init_fdip: */
+
+void init_fdip(void) {
+  if(!FDIP_ON)
+    return;
+
+  ASSERTM(0, FTQ_ENTRIES > 0, "FTQ needs at least one entry\n");
+  ASSERTM(0, FDIP_BLOCK_LINES > 0, "FDIP blocks need at least one line\n");
+  ASSERTM(0,
+          FDIP_FTB_ENTRIES % FDIP_FTB_ASSOC == 0 &&
+            is_power_of_2(FDIP_FTB_ENTRIES / FDIP_FTB_ASSOC),
+          "FDIP_FTB_ENTRIES / FDIP_FTB_ASSOC must be a power of two\n");
+
+  fdips = (Fdip*)calloc(NUM_CORES, sizeof(Fdip));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Fdip* fdip = &fdips[proc_id];
+    init_cache(&fdip->ftb, "FDIP_FTB", FDIP_FTB_ENTRIES, FDIP_FTB_ASSOC, 1,
+               sizeof(Ftb_Entry), REPL_TRUE_LRU);
+    fdip->ftq = (Ftq_Block*)calloc(FTQ_ENTRIES, sizeof(Ftq_Block));
+    /* leave room for filled prefetches that have not been used yet */
+    fdip->num_prefs = 4 * MAX2(FDIP_MAX_INFLIGHT, 1);
+    fdip->prefs = (Fdip_Pref*)calloc(fdip->num_prefs, sizeof(Fdip_Pref));
+  }
+}
+
+/**************************************************************************************/
+/* update_fdip: */
+
+void update_fdip(uns8 proc_id) {
+  if(!FDIP_ON)
+    return;
+
+  Fdip* fdip = &fdips[proc_id];
+  ASSERT(proc_id, ic->proc_id == proc_id);
+
+  STAT_EVENT(proc_id, FDIP_CYCLE);
+
+  /* the fetch address is not known until the redirect, and nothing is
+     fetched while the icache is waiting for a recovery */
+  if(ic->next_state != IC_WAIT_FOR_REDIRECT &&
+     (FETCH_OFF_PATH_OPS || !ic->off_path)) {
+    Addr fetch_line = FDIP_LINE(ic->next_fetch_addr);
+    fdip_sync(fdip, fetch_line);
+    fdip_predict(fdip);
+    fdip_issue(fdip, proc_id, fetch_line);
+  }
+
+  INC_STAT_EVENT(proc_id, FDIP_FTQ_OCCUPANCY, fdip->ftq_count);
+  if(fdip->ftq_count == FTQ_ENTRIES)
+    STAT_EVENT(proc_id, FDIP_FTQ_FULL);
+}
+
+/**************************************************************************************/
+/* fdip_icache_access: */
+
+void fdip_icache_access(uns8 proc_id, Addr fetch_addr, Flag hit,
+                        Flag off_path) {
+  if(!FDIP_ON)
+    return;
+
+  Fdip*      fdip      = &fdips[proc_id];
+  Addr       line_addr = FDIP_LINE(fetch_addr);
+  Fdip_Pref* pref      = fdip_find_pref(fdip, line_addr);
+  Flag       useful    = FALSE;
+
+  if(pref && !pref->demanded) {
+    if(hit && pref->filled) {
+      useful = TRUE;
+      STAT_EVENT(proc_id, FDIP_PREF_USEFUL);
+      fdip_release_pref(fdip, pref);
+    } else if(!hit && !pref->filled) {
+      STAT_EVENT(proc_id, FDIP_PREF_LATE);
+      pref->demanded = TRUE;
+    }
+  }
+
+  if(off_path)
+    return;
+
+  if(!hit || useful)
+    STAT_EVENT(proc_id, FDIP_COVERAGE_BASE);
+  if(useful)
+    STAT_EVENT(proc_id, FDIP_COVERED);
+
+  /* train the FTB on the on-path line stream */
+  if(!fdip->train_valid) {
+    fdip->train_valid = TRUE;
+    fdip->train_start = line_addr;
+    fdip->train_lines = 1;
+  } else if(line_addr == fdip->train_line && fetch_addr >= fdip->train_addr) {
+    /* still fetching the same line */
+  } else if(line_addr == FDIP_NEXT_LINE(fdip->train_line)) {
+    if(fdip->train_lines == FDIP_BLOCK_LINES) {
+      fdip_ftb_update(fdip, proc_id, line_addr);
+      fdip->train_start = line_addr;
+      fdip->train_lines = 1;
+    } else {
+      fdip->train_lines++;
+    }
+  } else {
+    /* taken control flow ends the block */
+    fdip_ftb_update(fdip, proc_id, line_addr);
+    fdip->train_start = line_addr;
+    fdip->train_lines = 1;
+  }
+  fdip->train_line = line_addr;
+  fdip->train_addr = fetch_addr;
+}
+
+/**************************************************************************************/
+/* fdip_icache_fill: */
+
+void fdip_icache_fill(uns8 proc_id, Addr line_addr) {
+  if(!FDIP_ON)
+    return;
+
+  Fdip*      fdip = &fdips[proc_id];
+  Fdip_Pref* pref = fdip_find_pref(fdip, line_addr);
+  if(!pref || pref->filled)
+    return;
+
+  DEBUG(proc_id, "FDIP prefetch of line 0x%s filled after %llu cycles\n",
+        hexstr64s(line_addr), cycle_count - pref->issue_cycle);
+  pref->filled = TRUE;
+  ASSERT(proc_id, fdip->inflight > 0);
+  fdip->inflight--;
+  /* a late prefetch has been accounted for by the demand miss */
+  if(pref->demanded)
+    fdip_release_pref(fdip, pref);
+}
+
+/**************************************************************************************/
+/* fdip_ftb_key: */
+
+static Addr fdip_ftb_key(Addr line_addr) {
+  return line_addr >> LOG2(ICACHE_LINE_SIZE);
+}
+
+/**************************************************************************************/
+/* fdip_ftb_update: the training block ended and fetch continued at
+   target_line */
+
+static void fdip_ftb_update(Fdip* fdip, uns8 proc_id, Addr target_line) {
+  Addr       key = fdip_ftb_key(fdip->train_start);
+  Addr       line_addr, repl_line_addr;
+  Ftb_Entry* entry = (Ftb_Entry*)cache_access(&fdip->ftb, key, &line_addr,
+                                              TRUE);
+  if(!entry) {
+    entry = (Ftb_Entry*)cache_insert(&fdip->ftb, proc_id, key, &line_addr,
+                                     &repl_line_addr);
+    STAT_EVENT(proc_id, FDIP_FTB_INSERT);
+  }
+  entry->num_lines   = fdip->train_lines;
+  entry->target_line = target_line;
+}
+
+/**************************************************************************************/
+/* fdip_ftq_block: idx-th block from the head of the FTQ */
+
+static Ftq_Block* fdip_ftq_block(Fdip* fdip, uns idx) {
+  ASSERT(0, idx < fdip->ftq_count);
+  return &fdip->ftq[(fdip->ftq_head + idx) % FTQ_ENTRIES];
+}
+
+/**************************************************************************************/
+/* fdip_sync: dequeue the blocks the icache has fetched past */
+
+static void fdip_sync(Fdip* fdip, Addr fetch_line) {
+  while(fdip->ftq_count) {
+    Ftq_Block* head = fdip_ftq_block(fdip, 0);
+    if(fetch_line >= head->line_addr &&
+       fetch_line < head->line_addr + head->num_lines * ICACHE_LINE_SIZE)
+      return;
+    fdip->ftq_head = (fdip->ftq_head + 1) % FTQ_ENTRIES;
+    fdip->ftq_count--;
+  }
+
+  /* the fetch line was not predicted, restart the walk from it */
+  if(fdip->pred_line != fetch_line) {
+    STAT_EVENT(ic->proc_id, FDIP_FTQ_RESTEER);
+    DEBUG(ic->proc_id, "FTQ resteered to line 0x%s\n", hexstr64s(fetch_line));
+  }
+  fdip->pred_line = fetch_line;
+}
+
+/**************************************************************************************/
+/* fdip_predict: append predicted blocks to the FTQ */
+
+static void fdip_predict(Fdip* fdip) {
+  for(uns ii = 0; ii < FDIP_PREDICT_WIDTH && fdip->ftq_count < FTQ_ENTRIES;
+      ii++) {
+    Addr       line_addr;
+    Ftb_Entry* entry = (Ftb_Entry*)cache_access(
+      &fdip->ftb, fdip_ftb_key(fdip->pred_line), &line_addr, TRUE);
+    Ftq_Block* block = &fdip->ftq[(fdip->ftq_head + fdip->ftq_count) %
+                                  FTQ_ENTRIES];
+
+    block->line_addr  = fdip->pred_line;
+    block->num_issued = 0;
+    if(entry) {
+      block->num_lines = entry->num_lines;
+      fdip->pred_line  = entry->target_line;
+    } else {
+      /* unknown block, assume it falls through */
+      block->num_lines = 1;
+      fdip->pred_line  = FDIP_NEXT_LINE(block->line_addr);
+    }
+    fdip->ftq_count++;
+
+    STAT_EVENT(ic->proc_id, FDIP_BLOCK_PREDICTED);
+    if(entry)
+      STAT_EVENT(ic->proc_id, FDIP_BLOCK_FTB_HIT);
+  }
+}
+
+/**************************************************************************************/
+/* fdip_issue: prefetch the lines of the queued blocks, oldest block first */
+
+static void fdip_issue(Fdip* fdip, uns8 proc_id, Addr fetch_line) {
+  uns sent = 0;
+
+  for(uns ii = 0; ii < fdip->ftq_count; ii++) {
+    Ftq_Block* block = fdip_ftq_block(fdip, ii);
+    while(block->num_issued < block->num_lines) {
+      Addr line_addr = block->line_addr + block->num_issued * ICACHE_LINE_SIZE;
+      Addr dummy_addr;
+
+      /* the icache stage requests the fetch line itself */
+      if(line_addr == fetch_line ||
+         cache_access(&ic->icache, line_addr, &dummy_addr, FALSE)) {
+        block->num_issued++;
+        continue;
+      }
+
+      Fdip_Pref* pref = fdip_find_pref(fdip, line_addr);
+      if(pref && !pref->filled) {
+        block->num_issued++;
+        continue;
+      }
+
+      if(sent == FDIP_ISSUE_WIDTH)
+        return;
+      if(fdip->inflight >= FDIP_MAX_INFLIGHT) {
+        STAT_EVENT(proc_id, FDIP_PREF_THROTTLED);
+        return;
+      }
+
+      if(!new_mem_req(MRT_IPRF, proc_id, line_addr, ICACHE_LINE_SIZE, 0, NULL,
+                      icache_fill_line, unique_count, 0)) {
+        STAT_EVENT(proc_id, FDIP_PREF_REJECTED);
+        return;
+      }
+
+      DEBUG(proc_id, "FDIP prefetch of line 0x%s, FTQ block %d\n",
+            hexstr64s(line_addr), ii);
+      STAT_EVENT(proc_id, FDIP_PREF_SENT);
+      if(pref)
+        fdip_release_pref(fdip, pref);
+      fdip_add_pref(fdip, line_addr);
+      block->num_issued++;
+      sent++;
+    }
+  }
+}
+
+/**************************************************************************************/
+/* fdip_find_pref: */
+
+static Fdip_Pref* fdip_find_pref(Fdip* fdip, Addr line_addr) {
+  for(uns ii = 0; ii < fdip->num_prefs; ii++) {
+    Fdip_Pref* pref = &fdip->prefs[ii];
+    if(pref->valid && pref->line_addr == line_addr) {
+      if(!pref->filled && cycle_count > pref->issue_cycle + FDIP_PREF_TIMEOUT) {
+        fdip_release_pref(fdip, pref);
+        return NULL;
+      }
+      return pref;
+    }
+  }
+  return NULL;
+}
+
+/**************************************************************************************/
+/* fdip_add_pref: track a new prefetch, replacing the oldest filled one if
+   needed */
+
+static void fdip_add_pref(Fdip* fdip, Addr line_addr) {
+  Fdip_Pref* victim = NULL;
+
+  for(uns ii = 0; ii < fdip->num_prefs; ii++) {
+    Fdip_Pref* pref = &fdip->prefs[ii];
+    if(!pref->valid) {
+      victim = pref;
+      break;
+    }
+    if(pref->filled || cycle_count > pref->issue_cycle + FDIP_PREF_TIMEOUT) {
+      if(!victim || pref->issue_cycle < victim->issue_cycle)
+        victim = pref;
+    }
+  }
+  ASSERTM(0, victim, "FDIP prefetch tracker is full\n");
+
+  if(victim->valid)
+    fdip_release_pref(fdip, victim);
+  victim->valid       = TRUE;
+  victim->filled      = FALSE;
+  victim->demanded    = FALSE;
+  victim->line_addr   = line_addr;
+  victim->issue_cycle = cycle_count;
+  fdip->inflight++;
+}
+
+/**************************************************************************************/
+/* fdip_release_pref: */
+
+static void fdip_release_pref(Fdip* fdip, Fdip_Pref* pref) {
+  ASSERT(0, pref->valid);
+  if(!pref->filled) {
+    ASSERT(0, fdip->inflight > 0);
+    fdip->inflight--;
+  }
+  pref->valid = FALSE;
+}
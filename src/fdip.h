@@ -0,0 +1,56 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : fdip.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Fetch-directed instruction prefetching. A fetch target queue
+ *                of predicted fetch blocks runs ahead of the icache stage and
+ *                prefetches the icache lines of the queued blocks.
+ ***************************************************************************************/
+
+#ifndef __FDIP_H__
+#define __FDIP_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Initialize the fetch target queues of every core */
+void init_fdip(void);
+
+/* Run the block predictor ahead of the icache and issue prefetches for the
+   queued blocks. Call every core cycle after update_icache_stage. */
+void update_fdip(uns8 proc_id);
+
+/* Report an icache lookup of the fetch stage. Trains the fetch target buffer
+   and accounts prefetch usefulness. */
+void fdip_icache_access(uns8 proc_id, Addr fetch_addr, Flag hit,
+                        Flag off_path);
+
+/* Report an icache fill, which may complete an outstanding prefetch */
+void fdip_icache_fill(uns8 proc_id, Addr line_addr);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __FDIP_H__ */
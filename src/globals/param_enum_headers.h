@@ -37,5 +37,8 @@
 #include "dvfs/perf_pred.h"
 #include "frontend/frontend_intf.h"
 #include "memory/cache_part.h"
+#include "memory/coherence.h"
+#include "memory/interconnect.h"
+#include "smt.h"
 
 #endif  // __PARAM_ENUM_HEADERS_H__
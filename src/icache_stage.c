@@ -35,22 +35,27 @@
 #include "globals/utils.h"
 
 #include "bp/bp.h"
+#include "bp/bp_targ_mech.h"
 #include "icache_stage.h"
 #include "map.h"
 #include "op_pool.h"
 #include "packet_build.h"
 #include "thread.h"
+#include "uop_cache.h"
 
 #include "bp/bp.param.h"
 #include "cmp_model.h"
 #include "core.param.h"
 #include "debug/debug.param.h"
+#include "fdip.h"
 #include "frontend/frontend.h"
 #include "frontend/pin_trace_fe.h"
 #include "memory/memory.h"
 #include "memory/memory.param.h"
+#include "memory/tlb.h"
 #include "prefetcher/l2l1pref.h"
 #include "prefetcher/stream_pref.h"
+#include "smt.h"
 #include "statistics.h"
 
 
@@ -291,6 +296,15 @@ void update_icache_stage() {
     return;
   }
 
+  if(SMT_THREADS > 1 && ic->state == IC_FETCH &&
+     smt_fetch_blocked(ic->proc_id)) {
+    // another thread of the core owns the fetch stage this cycle
+    STAT_EVENT(ic->proc_id, FETCH_0_OPS);
+    STAT_EVENT(ic->proc_id, SMT_FETCH_LOST);
+    INC_STAT_EVENT(ic->proc_id, INST_LOST_WAIT_FOR_SMT_FETCH, ISSUE_WIDTH);
+    return;
+  }
+
   switch(ic->state) {
     case IC_FETCH: {
       Break_Reason break_fetch = BREAK_DONT;
@@ -313,6 +327,39 @@ void update_icache_stage() {
           ASSERTM(ic->proc_id, ic->fetch_addr, "ic fetch addr: %llu\n",
                   ic->fetch_addr);
 
+        Flag uop_cache_hit = FALSE;
+        if(UOP_CACHE_ENABLE) {
+          Flag switched;
+          uop_cache_hit = uop_cache_fetch(ic->proc_id, ic->fetch_addr,
+                                          &switched);
+          /* the uop cache and the decoders do not deliver in the same cycle */
+          if(switched && (ic->sd.op_count || UOP_CACHE_SWITCH_CYCLES)) {
+            break_fetch = BREAK_UOP_CACHE_SWITCH;
+            if(UOP_CACHE_SWITCH_CYCLES) {
+              ic->timer_cycle = cycle_count + UOP_CACHE_SWITCH_CYCLES;
+              ic->next_state  = IC_WAIT_FOR_TIMER;
+            }
+            continue;
+          }
+        }
+
+        /* the uop cache is virtually tagged, but a hit still needs the
+           translation for the fetched ops, so both paths access the ITLB */
+        if(TLB_ON && !tlb_translate(ic->proc_id, ic->fetch_addr, TRUE,
+                                    ic->off_path)) {
+          /* stay in IC_FETCH and retry once the translation is ready */
+          break_fetch = BREAK_ITLB_MISS;
+          continue;
+        }
+
+        if(uop_cache_hit) {
+          /* the block is fetched from the uop cache, not the icache */
+          if(FDIP_ON)
+            fdip_icache_access(ic->proc_id, ic->fetch_addr, TRUE, ic->off_path);
+          ic->next_state = icache_issue_ops(&break_fetch, &cf_num, NULL);
+          continue;
+        }
+
         ic->line = (Inst_Info**)cache_access(&ic->icache, ic->fetch_addr,
                                              &ic->line_addr, TRUE);
 
@@ -327,6 +374,10 @@ void update_icache_stage() {
         if(IC_PREF_CACHE_ENABLE && (!ic->line))
           ic->line = ic_pref_cache_access();
 
+        if(FDIP_ON)
+          fdip_icache_access(ic->proc_id, ic->fetch_addr, ic->line != NULL,
+                             ic->off_path);
+
 
         STAT_EVENT(ic->proc_id, POWER_ITLB_ACCESS);
         STAT_EVENT(ic->proc_id, POWER_ICACHE_ACCESS);
@@ -355,6 +406,7 @@ void update_icache_stage() {
           STAT_EVENT(ic->proc_id, ICACHE_MISS);
           STAT_EVENT(ic->proc_id, POWER_ICACHE_MISS);
           STAT_EVENT(ic->proc_id, ICACHE_MISS_ONPATH + ic->off_path);
+          bp_btb_ml_prefill(g_bp_data, ic->line_addr);
 
           /* if the icache is available, wait for a miss */
           /* otherwise, refetch next cycle */
@@ -410,6 +462,8 @@ void update_icache_stage() {
           ic->next_state = icache_issue_ops(&break_fetch, &cf_num, ic->line);
         }
       }
+      if(UOP_CACHE_ENABLE)
+        uop_cache_fetch_cycle(ic->proc_id, ic->sd.op_count);
       INC_STAT_EVENT(ic->proc_id, INST_LOST_BREAK_DONT + break_fetch,
                      ISSUE_WIDTH - ic->sd.op_count);
       STAT_EVENT(ic->proc_id, FETCH_0_OPS + ic->sd.op_count);
@@ -538,6 +592,14 @@ static inline Icache_State icache_issue_ops(Break_Reason* break_fetch,
     thread_map_mem_dep(op);
     op->fetch_cycle = cycle_count;
 
+    /* a uop cache block ends at a branch or at the end of its icache line;
+       end the packet with it so the next block is looked up first */
+    if(UOP_CACHE_ENABLE && uop_cache_fetch_op(ic->proc_id, op) &&
+       packet_break == PB_BREAK_DONT) {
+      packet_break = PB_BREAK_AFTER;
+      *break_fetch = op->table_info->cf_type ? BREAK_CF : BREAK_LINE_END;
+    }
+
     ic->sd.ops[ic->sd.op_count] = op; /* put op in the exit list */
     op_count[ic->proc_id]++;          /* increment instruction counters */
     unique_count_per_core[ic->proc_id]++;
@@ -648,6 +710,20 @@ static inline Icache_State icache_issue_ops(Break_Reason* break_fetch,
         return IC_WAIT_FOR_REDIRECT;
       }
 
+      /* if the target came from a slow btb level, wait out its bubbles */
+      if(op->oracle_info.pred && g_bp_data->btb_bubble &&
+         *break_fetch != BREAK_BARRIER) {
+        uns taken_bubble = FETCH_BREAK_ON_TAKEN ? FETCH_TAKEN_BUBBLE_CYCLES : 0;
+        uns bubble       = MAX2(g_bp_data->btb_bubble, taken_bubble);
+        *break_fetch     = BREAK_TAKEN;
+        ic->timer_cycle  = cycle_count + bubble;
+        /* only the cycles the btb level adds to a taken branch */
+        if(!op->off_path)
+          INC_STAT_EVENT(ic->proc_id, BTB_ML_BUBBLE_CYCLES,
+                         bubble - taken_bubble);
+        return IC_WAIT_FOR_TIMER;
+      }
+
       /* if it's a taken branch, wait for timer */
       if(FETCH_BREAK_ON_TAKEN && op->oracle_info.pred &&
          *break_fetch != BREAK_BARRIER) {
@@ -717,6 +793,8 @@ Flag icache_fill_line(Mem_Req* req)  // cmp FIXME maybe needed to be optimized
       line = (Inst_Info**)cache_insert(&ic->pref_icache, ic->proc_id,
                                        ic->fetch_addr, &pref_line_addr,
                                        &repl_line_addr);
+      if(FDIP_ON)
+        fdip_icache_fill(ic->proc_id, req->addr);
       DEBUG(
         ic->proc_id,
         "Insert PREF_ICACHE fetch_addr0x:%s line_addr:%s index:%ld addr:0x%s\n",
@@ -731,6 +809,8 @@ Flag icache_fill_line(Mem_Req* req)  // cmp FIXME maybe needed to be optimized
     ic->line = (Inst_Info**)cache_insert(&ic->icache, ic->proc_id,
                                          ic->fetch_addr, &ic->line_addr,
                                          &repl_line_addr);
+    if(FDIP_ON)
+      fdip_icache_fill(ic->proc_id, req->addr);
 
     STAT_EVENT(ic->proc_id, ICACHE_FILL);
 
@@ -759,6 +839,8 @@ Flag icache_fill_line(Mem_Req* req)  // cmp FIXME maybe needed to be optimized
 
       line = (Inst_Info**)cache_insert(&ic->pref_icache, ic->proc_id, req->addr,
                                        &pref_line_addr, &repl_line_addr);
+      if(FDIP_ON)
+        fdip_icache_fill(ic->proc_id, req->addr);
       DEBUG(
         ic->proc_id,
         "Insert PREF_ICACHE fetch_addr0x:%s line_addr:%s index:%ld addr:0x%s\n",
@@ -771,6 +853,8 @@ Flag icache_fill_line(Mem_Req* req)  // cmp FIXME maybe needed to be optimized
 
     line = (Inst_Info**)cache_insert(&ic->icache, ic->proc_id, req->addr,
                                      &dummy_addr, &repl_line_addr);
+    if(FDIP_ON)
+      fdip_icache_fill(ic->proc_id, req->addr);
 
     if(WP_COLLECT_STATS) {  // cmp IGNORE
       line_info = (Icache_Data*)cache_insert(&ic->icache_line_info, ic->proc_id,
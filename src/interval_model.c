@@ -0,0 +1,570 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : interval_model.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Interval-analysis core model. Ops come from the frontend in
+ *                program order and are dispatched ISSUE_WIDTH per cycle into a
+ *                NODE_TABLE_SIZE window. Each op finishes its latency after
+ *                its sources; loads and stores go through a per-core dcache
+ *                and the real memory system. Miss events (branch
+ *                mispredictions, icache misses, long-latency loads) stop
+ *                dispatch, and misses within one window overlap. No wrong
+ *                path is fetched.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+#include "statistics.h"
+
+#include "cmp_model.h"
+#include "freq.h"
+#include "frontend/frontend.h"
+#include "interval_model.h"
+#include "memory/coherence.h"
+#include "model.h"
+#include "op_pool.h"
+#include "sim.h"
+
+#include <string.h>
+
+#include "bp/bp.param.h"
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_INTERVAL_MODEL, ##args)
+
+/**************************************************************************************/
+/* Static prototypes */
+
+static Flag interval_fill(Mem_Req* req);
+
+/**************************************************************************************/
+/* Global variables */
+
+static uns mispred_penalty;   // cycles to refill the front end after recovery
+static uns misfetch_penalty;  // cycles to redirect fetch after decode
+
+/**************************************************************************************/
+/* interval_entry: the window slot of an op */
+
+static inline Interval_Entry* interval_entry(Interval_Core* core, Counter seq) {
+  return &core->window[seq % NODE_TABLE_SIZE];
+}
+
+/**************************************************************************************/
+/* interval_init */
+
+void interval_init(uns mode) {
+  /* like cmp, the real initialization is done in warmup (guaranteed to happen
+     once before switching into simulation mode) */
+  if(mode != WARMUP_MODE)
+    return;
+
+  if(COHERENCE_PROTOCOL != COHERENCE_NONE)
+    FATAL_ERROR(0, "The interval model does not support coherence\n");
+  freq_init();
+
+  mispred_penalty  = 1 + DECODE_CYCLES + MAP_CYCLES + EXTRA_RECOVERY_CYCLES;
+  misfetch_penalty = 1 + DECODE_CYCLES + EXTRA_REDIRECT_CYCLES;
+
+  interval_model.cores = calloc(NUM_CORES, sizeof(Interval_Core));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Interval_Core* core = &interval_model.cores[proc_id];
+    core->proc_id       = proc_id;
+    core->window        = calloc(NODE_TABLE_SIZE, sizeof(Interval_Entry));
+    core->pending       = calloc(NODE_TABLE_SIZE, sizeof(Counter));
+    core->miss_lines    = calloc(NODE_TABLE_SIZE, sizeof(Addr));
+    core->miss_dirty    = calloc(NODE_TABLE_SIZE, sizeof(Flag));
+    core->head_seq      = 1;  // 0 marks registers without a writer
+    core->tail_seq      = 1;
+    core->op.proc_id    = proc_id;
+    core->op.table_info = &core->table_info;
+    core->op.inst_info  = &core->inst_info;
+    core->op.mbp7_info  = NULL;
+    op_pool_init_op(&core->op);
+
+    init_cache(&core->icache, "ICACHE", ICACHE_SIZE, ICACHE_ASSOC,
+               ICACHE_LINE_SIZE, sizeof(Flag), REPL_TRUE_LRU);
+    init_cache(&core->dcache, "DCACHE", DCACHE_SIZE, DCACHE_ASSOC,
+               DCACHE_LINE_SIZE, sizeof(Flag), DCACHE_REPL);
+    init_bp_recovery_info(proc_id, &core->bp_recovery_info);
+    init_bp_data(proc_id, &core->bp_data);
+    op_count[proc_id] = 1;
+  }
+
+  set_memory(&interval_model.memory);
+  init_memory();
+}
+
+/**************************************************************************************/
+/* interval_reset: */
+
+void interval_reset() {
+  reset_memory();
+}
+
+/**************************************************************************************/
+/* interval_bp_op: predict and train the branch predictor in program order */
+
+static void interval_bp_op(Interval_Core* core, Op* op) {
+  Bp_Data* bp_data = &core->bp_data;
+  bp_predict_op(bp_data, op, 1, op->inst_info->addr);
+  bp_target_known_op(bp_data, op);
+  bp_resolve_op(bp_data, op);
+  if(op->oracle_info.mispred || op->oracle_info.misfetch)
+    bp_recover_op(bp_data, op->table_info->cf_type, &op->recovery_info);
+  bp_data->bp->retire_func(op);
+}
+
+/**************************************************************************************/
+/* interval_miss_line: index of a pending dcache line, num_miss_lines if none */
+
+static uns interval_miss_line(Interval_Core* core, Addr line_addr) {
+  uns ii;
+  for(ii = 0; ii < core->num_miss_lines; ii++) {
+    if(core->miss_lines[ii] == line_addr)
+      break;
+  }
+  return ii;
+}
+
+/**************************************************************************************/
+/* interval_dcache_miss: send a dcache miss to the memory system unless the
+ * line is already on its way. Returns FALSE if it has to be retried. */
+
+static Flag interval_dcache_miss(Interval_Core* core, Mem_Req_Type type,
+                                 Addr line_addr) {
+  uns idx = interval_miss_line(core, line_addr);
+  if(idx < core->num_miss_lines) {
+    core->miss_dirty[idx] |= type == MRT_DSTORE;  // fill it dirty
+    return TRUE;
+  }
+  if(core->num_miss_lines == NODE_TABLE_SIZE ||
+     !new_mem_req(type, core->proc_id, line_addr, DCACHE_LINE_SIZE,
+                  DCACHE_CYCLES - 1, NULL, interval_fill, unique_count, NULL))
+    return FALSE;
+  unique_count++;
+  core->miss_lines[idx] = line_addr;
+  core->miss_dirty[idx] = type == MRT_DSTORE;
+  core->num_miss_lines++;
+  STAT_EVENT(core->proc_id, INTERVAL_DCACHE_MISS);
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* interval_resolve: compute an op's finish time once its sources are done */
+
+static void interval_resolve(Interval_Core* core, Interval_Entry* entry) {
+  Counter ready = entry->done_cycle;
+  for(uns ii = 0; ii < entry->num_srcs; ii++) {
+    if(entry->src_seq[ii] < core->head_seq)
+      continue;  // producer already retired
+    Interval_Entry* src = interval_entry(core, entry->src_seq[ii]);
+    if(src->state != IV_DONE)
+      return;
+    ready = MAX2(ready, src->done_cycle);
+  }
+
+  entry->done_cycle = ready;
+  if(entry->mem_type == MEM_LD) {
+    entry->state = IV_WAIT_ISSUE;
+    return;
+  }
+  entry->state = IV_DONE;
+  entry->done_cycle += entry->latency;
+  if(entry->seq == core->mispred_seq) {
+    // the front end restarts on the correct path once the branch resolves
+    core->mispred_seq       = 0;
+    core->fetch_ready_cycle = entry->done_cycle + mispred_penalty;
+    core->fetch_stall_stat  = INTERVAL_STALL_BRANCH;
+  }
+}
+
+/**************************************************************************************/
+/* interval_load: access the dcache for a load whose address is ready */
+
+static void interval_load(Interval_Core* core, Interval_Entry* entry) {
+  Addr line_addr;
+  if(cache_access(&core->dcache, entry->va, &line_addr, TRUE)) {
+    entry->state      = IV_DONE;
+    entry->done_cycle = cycle_count + DCACHE_CYCLES;
+  } else if(interval_dcache_miss(core, MRT_DFETCH, line_addr)) {
+    entry->state = IV_WAIT_MEM;
+  } else {
+    return;  // no miss buffer, retry next cycle
+  }
+  STAT_EVENT(core->proc_id, INTERVAL_DCACHE_ACCESS);
+}
+
+/**************************************************************************************/
+/* interval_fill: done_func of every request sent by the interval model */
+
+static Flag interval_fill(Mem_Req* req) {
+  Interval_Core* core    = &interval_model.cores[req->proc_id];
+  uns            proc_id = core->proc_id;
+  Addr           line_addr;
+  Addr           repl_line_addr;
+
+  if(core->icache_miss &&
+     (req->addr & ~(Addr)(ICACHE_LINE_SIZE - 1)) == core->fetch_line) {
+    cache_insert(&core->icache, proc_id, core->fetch_line, &line_addr,
+                 &repl_line_addr);
+    core->icache_miss = FALSE;
+  }
+
+  Addr dc_line = req->addr & ~(Addr)(DCACHE_LINE_SIZE - 1);
+  uns  idx     = interval_miss_line(core, dc_line);
+  if(idx == core->num_miss_lines)
+    return TRUE;
+
+  Flag  repl_line_valid;
+  Flag* dirty = get_next_repl_line(&core->dcache, proc_id, dc_line,
+                                   &repl_line_addr, &repl_line_valid);
+  if(repl_line_valid && *dirty &&
+     !new_mem_dc_wb_req(MRT_WB, get_proc_id_from_cmp_addr(repl_line_addr),
+                        repl_line_addr, DCACHE_LINE_SIZE, 1, NULL, NULL,
+                        unique_count, TRUE))
+    return FALSE;  // the memory system calls us again
+  dirty  = cache_insert(&core->dcache, proc_id, dc_line, &line_addr,
+                        &repl_line_addr);
+  *dirty = core->miss_dirty[idx];
+
+  core->num_miss_lines--;
+  core->miss_lines[idx] = core->miss_lines[core->num_miss_lines];
+  core->miss_dirty[idx] = core->miss_dirty[core->num_miss_lines];
+
+  Counter done_cycle = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]) + 1;
+  for(uns ii = 0; ii < core->num_pending; ii++) {
+    Interval_Entry* entry = interval_entry(core, core->pending[ii]);
+    if(entry->state == IV_WAIT_MEM &&
+       (entry->va & ~(Addr)(DCACHE_LINE_SIZE - 1)) == dc_line) {
+      entry->state      = IV_DONE;
+      entry->done_cycle = done_cycle;
+    }
+  }
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* interval_retire: retire finished ops in order; stores write the dcache */
+
+static void interval_retire(Interval_Core* core) {
+  uns proc_id = core->proc_id;
+  for(uns ii = 0; ii < NODE_RET_WIDTH && core->head_seq < core->tail_seq;
+      ii++) {
+    Interval_Entry* entry = interval_entry(core, core->head_seq);
+    if(entry->state != IV_DONE || entry->done_cycle > cycle_count)
+      break;
+
+    if(entry->mem_type == MEM_ST) {
+      Addr  line_addr;
+      Flag* dirty = cache_access(&core->dcache, entry->va, &line_addr, TRUE);
+      if(dirty)
+        *dirty = TRUE;
+      else if(!interval_dcache_miss(core, MRT_DSTORE, line_addr))
+        break;
+      STAT_EVENT(proc_id, INTERVAL_DCACHE_ACCESS);
+    }
+
+    if(entry->eom) {
+      inst_count[proc_id]++;
+      STAT_EVENT(proc_id, NODE_INST_COUNT);
+      if(entry->exit) {
+        retired_exit[proc_id] = TRUE;
+        frontend_retire(proc_id, -1);
+      } else if(entry->frontend_retire ||
+                inst_count[proc_id] % NODE_RETIRE_RATE == 0) {
+        frontend_retire(proc_id, entry->inst_uid);
+      }
+    }
+    uop_count[proc_id]++;
+    STAT_EVENT(proc_id, NODE_UOP_COUNT);
+    core->head_seq++;
+  }
+}
+
+/**************************************************************************************/
+/* interval_issue: resolve ops whose sources finished and start ready loads */
+
+static void interval_issue(Interval_Core* core) {
+  uns kept = 0;
+  for(uns ii = 0; ii < core->num_pending; ii++) {
+    Interval_Entry* entry = interval_entry(core, core->pending[ii]);
+    if(entry->state == IV_WAIT_SRC)
+      interval_resolve(core, entry);
+    if(entry->state == IV_WAIT_ISSUE && entry->done_cycle <= cycle_count)
+      interval_load(core, entry);
+    if(entry->state != IV_DONE)
+      core->pending[kept++] = entry->seq;
+  }
+  core->num_pending = kept;
+}
+
+/**************************************************************************************/
+/* interval_dispatch_op: put an op into the window */
+
+static void interval_dispatch_op(Interval_Core* core, Op* op) {
+  Interval_Entry* entry = interval_entry(core, core->tail_seq);
+  memset(entry, 0, sizeof(Interval_Entry));
+  entry->seq        = core->tail_seq++;
+  entry->state      = IV_WAIT_SRC;
+  entry->done_cycle = cycle_count + 1;  // earliest issue
+  entry->latency    = op->inst_info->latency < 0 ? -op->inst_info->latency :
+                                                   op->inst_info->latency;
+  entry->eom        = op->eom;
+  entry->exit       = op->exit;
+  entry->inst_uid   = op->inst_uid;
+
+  entry->frontend_retire = IS_CALLSYS(op->table_info) ||
+                           op->table_info->bar_type & BAR_FETCH;
+
+  if(op->table_info->mem_type == MEM_LD || op->table_info->mem_type == MEM_ST) {
+    if(op->oracle_info.va == 0)
+      FATAL_ERROR(core->proc_id, "Access to 0x0\n");
+    entry->mem_type = op->table_info->mem_type;
+    entry->va       = op->oracle_info.va;
+  }
+
+  for(uns ii = 0; ii < op->table_info->num_src_regs; ii++) {
+    Counter src_seq = core->reg_seq[op->inst_info->srcs[ii].id];
+    if(src_seq >= core->head_seq)
+      entry->src_seq[entry->num_srcs++] = src_seq;
+  }
+  for(uns ii = 0; ii < op->table_info->num_dest_regs; ii++)
+    core->reg_seq[op->inst_info->dests[ii].id] = entry->seq;
+
+  if(op->table_info->cf_type) {
+    interval_bp_op(core, op);
+    if(op->oracle_info.mispred) {
+      STAT_EVENT(core->proc_id, INTERVAL_MISPRED);
+      core->mispred_seq = entry->seq;
+    } else if(op->oracle_info.misfetch) {
+      STAT_EVENT(core->proc_id, INTERVAL_MISFETCH);
+      core->fetch_ready_cycle = cycle_count + misfetch_penalty;
+      core->fetch_stall_stat  = INTERVAL_STALL_BRANCH;
+    }
+  }
+
+  DEBUG(core->proc_id, "Dispatching op_num:%s seq:%s\n",
+        unsstr64(op->op_num), unsstr64(entry->seq));
+  interval_resolve(core, entry);
+  if(entry->state != IV_DONE)
+    core->pending[core->num_pending++] = entry->seq;
+}
+
+/**************************************************************************************/
+/* interval_fetch_line: access the icache when fetch moves to a new line.
+ * Returns FALSE while the line is missing. */
+
+static Flag interval_fetch_line(Interval_Core* core, Addr addr) {
+  Addr line_addr = addr & ~(Addr)(ICACHE_LINE_SIZE - 1);
+  Addr dummy_line_addr;
+  if(line_addr == core->fetch_line)
+    return !core->icache_miss;
+  if(cache_access(&core->icache, line_addr, &dummy_line_addr, TRUE)) {
+    core->fetch_line = line_addr;
+    return TRUE;
+  }
+  if(new_mem_req(MRT_IFETCH, core->proc_id, line_addr, ICACHE_LINE_SIZE, 0,
+                 NULL, interval_fill, unique_count, NULL)) {
+    unique_count++;
+    core->fetch_line  = line_addr;
+    core->icache_miss = TRUE;
+    STAT_EVENT(core->proc_id, INTERVAL_ICACHE_MISS);
+  }
+  return FALSE;
+}
+
+/**************************************************************************************/
+/* interval_dispatch: fetch and dispatch up to ISSUE_WIDTH ops, charging the
+ * cycle to whatever stops dispatch */
+
+static void interval_dispatch(Interval_Core* core) {
+  uns proc_id = core->proc_id;
+  uns stall   = 0;
+  for(uns ii = 0; ii < ISSUE_WIDTH && !stall; ii++) {
+    if(core->mispred_seq) {
+      stall = INTERVAL_STALL_BRANCH;
+    } else if(cycle_count < core->fetch_ready_cycle) {
+      stall = core->fetch_stall_stat;
+    } else if(core->tail_seq - core->head_seq == NODE_TABLE_SIZE) {
+      Interval_Entry* head = interval_entry(core, core->head_seq);
+      stall = head->state == IV_WAIT_MEM ? INTERVAL_STALL_WINDOW_MEM :
+                                           INTERVAL_STALL_WINDOW;
+    } else if(!core->op_valid && !frontend_can_fetch_op(proc_id)) {
+      stall = INTERVAL_STALL_FRONTEND;
+    } else {
+      if(!core->op_valid) {
+        /* the op is reused, so reset it the way the op pool would */
+        op_pool_setup_op(proc_id, &core->op);
+        frontend_fetch_op(proc_id, &core->op);
+        op_count[proc_id]++;
+        unique_count_per_core[proc_id]++;
+        unique_count++;
+        core->op_valid = TRUE;
+      }
+      if(!interval_fetch_line(core, core->op.inst_info->addr)) {
+        stall = INTERVAL_STALL_ICACHE;
+      } else {
+        interval_dispatch_op(core, &core->op);
+        core->op_valid = FALSE;
+      }
+    }
+    if(stall && ii == 0)
+      STAT_EVENT(proc_id, stall);
+  }
+}
+
+/**************************************************************************************/
+/* interval_cycle: */
+
+void interval_cycle() {
+  update_memory();
+
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if(DUMB_CORE_ON && DUMB_CORE == proc_id)
+      continue;
+    if(!freq_is_ready(FREQ_DOMAIN_CORES[proc_id]))
+      continue;
+    cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+
+    Interval_Core* core = &interval_model.cores[proc_id];
+    set_bp_data(&core->bp_data);
+    set_bp_recovery_info(&core->bp_recovery_info);
+    STAT_EVENT(proc_id, NODE_CYCLE);
+
+    interval_retire(core);
+    interval_issue(core);
+    interval_dispatch(core);
+  }
+}
+
+/**************************************************************************************/
+/* interval_debug: */
+
+void interval_debug() {
+  debug_memory();
+}
+
+/**************************************************************************************/
+/* interval_validate: compare the CPI of this core against the core stats of a
+ * cmp run of the same configuration in INTERVAL_VALIDATE_DIR */
+
+static void interval_validate(uns8 proc_id) {
+  char file_name[MAX_STR_LENGTH + 1];
+  snprintf(file_name, MAX_STR_LENGTH, "%s/%score.stat.%u.out",
+           INTERVAL_VALIDATE_DIR, FILE_TAG, proc_id);
+  FILE* file = fopen(file_name, "r");
+  if(!file)
+    FATAL_ERROR(proc_id, "Could not open reference stats %s\n", file_name);
+
+  Counter ref_cycles = 0;
+  Counter ref_insts  = 0;
+  char    buf[MAX_STR_LENGTH + 1];
+  char    name[MAX_STR_LENGTH + 1];
+  while(fgets(buf, MAX_STR_LENGTH, file)) {
+    unsigned long long count;
+    if(sscanf(buf, "%s %llu", name, &count) != 2)
+      continue;
+    if(!strcmp(name, "NODE_CYCLE"))
+      ref_cycles = count;
+    else if(!strcmp(name, "NODE_INST_COUNT"))
+      ref_insts = count;
+  }
+  fclose(file);
+
+  Counter cycles = GET_STAT_EVENT(proc_id, NODE_CYCLE);
+  Counter insts  = GET_STAT_EVENT(proc_id, NODE_INST_COUNT);
+  if(!ref_cycles || !ref_insts || !insts)
+    FATAL_ERROR(proc_id, "No cycles or instructions to compare in %s\n",
+                file_name);
+  INC_STAT_EVENT(proc_id, INTERVAL_REF_CYCLES, ref_cycles);
+  INC_STAT_EVENT(proc_id, INTERVAL_REF_INST_COUNT, ref_insts);
+
+  double cpi     = (double)cycles / insts;
+  double ref_cpi = (double)ref_cycles / ref_insts;
+  double error   = 100.0 * (cpi - ref_cpi) / ref_cpi;
+  INC_STAT_VALUE(proc_id, INTERVAL_CPI_ERROR, error);
+  fprintf(mystdout,
+          "** Core %u interval CPI: %.3f  cmp CPI: %.3f  error: %+.2f%%\n",
+          proc_id, cpi, ref_cpi, error);
+}
+
+/**************************************************************************************/
+/* interval_per_core_done: */
+
+void interval_per_core_done(uns8 proc_id) {
+  stats_per_core_collect(proc_id);
+  if(INTERVAL_VALIDATE_DIR)
+    interval_validate(proc_id);
+}
+
+/**************************************************************************************/
+/* interval_done: */
+
+void interval_done() {
+  finalize_memory();
+}
+
+/**************************************************************************************/
+/* interval_warmup_cache: warm one of the core's caches and the uncore below */
+
+static void interval_warmup_cache(Cache* cache, uns proc_id, Addr addr,
+                                  Flag write) {
+  Addr  line_addr;
+  Addr  repl_line_addr;
+  Flag* dirty = cache_access(cache, addr, &line_addr, TRUE);
+  if(!dirty) {
+    warmup_uncore(proc_id, addr, FALSE);
+    dirty = cache_insert(cache, proc_id, addr, &line_addr, &repl_line_addr);
+    if(*dirty)
+      warmup_uncore(proc_id, repl_line_addr, TRUE);
+    *dirty = FALSE;
+  }
+  *dirty |= write;
+}
+
+/**************************************************************************************/
+/* interval_warmup: warm up the caches and the branch predictor */
+
+void interval_warmup(Op* op) {
+  Interval_Core* core = &interval_model.cores[op->proc_id];
+  interval_warmup_cache(&core->icache, op->proc_id, op->inst_info->addr,
+                        FALSE);
+  if(op->table_info->mem_type == MEM_LD || op->table_info->mem_type == MEM_ST)
+    interval_warmup_cache(&core->dcache, op->proc_id, op->oracle_info.va,
+                          op->table_info->mem_type == MEM_ST);
+  if(op->table_info->cf_type)
+    interval_bp_op(core, op);
+}
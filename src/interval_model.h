@@ -0,0 +1,121 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : interval_model.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Interval-analysis core model: consumes the frontend op stream,
+ *                drives the real branch predictor, caches and memory system,
+ *                but estimates core timing from dispatch width, dependences
+ *                and miss events overlapped within the window
+ ***************************************************************************************/
+
+#ifndef __INTERVAL_MODEL_H__
+#define __INTERVAL_MODEL_H__
+
+#include "bp/bp.h"
+#include "isa/isa_macros.h"
+#include "libs/cache_lib.h"
+#include "memory/memory.h"
+#include "op.h"
+
+/**************************************************************************************/
+/* Types */
+
+typedef enum Interval_State_enum {
+  IV_WAIT_SRC,    // a source has not finished yet
+  IV_WAIT_ISSUE,  // load with a ready address, waiting to access the dcache
+  IV_WAIT_MEM,    // load that missed the dcache, waiting for the fill
+  IV_DONE,        // finishes at done_cycle
+} Interval_State;
+
+typedef struct Interval_Entry_struct {
+  Counter        seq;
+  Interval_State state;
+  Counter        done_cycle;  // ready cycle while IV_WAIT_ISSUE
+  Counter        src_seq[MAX_SRCS];
+  uns            num_srcs;
+  uns            latency;
+  Mem_Type       mem_type;
+  Addr           va;
+  Flag           eom;
+  Flag           exit;
+  Flag           frontend_retire;  // frontend must hear about this retire
+  uns64          inst_uid;
+} Interval_Entry;
+
+typedef struct Interval_Core_struct {
+  uns proc_id;
+
+  /* instruction window, indexed by seq % NODE_TABLE_SIZE */
+  Interval_Entry* window;
+  Counter         head_seq;              // oldest op in the window
+  Counter         tail_seq;              // seq of the next op to dispatch
+  Counter         reg_seq[NUM_REG_IDS];  // last writer of each register
+  Counter*        pending;  // seqs of ops not yet IV_DONE, oldest first
+  uns             num_pending;
+  Addr*           miss_lines;  // dcache lines this core is waiting for
+  Flag*           miss_dirty;  // a store is waiting for the miss line
+  uns             num_miss_lines;
+
+  /* front end */
+  Op         op;  // next op, fetched but not yet dispatched
+  Table_Info table_info;
+  Inst_Info  inst_info;
+  Flag       op_valid;
+  Addr       fetch_line;         // icache line of the last dispatched op
+  Flag       icache_miss;        // waiting for fetch_line to fill
+  Counter    mispred_seq;        // dispatch waits for this branch (0: none)
+  Counter    fetch_ready_cycle;  // no dispatch before this cycle
+  uns        fetch_stall_stat;   // stat charged until fetch_ready_cycle
+
+  Cache            icache;
+  Cache            dcache;
+  Bp_Data          bp_data;
+  Bp_Recovery_Info bp_recovery_info;
+} Interval_Core;
+
+typedef struct Interval_Model_struct {
+  Memory         memory;
+  Interval_Core* cores;
+} Interval_Model;
+
+/**************************************************************************************/
+/* Global vars */
+
+Interval_Model        interval_model;
+extern Interval_Model interval_model;
+
+/**************************************************************************************/
+/* Prototypes */
+
+void interval_init(uns mode);
+void interval_reset(void);
+void interval_cycle(void);
+void interval_debug(void);
+void interval_per_core_done(uns8);
+void interval_done(void);
+void interval_warmup(Op*);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __INTERVAL_MODEL_H__ */
@@ -0,0 +1,204 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/stack_dist.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : LRU stack distance (reuse distance) of cache line accesses,
+ *                computed incrementally in O(log n) per access.
+ ***************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/utils.h"
+
+#include "libs/stack_dist.h"
+
+/*
+   Every access gets the next timestamp. The Fenwick tree holds a one at the
+   timestamp of the most recent access of each tracked line, so the stack
+   distance of a line is the number of ones after its previous timestamp.
+   When the timestamps run out, the live ones are renumbered from zero,
+   which costs O(max_lines) once every max_lines accesses or more. When more
+   than max_lines lines are tracked, the least recently used one is dropped.
+*/
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void stack_dist_add(Stack_Dist* sd, uns time, int delta);
+static uns  stack_dist_prefix(Stack_Dist* sd, uns time);
+static void stack_dist_evict(Stack_Dist* sd);
+static void stack_dist_compact(Stack_Dist* sd);
+static Flag stack_dist_seen(Stack_Dist* sd, Addr line);
+
+/**************************************************************************************/
+/* init_stack_dist: */
+
+void init_stack_dist(Stack_Dist* sd, const char* name, uns max_lines,
+                     uns seen_bits) {
+  ASSERT(0, max_lines > 0);
+  ASSERT(0, seen_bits >= 3 && seen_bits < 32);
+
+  sd->name      = strdup(name);
+  sd->max_lines = max_lines;
+  sd->size      = 2 * max_lines;
+  sd->now       = 0;
+  sd->oldest    = 0;
+  sd->count     = 0;
+  sd->tree      = (uns*)calloc(sd->size + 1, sizeof(uns));
+  sd->lines     = (Addr*)calloc(sd->size, sizeof(Addr));
+  sd->live      = (Flag*)calloc(sd->size, sizeof(Flag));
+  sd->seen      = (uns8*)calloc(1 << (seen_bits - 3), sizeof(uns8));
+  sd->seen_bits = seen_bits;
+  init_hash_table(&sd->times, name, sd->size + 1, sizeof(uns));
+}
+
+/**************************************************************************************/
+/* stack_dist_add: */
+
+static void stack_dist_add(Stack_Dist* sd, uns time, int delta) {
+  for(uns ii = time + 1; ii <= sd->size; ii += ii & -ii)
+    sd->tree[ii] += delta;
+}
+
+/**************************************************************************************/
+/* stack_dist_prefix: number of live timestamps before time */
+
+static uns stack_dist_prefix(Stack_Dist* sd, uns time) {
+  uns sum = 0;
+  for(uns ii = time; ii > 0; ii -= ii & -ii)
+    sum += sd->tree[ii];
+  return sum;
+}
+
+/**************************************************************************************/
+/* stack_dist_evict: stop tracking the least recently used line */
+
+static void stack_dist_evict(Stack_Dist* sd) {
+  while(!sd->live[sd->oldest])
+    sd->oldest++;
+  ASSERT(0, sd->oldest < sd->now);
+
+  hash_table_access_delete(&sd->times, sd->lines[sd->oldest]);
+  sd->live[sd->oldest] = FALSE;
+  stack_dist_add(sd, sd->oldest, -1);
+  sd->count--;
+}
+
+/**************************************************************************************/
+/* stack_dist_compact: renumber the live timestamps from zero */
+
+static void stack_dist_compact(Stack_Dist* sd) {
+  uns next = 0;
+
+  for(uns ii = 0; ii < sd->now; ii++) {
+    if(!sd->live[ii])
+      continue;
+    uns* stamp = (uns*)hash_table_access(&sd->times, sd->lines[ii]);
+    ASSERT(0, stamp && *stamp == ii);
+    *stamp           = next;
+    sd->lines[next]  = sd->lines[ii];
+    sd->live[next++] = TRUE;
+  }
+  memset(&sd->live[next], 0, (sd->size - next) * sizeof(Flag));
+  memset(sd->tree, 0, (sd->size + 1) * sizeof(uns));
+  for(uns ii = 0; ii < next; ii++)
+    stack_dist_add(sd, ii, 1);
+
+  sd->now    = next;
+  sd->oldest = 0;
+}
+
+/**************************************************************************************/
+/* stack_dist_seen: returns TRUE if the line may have been accessed before,
+   and records it */
+
+static Flag stack_dist_seen(Stack_Dist* sd, Addr line) {
+  uns64 h1   = (line * 0x9E3779B97F4A7C15ULL) >> (64 - sd->seen_bits);
+  uns64 h2   = (line * 0xC2B2AE3D27D4EB4FULL) >> (64 - sd->seen_bits);
+  Flag  seen = TESTBIT(sd->seen[h1 >> 3], h1 & 7) &&
+              TESTBIT(sd->seen[h2 >> 3], h2 & 7);
+
+  SETBIT(sd->seen[h1 >> 3], h1 & 7);
+  SETBIT(sd->seen[h2 >> 3], h2 & 7);
+  return seen;
+}
+
+/**************************************************************************************/
+/* stack_dist_access: */
+
+uns stack_dist_access(Stack_Dist* sd, Addr line) {
+  uns* stamp = (uns*)hash_table_access(&sd->times, line);
+  uns  dist;
+
+  if(stamp) {
+    dist = stack_dist_prefix(sd, sd->now) - stack_dist_prefix(sd, *stamp + 1);
+    sd->live[*stamp] = FALSE;
+    stack_dist_add(sd, *stamp, -1);
+  } else {
+    Flag new_entry;
+    dist = stack_dist_seen(sd, line) ? STACK_DIST_FAR : STACK_DIST_COLD;
+    if(sd->count == sd->max_lines)
+      stack_dist_evict(sd);
+    stamp = (uns*)hash_table_access_create(&sd->times, line, &new_entry);
+    ASSERT(0, new_entry);
+    sd->count++;
+  }
+
+  if(sd->now == sd->size)
+    stack_dist_compact(sd);
+
+  *stamp              = sd->now;
+  sd->lines[sd->now]  = line;
+  sd->live[sd->now++] = TRUE;
+  stack_dist_add(sd, *stamp, 1);
+  return dist;
+}
+
+/**************************************************************************************/
+/* stack_dist_line: descend the Fenwick tree to the live timestamp with
+   count - dist live timestamps up to and including it */
+
+Flag stack_dist_line(Stack_Dist* sd, uns dist, Addr* line) {
+  uns rank = sd->count - dist;
+  uns pos  = 0;
+  uns step = 1;
+
+  if(dist >= sd->count)
+    return FALSE;
+  while(step * 2 <= sd->size)
+    step *= 2;
+  for(; step; step >>= 1) {
+    if(pos + step <= sd->size && sd->tree[pos + step] < rank) {
+      pos += step;
+      rank -= sd->tree[pos];
+    }
+  }
+
+  ASSERT(0, pos < sd->now && sd->live[pos]);
+  *line = sd->lines[pos];
+  return TRUE;
+}
@@ -0,0 +1,83 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/stack_dist.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : LRU stack distance (reuse distance) of cache line accesses,
+ *                computed incrementally in O(log n) per access.
+ ***************************************************************************************/
+
+#ifndef __STACK_DIST_H__
+#define __STACK_DIST_H__
+
+#include "globals/global_defs.h"
+#include "libs/hash_lib.h"
+
+/**************************************************************************************/
+/* Defines */
+
+#define STACK_DIST_COLD ((uns)-1) /* first access to the line */
+#define STACK_DIST_FAR ((uns)-2)  /* deeper than the tracked lines */
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Stack_Dist_struct {
+  char*      name;
+  uns        max_lines; /* lines tracked in the LRU stack */
+  uns        size;      /* number of timestamps before a compaction */
+  uns        now;       /* next timestamp */
+  uns        oldest;    /* no tracked line was accessed before this time */
+  uns        count;     /* lines currently tracked */
+  uns*       tree;      /* Fenwick tree over the timestamps, 1 where a
+                           tracked line was last accessed */
+  Addr*      lines;     /* line accessed at each timestamp */
+  Flag*      live;      /* timestamp is the last access of a tracked line */
+  Hash_Table times;     /* line -> timestamp of its last access */
+  uns8*      seen;      /* bit filter of the lines ever accessed */
+  uns        seen_bits; /* log2 of the number of bits in the filter */
+} Stack_Dist;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Track up to max_lines distinct lines. Lines deeper in the stack are
+   reported as STACK_DIST_FAR. First accesses are detected with a filter of
+   2^seen_bits bits, which may report a few of them as STACK_DIST_FAR once
+   the footprint approaches the filter size. */
+void init_stack_dist(Stack_Dist* sd, const char* name, uns max_lines,
+                     uns seen_bits);
+
+/* Access a line and return its stack distance: the number of distinct lines
+   accessed since its last access. A fully-associative LRU cache of n lines
+   hits exactly when the distance is less than n. */
+uns stack_dist_access(Stack_Dist* sd, Addr line);
+
+/* Find the tracked line at the given stack distance (0 is the most recently
+   accessed one) without accessing it. Returns FALSE if fewer lines are
+   tracked. */
+Flag stack_dist_line(Stack_Dist* sd, uns dist, Addr* line);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __STACK_DIST_H__ */
@@ -36,6 +36,7 @@
 
 #include "map.h"
 #include "model.h"
+#include "op_pool.h"
 #include "thread.h"
 
 #include "core.param.h"
@@ -45,6 +46,8 @@
 #include "cmp_model.h"
 #include "libs/hash_lib.h"
 #include "statistics.h"
+#include "store_sets.h"
+#include "value_pred.h"
 
 /**************************************************************************************/
 /* Macros */
@@ -52,28 +55,37 @@
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_MAP, ##args)
 #define DEBUGU(proc_id, args...) _DEBUGU(proc_id, DEBUG_MAP, ##args)
 
-#define WAKE_UP_ENTRIES_INC 256 /* default 256 */
+#define WAKE_UP_OVERFLOW_INC 256 /* default 256 */
 #define MEM_ADDR_SRC \
   0 /* address for memory instructions calculated off source 0 */
 
-#define MEM_MAP_ENTRY_SIZE_LOG 3
+/* one memory map entry per line; byte masks are 64 bits wide */
+#define MEM_MAP_ENTRY_SIZE_LOG 6
 #define MEM_MAP_ENTRY_SIZE (1 << MEM_MAP_ENTRY_SIZE_LOG)
 #define MEM_MAP_BYTE_IN_ENTRY(va) ((va) & (MEM_MAP_ENTRY_SIZE - 1))
 #define MEM_MAP_ENTRY_ADDR(va) ((va) & ~(Addr)(MEM_MAP_ENTRY_SIZE - 1))
 
 #define MEM_MAP_KEY(va) ((va) >> MEM_MAP_ENTRY_SIZE_LOG)
-#define MEM_MAP_BYTE_INDEX(byte, off_path) \
-  ((byte) + ((off_path) ? MEM_MAP_ENTRY_SIZE : 0))
+#define MEM_MAP_RECORDS_INC 4
 
 /**************************************************************************************/
 /* Types */
 
+typedef struct Store_Record_struct {
+  Op*     op;        /* in-flight store */
+  Counter op_num;    /* op number of the store (for trimming on recovery) */
+  uns64   byte_mask; /* bytes of the entry written by the store */
+  Flag    off_path;  /* which half of the map the store was written to */
+} Store_Record;
+
+/* The stores that wrote a line, in the order they were written to the map.
+   Each byte reads from the last record of the half selected by its offpath
+   flag that covers it. */
 typedef struct Mem_Map_Entry_struct {
-  Op* op[2 * MEM_MAP_ENTRY_SIZE]; /* last op to write (invalid when committed),
-                                   * first half onpath, second half offpath*/
-  uns flag_mask;                  /* offpath flags, one per byte */
-  uns store_mask;                 /* shows position of all distinct stores
-                                   * supplying a partial value to this map entry */
+  uns64         flag_mask; /* offpath flags, one per byte */
+  Store_Record* records;
+  uns           num_records;
+  uns           max_records;
 } Mem_Map_Entry;
 
 /* Data structure for easy traversal of memory map hash given an
@@ -88,6 +100,17 @@ typedef struct Mem_Map_Traversal_struct {
   uns  last_entry_last_byte;
 } Mem_Map_Traversal;
 
+/* Per-core wake up list storage. lists[] is indexed by the producer's
+   op_pool_id and grows with the op pool. Chunk 0 of overflow[] is never handed
+   out so that 0 can mean "no chunk". */
+typedef struct Wake_Up_Arena_struct {
+  Wake_Up_Chunk* lists;
+  uns            num_lists;
+  Wake_Up_Chunk* overflow;
+  uns            num_overflow;
+  uns            overflow_free; /* head of the free overflow chunks */
+} Wake_Up_Arena;
+
 /**************************************************************************************/
 /* External variables */
 
@@ -99,6 +122,8 @@ extern Op invalid_op;
 
 Map_Data* map_data = NULL;
 
+static Wake_Up_Arena* wake_up_arenas = NULL;
+
 const char* const dep_type_names[NUM_DEP_TYPES] = {
   "REG_DATA",
   "MEM_ADDR",
@@ -112,11 +137,15 @@ static inline void read_reg_map(Op*);
 static inline void read_store_map(Op*);
 static inline void update_map(Op*);
 
-static inline void expand_wake_up_entries(void);
+static inline void expand_wake_up_lists(Wake_Up_Arena*, uns);
+static inline void expand_wake_up_overflow(Wake_Up_Arena*);
 static inline void update_store_hash(Op* op);
 static inline Op*  add_store_deps(Op* op);
 static inline void update_map_entry(Op* op, Map_Entry* map_entry);
 static inline void recover_mem_map_entry(void* hash_entry, void* arg);
+static inline uns64 mem_map_traversal_mask(Mem_Map_Traversal* traversal);
+
+static inline Wake_Up_Entry* alloc_wake_up_entry(Op*);
 
 /* memory map hash traversal */
 static inline void mem_map_entry_traversal_init(Mem_Map_Traversal* traversal,
@@ -124,8 +153,6 @@ static inline void mem_map_entry_traversal_init(Mem_Map_Traversal* traversal,
 static inline Flag mem_map_entry_traversal_done(Mem_Map_Traversal* traversal);
 static inline void mem_map_entry_traversal_next(Mem_Map_Traversal* traversal);
 static inline void mem_map_byte_traversal_init(Mem_Map_Traversal* traversal);
-static inline Flag mem_map_byte_traversal_done(Mem_Map_Traversal* traversal);
-static inline void mem_map_byte_traversal_next(Mem_Map_Traversal* traversal);
 
 /**************************************************************************************/
 /* set_map_data: */
@@ -160,8 +187,12 @@ void init_map(uns8 proc_id) {
   map_data->last_store[1].op     = &invalid_op;
   map_data->last_store[1].op_num = 0;
 
-  /* Allocate the wake_up_entry pool. */
-  expand_wake_up_entries();
+  /* Allocate the wake up arenas. They outlive a re-init of the map since
+     in-flight ops keep their lists. */
+  if(!wake_up_arenas)
+    wake_up_arenas = (Wake_Up_Arena*)calloc(NUM_CORES, sizeof(Wake_Up_Arena));
+  if(!wake_up_arenas[proc_id].overflow)
+    expand_wake_up_overflow(&wake_up_arenas[proc_id]);
 
   /* Initialize the memory dependence hash table. The number of
      buckets matters since we scan all entries (and all buckets) on
@@ -176,24 +207,35 @@ void init_map(uns8 proc_id) {
 
 
 /**************************************************************************************/
-/* recover_map: quick recover back to on path state */
+/* recover_map: quick recover back to on path state. op_num is the
+   youngest op that survives the recovery. */
 
-void recover_map() {
+void recover_map(Counter op_num) {
   uns ii;
   DEBUG(map_data->proc_id, "Recovering register map\n");
   for(ii = 0; ii < NUM_REG_IDS; ii++)
     map_data->map_flags[ii] = FALSE;
   map_data->last_store_flag = FALSE;
-  hash_table_scan(&map_data->oracle_mem_hash, recover_mem_map_entry, NULL);
+  hash_table_scan(&map_data->oracle_mem_hash, recover_mem_map_entry, &op_num);
   rebuild_offpath_map();
 }
 
 /**************************************************************************************/
-/* recover_mem_map_entry: */
+/* recover_mem_map_entry: clear the offpath flags and drop the records of
+   the flushed stores (younger than op_num). Entries left empty are deleted
+   when the flushed stores are freed (delete_store_hash_entry). */
 
 void recover_mem_map_entry(void* hash_entry, void* arg) {
-  Mem_Map_Entry* entry = (Mem_Map_Entry*)hash_entry;
-  entry->flag_mask     = 0;
+  Mem_Map_Entry* entry  = (Mem_Map_Entry*)hash_entry;
+  Counter        op_num = *(Counter*)arg;
+  uns            ii, kept = 0;
+
+  entry->flag_mask = 0;
+  for(ii = 0; ii < entry->num_records; ii++) {
+    if(entry->records[ii].op_num <= op_num)
+      entry->records[kept++] = entry->records[ii];
+  }
+  entry->num_records = kept;
 }
 
 /**************************************************************************************/
@@ -223,22 +265,42 @@ void rebuild_offpath_map() {
 
 
 /**************************************************************************************/
-/* expand_wake_up_pool: */
+/* expand_wake_up_lists: make room for the head chunk of op slot
+   min_lists - 1 (new chunks start empty) */
+
+static inline void expand_wake_up_lists(Wake_Up_Arena* arena, uns min_lists) {
+  uns num_lists = MAX2(op_pool_entries, min_lists);
+
+  DEBUGU(map_data->proc_id, "Expanding wake up lists to size %d\n",
+         num_lists);
+  arena->lists = (Wake_Up_Chunk*)realloc(arena->lists,
+                                         num_lists * sizeof(Wake_Up_Chunk));
+  ASSERT(map_data->proc_id, arena->lists);
+  memset(&arena->lists[arena->num_lists], 0,
+         (num_lists - arena->num_lists) * sizeof(Wake_Up_Chunk));
+  arena->num_lists = num_lists;
+}
 
-static inline void expand_wake_up_entries() {
-  Wake_Up_Entry* new_pool = (Wake_Up_Entry*)calloc(WAKE_UP_ENTRIES_INC,
-                                                   sizeof(Wake_Up_Entry));
-  uns            ii;
 
-  DEBUGU(map_data->proc_id, "Expanding wake up pool to size %d\n",
-         (map_data->wake_up_entries + WAKE_UP_ENTRIES_INC));
-  for(ii = 0; ii < WAKE_UP_ENTRIES_INC - 1; ii++)
-    new_pool[ii].next = &new_pool[ii + 1];
-  new_pool[ii].next        = map_data->free_list_head;
-  map_data->free_list_head = &new_pool[0];
-  map_data->wake_up_entries += WAKE_UP_ENTRIES_INC;
-  ASSERT(map_data->proc_id,
-         map_data->wake_up_entries <= WAKE_UP_ENTRIES_INC * 128);
+/**************************************************************************************/
+/* expand_wake_up_overflow: */
+
+static inline void expand_wake_up_overflow(Wake_Up_Arena* arena) {
+  uns first = MAX2(arena->num_overflow, 1);
+  uns num   = arena->num_overflow + WAKE_UP_OVERFLOW_INC;
+  uns ii;
+
+  DEBUGU(map_data->proc_id, "Expanding wake up overflow pool to size %d\n",
+         num);
+  arena->overflow = (Wake_Up_Chunk*)realloc(arena->overflow,
+                                            num * sizeof(Wake_Up_Chunk));
+  ASSERT(map_data->proc_id, arena->overflow);
+  for(ii = first; ii < num - 1; ii++)
+    arena->overflow[ii].overflow = ii + 1;
+  arena->overflow[ii].overflow = arena->overflow_free;
+  arena->overflow_free         = first;
+  arena->num_overflow          = num;
+  ASSERT(map_data->proc_id, num <= WAKE_UP_OVERFLOW_INC * 128);
 }
 
 
@@ -356,10 +418,21 @@ inline void update_map_entry(Op* op, Map_Entry* map_entry) {
 void map_mem_dep(Op* op) {
   if(!MEM_OBEY_STORE_DEP)
     return;
-  if(op->table_info->mem_type == MEM_ST)
+  if(op->table_info->mem_type == MEM_ST) {
     update_store_hash(op);
-  if(op->table_info->mem_type == MEM_LD)
-    add_store_deps(op);
+    if(STORE_SETS_ON)
+      store_sets_map_store(op);
+  }
+  if(op->table_info->mem_type == MEM_LD) {
+    Op* src_op = add_store_deps(op);
+    if(LSQ_ON && src_op) {
+      /* remember the store the load may forward from */
+      op->fwd_store_op     = src_op;
+      op->fwd_store_unique = src_op->unique_num;
+    }
+    if(STORE_SETS_ON)
+      store_sets_map_load(op);
+  }
 }
 
 /**************************************************************************************/
@@ -406,12 +479,28 @@ static inline void mem_map_byte_traversal_init(Mem_Map_Traversal* traversal) {
   ASSERT(0, traversal->byte <= traversal->last_byte);
 }
 
-static inline Flag mem_map_byte_traversal_done(Mem_Map_Traversal* traversal) {
-  return traversal->byte > traversal->last_byte;
+/* mem_map_traversal_mask: bytes of the current entry touched by the access */
+
+static inline uns64 mem_map_traversal_mask(Mem_Map_Traversal* traversal) {
+  mem_map_byte_traversal_init(traversal);
+  return (~0ull >> (MEM_MAP_ENTRY_SIZE - 1 - traversal->last_byte)) &
+         (~0ull << traversal->byte);
 }
 
-static inline void mem_map_byte_traversal_next(Mem_Map_Traversal* traversal) {
-  traversal->byte++;
+/**************************************************************************************/
+/* remove_store_record: */
+
+static inline Flag remove_store_record(Mem_Map_Entry* entry, Op* op) {
+  uns ii;
+  for(ii = 0; ii < entry->num_records; ii++) {
+    if(entry->records[ii].op == op) {
+      memmove(&entry->records[ii], &entry->records[ii + 1],
+              (entry->num_records - ii - 1) * sizeof(Store_Record));
+      entry->num_records--;
+      return TRUE;
+    }
+  }
+  return FALSE;
 }
 
 /**************************************************************************************/
@@ -433,16 +522,9 @@ void delete_store_hash_entry(Op* op) {
     if(!mem_map_p)
       continue;
 
-    /* Iterate through each byte written to by the op (within this entry) */
-    for(mem_map_byte_traversal_init(&traversal);
-        !mem_map_byte_traversal_done(&traversal);
-        mem_map_byte_traversal_next(&traversal)) {
-      uns ind = MEM_MAP_BYTE_INDEX(traversal.byte, op->off_path);
-      if(TESTBIT(mem_map_p->store_mask, ind) && mem_map_p->op[ind] == op) {
-        CLRBIT(mem_map_p->store_mask, ind);
-      }
-    }
-    if(!mem_map_p->store_mask) {
+    remove_store_record(mem_map_p, op);
+    if(!mem_map_p->num_records) {
+      free(mem_map_p->records);
       hash_table_access_delete(&map_data->oracle_mem_hash,
                                MEM_MAP_KEY(traversal.entry_addr));
     }
@@ -466,19 +548,36 @@ static inline Op* add_store_deps(Op* op) {
       mem_map_entry_traversal_next(&traversal)) {
     Mem_Map_Entry* mem_map_p = (Mem_Map_Entry*)hash_table_access(
       &map_data->oracle_mem_hash, MEM_MAP_KEY(traversal.entry_addr));
+    Op*   first_byte_src[MEM_MAP_ENTRY_SIZE];
+    uns64 first_bytes = 0;
+    uns64 remaining[2];
+    uns64 mask;
+    int   ii;
 
     if(!mem_map_p)
       continue;
 
-    /* Iterate through each byte read by the op (within this entry) */
-    for(mem_map_byte_traversal_init(&traversal);
-        !mem_map_byte_traversal_done(&traversal);
-        mem_map_byte_traversal_next(&traversal)) {
-      uns ind = MEM_MAP_BYTE_INDEX(
-        traversal.byte, TESTBIT(mem_map_p->flag_mask, traversal.byte));
-      if(!TESTBIT(mem_map_p->store_mask, ind))
-        continue; /* ensure mem_map_p info is valid */
-      Op* src_op = mem_map_p->op[ind];
+    /* Find the store supplying each byte read by the op: the last record
+       covering it in the half (onpath/offpath) selected by its flag. Each
+       store is noted at the first byte it supplies. */
+    mask         = mem_map_traversal_mask(&traversal);
+    remaining[0] = mask & ~mem_map_p->flag_mask;
+    remaining[1] = mask & mem_map_p->flag_mask;
+    for(ii = mem_map_p->num_records - 1;
+        ii >= 0 && (remaining[0] | remaining[1]); ii--) {
+      Store_Record* record   = &mem_map_p->records[ii];
+      uns64         supplied = record->byte_mask & remaining[record->off_path];
+      if(supplied) {
+        uns first = __builtin_ctzll(supplied);
+        remaining[record->off_path] &= ~supplied;
+        first_bytes |= 1ull << first;
+        first_byte_src[first] = record->op;
+      }
+    }
+
+    /* Visit the stores in byte order */
+    for(; first_bytes; first_bytes &= first_bytes - 1) {
+      Op* src_op = first_byte_src[__builtin_ctzll(first_bytes)];
       ASSERTM(op->proc_id,
               BYTE_OVERLAP(src_op->oracle_info.va, src_op->oracle_info.mem_size,
                            va, op->oracle_info.mem_size),
@@ -519,7 +618,8 @@ static inline Op* add_store_deps(Op* op) {
 
 
 /**************************************************************************************/
-/* update_store_hash: */
+/* update_store_hash: one record per entry written by the store. A store
+   written again (by rebuild_offpath_map) moves to the end of the records. */
 
 static inline void update_store_hash(Op* op) {
   Mem_Map_Entry*    mem_map_p;
@@ -532,25 +632,38 @@ static inline void update_store_hash(Op* op) {
   for(mem_map_entry_traversal_init(&traversal, va, op->oracle_info.mem_size);
       !mem_map_entry_traversal_done(&traversal);
       mem_map_entry_traversal_next(&traversal)) {
-    Flag new_entry = FALSE;
-    mem_map_p      = (Mem_Map_Entry*)hash_table_access_create(
+    Flag          new_entry = FALSE;
+    uns64         mask      = mem_map_traversal_mask(&traversal);
+    Store_Record* record;
+    mem_map_p = (Mem_Map_Entry*)hash_table_access_create(
       &map_data->oracle_mem_hash, MEM_MAP_KEY(traversal.entry_addr),
       &new_entry);
 
     if(new_entry) {
-      mem_map_p->flag_mask  = 0;
-      mem_map_p->store_mask = 0;
+      mem_map_p->flag_mask   = 0;
+      mem_map_p->records     = NULL;
+      mem_map_p->num_records = 0;
+      mem_map_p->max_records = 0;
+    } else {
+      remove_store_record(mem_map_p, op);
     }
 
-    /* Iterate through each byte written to by the op (within this entry) */
-    for(mem_map_byte_traversal_init(&traversal);
-        !mem_map_byte_traversal_done(&traversal);
-        mem_map_byte_traversal_next(&traversal)) {
-      DEFBIT(mem_map_p->flag_mask, traversal.byte, op->off_path);
-      uns ind = MEM_MAP_BYTE_INDEX(traversal.byte, op->off_path);
-      SETBIT(mem_map_p->store_mask, ind);
-      mem_map_p->op[ind] = op;
+    if(mem_map_p->num_records == mem_map_p->max_records) {
+      mem_map_p->max_records += MEM_MAP_RECORDS_INC;
+      mem_map_p->records = (Store_Record*)realloc(
+        mem_map_p->records, mem_map_p->max_records * sizeof(Store_Record));
+      ASSERT(map_data->proc_id, mem_map_p->records);
     }
+
+    if(op->off_path)
+      mem_map_p->flag_mask |= mask;
+    else
+      mem_map_p->flag_mask &= ~mask;
+    record            = &mem_map_p->records[mem_map_p->num_records++];
+    record->op        = op;
+    record->op_num    = op->op_num;
+    record->byte_mask = mask;
+    record->off_path  = op->off_path;
   }
 }
 
@@ -558,7 +671,8 @@ static inline void update_store_hash(Op* op) {
 /* wake_up_ops: */
 
 void wake_up_ops(Op* op, Dep_Type type, void (*wake_action)(Op*, Op*, uns8)) {
-  Wake_Up_Entry* temp;
+  Wake_Up_Chunk* chunk;
+  uns            ii;
 
 
   _DEBUG(op->proc_id, DEBUG_REPLAY,
@@ -569,33 +683,42 @@ void wake_up_ops(Op* op, Dep_Type type, void (*wake_action)(Op*, Op*, uns8)) {
           op->off_path);
 
   ASSERT(op->proc_id, wake_action);
-  for(temp = op->wake_up_head; temp; temp = temp->next) {
-    Op*     dep_op         = temp->op;
-    Counter dep_unique_num = temp->unique_num;
-
-    ASSERT(op->proc_id, dep_op);
-
-    if(temp->dep_type != type)
-      continue;
-    /* if the stored unique num is not the same as the op pool entry, the op has
-           been reclaimed and the wake up should be ignored */
-    if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
-      ASSERTM(op->proc_id, op->proc_id == dep_op->proc_id,
-              "dep_op proc_id: %u, valid: %u\n", dep_op->proc_id,
-              dep_op->op_pool_valid);
-      if(test_not_rdy_bit(dep_op, temp->rdy_bit)) {
-        DEBUG(dep_op->proc_id, "Waking up  op_num:%s\n",
-              unsstr64(dep_op->op_num));
-
-        ASSERTM(dep_op->proc_id, test_not_rdy_bit(dep_op, temp->rdy_bit),
-                "dep_op_num:%s  not_rdy_vector:%x\n", unsstr64(dep_op->op_num),
-                dep_op->srcs_not_rdy_vector);
-
-        /* unset the not ready bit for this source */
-        clear_not_rdy_bit(dep_op, temp->rdy_bit);
-
-        /* call the wake action function */
-        wake_action(op, dep_op, temp->rdy_bit);
+  for(chunk = wake_up_list_head(op); chunk;
+      chunk = wake_up_list_next(op, chunk)) {
+    for(ii = 0; ii < chunk->count; ii++) {
+      Wake_Up_Entry* temp           = &chunk->entries[ii];
+      Op*            dep_op         = temp->op;
+      Counter        dep_unique_num = temp->unique_num;
+
+      ASSERT(op->proc_id, dep_op);
+
+      if(temp->dep_type != type)
+        continue;
+      /* if the stored unique num is not the same as the op pool entry, the op
+         has been reclaimed and the wake up should be ignored */
+      if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
+        ASSERTM(op->proc_id, op->proc_id == dep_op->proc_id,
+                "dep_op proc_id: %u, valid: %u\n", dep_op->proc_id,
+                dep_op->op_pool_valid);
+        if(test_not_rdy_bit(dep_op, temp->rdy_bit)) {
+          DEBUG(dep_op->proc_id, "Waking up  op_num:%s\n",
+                unsstr64(dep_op->op_num));
+
+          ASSERTM(dep_op->proc_id, test_not_rdy_bit(dep_op, temp->rdy_bit),
+                  "dep_op_num:%s  not_rdy_vector:%x\n",
+                  unsstr64(dep_op->op_num), dep_op->srcs_not_rdy_vector);
+
+          /* unset the not ready bit for this source */
+          clear_not_rdy_bit(dep_op, temp->rdy_bit);
+
+          if(STORE_SETS_ON && type == MEM_DATA_DEP)
+            store_sets_mem_dep_wake(op, dep_op);
+          if((VALUE_PRED_ON || ADDR_PRED_ON) && type == REG_DATA_DEP)
+            value_pred_wake(op, dep_op);
+
+          /* call the wake action function */
+          wake_action(op, dep_op, temp->rdy_bit);
+        }
       }
     }
   }
@@ -640,35 +763,14 @@ void add_to_wake_up_lists(Op* op, Op_Info* op_info,
         op->op_num, op->fetch_cycle, src_op->op_num, src_op->unique_num,
         src_op->fetch_cycle);
 
-      if(map_data->free_list_head == NULL) {
-        ASSERT(map_data->proc_id,
-               map_data->active_wake_up_entries == map_data->wake_up_entries);
-        expand_wake_up_entries();
-      }
-
       if(src_info->type == MEM_DATA_DEP)
         dep_on_in_window_store = TRUE;
 
-      wake = map_data->free_list_head;
-      map_data->active_wake_up_entries++;
-      map_data->free_list_head = wake->next;
-
+      wake             = alloc_wake_up_entry(src_op);
       wake->op         = op;
       wake->unique_num = op->unique_num;
       wake->dep_type   = src_info->type;
       wake->rdy_bit    = ii;
-      wake->next       = NULL;
-
-      if(src_op->wake_up_tail == NULL) {
-        src_op->wake_up_head  = wake;
-        src_op->wake_up_tail  = wake;
-        src_op->wake_up_count = 1;
-      } else {
-        ASSERT(map_data->proc_id, src_op->wake_up_head);
-        src_op->wake_up_tail->next = wake;
-        src_op->wake_up_tail       = wake;
-        src_op->wake_up_count++;
-      }
 
       if(TRACK_L1_MISS_DEPS) {
         // An op can occupy multiple entries in the wakeup list of another op
@@ -683,6 +785,11 @@ void add_to_wake_up_lists(Op* op, Op_Info* op_info,
       if(src_op->wake_up_signaled[src_info->type]) {
         clear_not_rdy_bit(op, ii);
         wake_action(src_op, op, ii);
+      } else if((VALUE_PRED_ON || ADDR_PRED_ON) &&
+                src_info->type == REG_DATA_DEP &&
+                value_pred_early_ready(src_op, op)) {
+        /* the predicted value or address stands in for the source */
+        clear_not_rdy_bit(op, ii);
       }
 
       DEBUG(op->proc_id,
@@ -705,16 +812,20 @@ void free_wake_up_list(Op* op) {
   ASSERT(map_data->proc_id, op);
   ASSERT(map_data->proc_id, op->proc_id == map_data->proc_id);
 
-  if(op->wake_up_tail) {
-    ASSERT(map_data->proc_id, op->wake_up_head);
+  if(op->wake_up_count) {
+    Wake_Up_Arena* arena = &wake_up_arenas[op->proc_id];
+    Wake_Up_Chunk* head  = &arena->lists[op->op_pool_id];
     DEBUG(map_data->proc_id, "Freeing wake up list for op_num:%s\n",
           unsstr64(op->op_num));
-    op->wake_up_tail->next   = map_data->free_list_head;
-    map_data->free_list_head = op->wake_up_head;
-    map_data->active_wake_up_entries -= op->wake_up_count;
-    ASSERT(map_data->proc_id, map_data->active_wake_up_entries >= 0);
-    op->wake_up_head = NULL;
-    op->wake_up_tail = NULL;
+    /* the overflow chunks are already chained, so release them in one go */
+    if(head->tail) {
+      arena->overflow[head->tail].overflow = arena->overflow_free;
+      arena->overflow_free                 = head->overflow;
+    }
+    head->count       = 0;
+    head->overflow    = 0;
+    head->tail        = 0;
+    op->wake_up_count = 0;
   } else {
     DEBUG(map_data->proc_id, "No wake up list for op_num:%s\n",
           unsstr64(op->op_num));
@@ -722,6 +833,66 @@ void free_wake_up_list(Op* op) {
 }
 
 
+/**************************************************************************************/
+/* wake_up_list_head: first chunk of the op's wake up list, NULL if empty.
+   Chunk pointers stay valid until the next add_to_wake_up_lists. */
+
+Wake_Up_Chunk* wake_up_list_head(Op* op) {
+  if(!op->wake_up_count)
+    return NULL;
+  return &wake_up_arenas[op->proc_id].lists[op->op_pool_id];
+}
+
+
+/**************************************************************************************/
+/* wake_up_list_next: */
+
+Wake_Up_Chunk* wake_up_list_next(Op* op, Wake_Up_Chunk* chunk) {
+  if(!chunk->overflow)
+    return NULL;
+  return &wake_up_arenas[op->proc_id].overflow[chunk->overflow];
+}
+
+
+/**************************************************************************************/
+/* alloc_wake_up_entry: append an entry to src_op's wake up list, taking an
+   overflow chunk when the last chunk is full */
+
+static inline Wake_Up_Entry* alloc_wake_up_entry(Op* src_op) {
+  Wake_Up_Arena* arena = &wake_up_arenas[src_op->proc_id];
+  Wake_Up_Chunk* head;
+  Wake_Up_Chunk* tail;
+
+  if(src_op->op_pool_id >= arena->num_lists)
+    expand_wake_up_lists(arena, src_op->op_pool_id + 1);
+  head = &arena->lists[src_op->op_pool_id];
+  ASSERT(src_op->proc_id, src_op->wake_up_count || !head->count);
+
+  if(head->count == WAKE_UP_CHUNK_ENTRIES &&
+     (!head->tail ||
+      arena->overflow[head->tail].count == WAKE_UP_CHUNK_ENTRIES)) {
+    uns idx;
+    if(!arena->overflow_free)
+      expand_wake_up_overflow(arena);
+    idx                  = arena->overflow_free;
+    tail                 = &arena->overflow[idx];
+    arena->overflow_free = tail->overflow;
+    tail->count          = 0;
+    tail->overflow       = 0;
+    if(head->tail)
+      arena->overflow[head->tail].overflow = idx;
+    else
+      head->overflow = idx;
+    head->tail = idx;
+  } else {
+    tail = head->tail ? &arena->overflow[head->tail] : head;
+  }
+
+  src_op->wake_up_count++;
+  return &tail->entries[tail->count++];
+}
+
+
 /**************************************************************************************/
 /* add_src_from_op: . */
 
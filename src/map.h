@@ -54,12 +54,20 @@ typedef struct Map_Data_struct {
   Flag      last_store_flag;
 
   Hash_Table oracle_mem_hash;
-
-  Wake_Up_Entry* free_list_head;
-  uns            wake_up_entries;
-  uns            active_wake_up_entries;
 } Map_Data;
 
+/* A wake up list is a chain of chunks of inline entries. Each core keeps one
+   head chunk per op slot (op_pool_id) in a contiguous arena; producers with
+   more than WAKE_UP_CHUNK_ENTRIES consumers chain overflow chunks. */
+#define WAKE_UP_CHUNK_ENTRIES 4
+
+typedef struct Wake_Up_Chunk_struct {
+  Wake_Up_Entry entries[WAKE_UP_CHUNK_ENTRIES];
+  uns           count;     // valid entries in this chunk
+  uns           overflow;  // next overflow chunk (0: none)
+  uns           tail;      // head chunk only: last overflow chunk (0: none)
+} Wake_Up_Chunk;
+
 
 /**************************************************************************************/
 /* External Variables */
@@ -72,7 +80,7 @@ extern Map_Data* map_data;
 
 Map_Data* set_map_data(Map_Data*);
 void      init_map(uns8);
-void      recover_map(void);
+void      recover_map(Counter);
 void      rebuild_offpath_map(void);
 void      reset_map(void);
 void      map_op(Op*);
@@ -81,6 +89,9 @@ void      wake_up_ops(Op*, Dep_Type, void (*)(Op*, Op*, uns8));
 void      free_wake_up_list(Op*);
 void      add_to_wake_up_lists(Op*, Op_Info*, void (*)(Op*, Op*, uns8));
 
+Wake_Up_Chunk* wake_up_list_head(Op*);
+Wake_Up_Chunk* wake_up_list_next(Op*, Wake_Up_Chunk*);
+
 void add_src_from_op(Op*, Op*, Dep_Type);
 void add_src_from_map_entry(Op*, Map_Entry*, Dep_Type);
 
@@ -41,6 +41,7 @@
 #include "map_stage.h"
 #include "model.h"
 #include "thread.h"
+#include "value_pred.h"
 
 #include "core.param.h"
 #include "debug/debug.param.h"
@@ -213,6 +214,9 @@ void update_map_stage(Stage_Data* src_sd) {
 /* map_process_op: */
 
 static inline void stage_process_op(Op* op) {
-  /* the map stage is currently responsible only for setting wake up lists */
+  /* the map stage is responsible for value prediction and for setting wake up
+     lists */
+  if(VALUE_PRED_ON || ADDR_PRED_ON)
+    value_pred_map(op);
   add_to_wake_up_lists(op, &op->oracle_info, model->wake_hook);
 }
@@ -0,0 +1,555 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/coherence.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Sparse directory keeping the private L1s coherent with a MESI
+ *                or MOESI protocol.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "cmp_model.h"
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "general.param.h"
+#include "libs/cache_lib.h"
+#include "memory/coherence.h"
+#include "memory/interconnect.h"
+#include "memory/mem_req.h"
+#include "memory/memory.h"
+#include "memory/memory.param.h"
+#include "statistics.h"
+
+/*
+   The directory is distributed over the tiles of the cores (the home tile of
+   a line is picked by the same hash that spreads lines over shared L1
+   slices) and tracks, per line, the cores whose private L1 holds it and the
+   core that owns it. It is sparse: evicting a directory entry invalidates
+   every copy of its line.
+
+   Coherence messages are not queued in the request buffers. A request that
+   needs them is timed as the sum of its message latencies over the
+   interconnect (or the core/L1 bus), the directory lookup and, for a
+   forward, the owner's L1 access; invalidations to several sharers are sent
+   in parallel and the slowest ack counts. A miss that another core
+   supplies skips memory and fills the L1 after that latency; other misses
+   go to memory as before.
+
+   Addresses keep the core id in their upper bits. With SHARED_ADDRESS_SPACE
+   the directory drops it, so the same line touched by several cores is one
+   directory entry; otherwise the cores never share lines and the directory
+   only adds its capacity limit.
+
+   A dirty copy that is invalidated without being forwarded to the requester
+   (a directory eviction, or an owner giving up a line under MESI) is
+   written back to memory. Writebacks the memory system cannot take yet are
+   retried every cycle.
+*/
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_COHERENCE, ##args)
+
+#define COH_TRACK_ASSOC 8
+
+/**************************************************************************************/
+/* Types */
+
+typedef enum Dir_State_enum {
+  DIR_SHARED,    /* clean copies only, memory is up to date */
+  DIR_EXCLUSIVE, /* one clean copy, in the owner */
+  DIR_MODIFIED,  /* one dirty copy, in the owner */
+  DIR_OWNED,     /* MOESI: dirty in the owner, clean in the other sharers */
+} Dir_State;
+
+typedef struct Dir_Entry_struct {
+  Dir_State state;
+  uns64     sharers; /* one bit per core holding the line, owner included */
+  uns       owner;   /* valid unless the state is DIR_SHARED */
+} Dir_Entry;
+
+typedef struct Coh_Wb_struct {
+  uns  proc_id;
+  Addr addr;
+} Coh_Wb;
+
+typedef struct Coherence_struct {
+  Cache   dir;       /* the directory, indexed by line number */
+  Cache*  inv_lines; /* per core: lines lost to invalidations */
+  uns     num_valid; /* valid directory entries */
+  Coh_Wb* wbs;       /* writebacks waiting for the memory system */
+  uns     num_wbs;
+  uns     max_wbs;
+} Coherence;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Coherence coh;
+
+DEFINE_ENUM(Coherence_Protocol, COHERENCE_PROTOCOL_LIST);
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static Addr       coh_key(Addr addr);
+static Addr       coh_core_addr(uns proc_id, Addr key);
+static uns        coh_home(Addr key);
+static Flag       coh_req_type(Mem_Req_Type type);
+static Dir_Entry* dir_lookup(uns proc_id, Addr key);
+static Flag       coh_drop_upper(uns proc_id, Addr addr);
+static void       coh_writeback(uns proc_id, Addr addr);
+static uns        coh_invalidate(uns proc_id, Addr key, Dir_Entry* entry,
+                                 uns64 victims, Flag track, Flag forward);
+static uns        coh_read(uns proc_id, Addr key, Dir_Entry* entry,
+                           Flag* forward);
+static uns        coh_write(uns proc_id, Addr key, Dir_Entry* entry,
+                            Flag* forward);
+
+/**************************************************************************************/
+/* init_coherence: */
+
+void init_coherence(void) {
+  char name[MAX_STR_LENGTH + 1];
+
+  if(COHERENCE_PROTOCOL == COHERENCE_NONE)
+    return;
+
+  ASSERTM(0, PRIVATE_L1, "COHERENCE_PROTOCOL needs PRIVATE_L1\n");
+  ASSERTM(0, NUM_CORES <= 64, "The directory tracks at most 64 cores\n");
+  ASSERT(0, COHERENCE_DIR_ENTRIES % COHERENCE_DIR_ASSOC == 0);
+  ASSERT(0, COHERENCE_MISS_TRACK_ENTRIES % COH_TRACK_ASSOC == 0);
+
+  init_cache(&coh.dir, "COHERENCE_DIR", COHERENCE_DIR_ENTRIES,
+             COHERENCE_DIR_ASSOC, 1, sizeof(Dir_Entry), REPL_TRUE_LRU);
+  coh.inv_lines = (Cache*)malloc(NUM_CORES * sizeof(Cache));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    snprintf(name, MAX_STR_LENGTH, "COHERENCE_INV_LINES[%u]", proc_id);
+    init_cache(&coh.inv_lines[proc_id], name, COHERENCE_MISS_TRACK_ENTRIES,
+               COH_TRACK_ASSOC, 1, 0, REPL_TRUE_LRU);
+  }
+  coh.num_valid = 0;
+}
+
+/**************************************************************************************/
+/* update_coherence: */
+
+void update_coherence(void) {
+  uns kept = 0;
+
+  if(COHERENCE_PROTOCOL == COHERENCE_NONE)
+    return;
+  /* the directory is shared, its stats are kept on core 0 */
+  INC_STAT_EVENT(0, COHERENCE_DIR_OCCUPANCY, coh.num_valid);
+
+  for(uns ii = 0; ii < coh.num_wbs; ii++) {
+    if(!new_mem_coherence_wb_req(coh.wbs[ii].proc_id, coh.wbs[ii].addr))
+      coh.wbs[kept++] = coh.wbs[ii];
+  }
+  coh.num_wbs = kept;
+}
+
+/**************************************************************************************/
+/* coh_key: line number that identifies addr in the directory */
+
+static Addr coh_key(Addr addr) {
+  if(SHARED_ADDRESS_SPACE)
+    addr = convert_to_cmp_addr(0, addr);
+  return addr >> LOG2(L1_LINE_SIZE);
+}
+
+/**************************************************************************************/
+/* coh_core_addr: address of the line key in the caches of proc_id */
+
+static Addr coh_core_addr(uns proc_id, Addr key) {
+  Addr addr = key << LOG2(L1_LINE_SIZE);
+  return SHARED_ADDRESS_SPACE ? convert_to_cmp_addr(proc_id, addr) : addr;
+}
+
+/**************************************************************************************/
+/* coh_home: tile holding the directory slice of key */
+
+static uns coh_home(Addr key) {
+  return interconnect_l1_bank(key << LOG2(L1_LINE_SIZE), NUM_CORES);
+}
+
+/**************************************************************************************/
+/* coh_req_type: writebacks stay within the private hierarchy */
+
+static Flag coh_req_type(Mem_Req_Type type) {
+  return type == MRT_IFETCH || type == MRT_DFETCH || type == MRT_DSTORE ||
+         type == MRT_IPRF || type == MRT_DPRF;
+}
+
+/**************************************************************************************/
+/* dir_lookup: find or allocate the directory entry of key. A replaced entry
+   invalidates every copy of its line. */
+
+static Dir_Entry* dir_lookup(uns proc_id, Addr key) {
+  Addr       line_addr, repl_key;
+  Flag       repl_valid;
+  Dir_Entry* entry = (Dir_Entry*)cache_access(&coh.dir, key, &line_addr, TRUE);
+
+  if(entry)
+    return entry;
+
+  entry = (Dir_Entry*)get_next_repl_line(&coh.dir, proc_id, key, &repl_key,
+                                         &repl_valid);
+  if(repl_valid) {
+    DEBUG(proc_id, "Directory evicts line 0x%s  sharers:0x%llx\n",
+          hexstr64s(repl_key << LOG2(L1_LINE_SIZE)), entry->sharers);
+    STAT_EVENT(0, COHERENCE_DIR_EVICT);
+    coh_invalidate(proc_id, repl_key, entry, entry->sharers, FALSE, FALSE);
+    coh.num_valid--;
+  }
+
+  entry = (Dir_Entry*)cache_insert(&coh.dir, proc_id, key, &line_addr,
+                                   &repl_key);
+  entry->state   = DIR_SHARED;
+  entry->sharers = 0;
+  entry->owner   = 0;
+  coh.num_valid++;
+  return entry;
+}
+
+/**************************************************************************************/
+/* coh_drop_upper: remove the line at addr from the caches above the private
+   L1 of proc_id. Returns TRUE if any of the dropped copies was dirty. */
+
+static Flag coh_drop_upper(uns proc_id, Addr addr) {
+  Cache* dcache = &cmp_model.dcache_stage[proc_id].dcache;
+  Addr   line_addr;
+  Flag   dirty = FALSE;
+
+  for(uns off = 0; off < L1_LINE_SIZE; off += DCACHE_LINE_SIZE) {
+    Dcache_Data* data = (Dcache_Data*)cache_access(dcache, addr + off,
+                                                   &line_addr, FALSE);
+    dirty |= data && data->dirty;
+    cache_invalidate(dcache, addr + off, &line_addr);
+  }
+  if(MLC_PRESENT) {
+    Cache* mlc = &mem->uncores[proc_id].mlc->cache;
+    for(uns off = 0; off < L1_LINE_SIZE; off += MLC_LINE_SIZE) {
+      MLC_Data* data = (MLC_Data*)cache_access(mlc, addr + off, &line_addr,
+                                               FALSE);
+      dirty |= data && data->dirty;
+      cache_invalidate(mlc, addr + off, &line_addr);
+    }
+  }
+  return dirty;
+}
+
+/**************************************************************************************/
+/* coh_writeback: write the dirty line at addr of proc_id back to memory */
+
+static void coh_writeback(uns proc_id, Addr addr) {
+  if(L1_WRITE_THROUGH || L1_IGNORE_WB)
+    return;
+
+  DEBUG(proc_id, "Write back line 0x%s\n", hexstr64s(addr));
+  STAT_EVENT(proc_id, COHERENCE_WRITEBACK);
+  if(new_mem_coherence_wb_req(proc_id, addr))
+    return;
+
+  if(coh.num_wbs == coh.max_wbs) {
+    coh.max_wbs = MAX2(2 * coh.max_wbs, 16);
+    coh.wbs     = (Coh_Wb*)realloc(coh.wbs, coh.max_wbs * sizeof(Coh_Wb));
+  }
+  coh.wbs[coh.num_wbs].proc_id = proc_id;
+  coh.wbs[coh.num_wbs].addr    = addr;
+  coh.num_wbs++;
+}
+
+/**************************************************************************************/
+/* coh_invalidate: invalidate the copies of key in the cores of victims on
+   behalf of proc_id. Lines lost by a tracked invalidation count as coherence
+   misses when they are missed again. If forward is set the owner's copy goes
+   to proc_id; other dirty copies are written back. Returns the cycles until
+   the last ack reaches proc_id. */
+
+static uns coh_invalidate(uns proc_id, Addr key, Dir_Entry* entry,
+                          uns64 victims, Flag track, Flag forward) {
+  uns home    = coh_home(key);
+  uns latency = 0;
+
+  for(uns victim = 0; victim < NUM_CORES; victim++) {
+    Cache*   l1 = &mem->uncores[victim].l1->cache;
+    Addr     addr, line_addr;
+    L1_Data* data;
+    Flag     dirty;
+    uns      ack;
+
+    if(!(victims & (1ULL << victim)))
+      continue;
+
+    addr  = coh_core_addr(victim, key);
+    dirty = coh_drop_upper(victim, addr);
+    data  = (L1_Data*)cache_access(l1, addr, &line_addr, FALSE);
+    dirty |= data && data->dirty;
+    cache_invalidate(l1, addr, &line_addr);
+    if(dirty && !(forward && victim == entry->owner))
+      coh_writeback(victim, addr);
+    if(track)
+      cache_insert(&coh.inv_lines[victim], victim, key, &line_addr,
+                   &line_addr);
+
+    ack = interconnect_send_msg(proc_id, home, victim, NOC_CTRL_BYTES) +
+          interconnect_send_msg(proc_id, victim, proc_id, NOC_CTRL_BYTES);
+    latency = MAX2(latency, ack);
+    STAT_EVENT(proc_id, COHERENCE_INV_SENT);
+    STAT_EVENT(victim, COHERENCE_INV_RECEIVED);
+    DEBUG(proc_id, "Invalidate line 0x%s in core %u\n", hexstr64s(addr),
+          victim);
+  }
+
+  entry->sharers &= ~victims;
+  if(entry->state != DIR_SHARED && (victims & (1ULL << entry->owner)))
+    entry->state = DIR_SHARED;
+  return latency;
+}
+
+/**************************************************************************************/
+/* coh_read: proc_id reads key. Returns the cycles until the data arrives if
+   another core supplies it (sets *forward). */
+
+static uns coh_read(uns proc_id, Addr key, Dir_Entry* entry, Flag* forward) {
+  uns64 me     = 1ULL << proc_id;
+  uns64 others = entry->sharers & ~me;
+  uns   owner  = entry->owner;
+  uns   home   = coh_home(key);
+  uns   latency;
+
+  *forward = entry->state != DIR_SHARED && (others & (1ULL << owner));
+  if(!*forward) {
+    if(!others && entry->state == DIR_SHARED) {
+      entry->state = DIR_EXCLUSIVE;
+      entry->owner = proc_id;
+    }
+    entry->sharers |= me;
+    return 0;
+  }
+
+  /* the owner supplies the line */
+  latency = interconnect_send_msg(proc_id, proc_id, home, NOC_CTRL_BYTES) +
+            COHERENCE_DIR_CYCLES +
+            interconnect_send_msg(proc_id, home, owner, NOC_CTRL_BYTES) +
+            L1_CYCLES +
+            interconnect_send_msg(proc_id, owner, proc_id,
+                                  NOC_CTRL_BYTES + L1_LINE_SIZE);
+  STAT_EVENT(proc_id, COHERENCE_FORWARD_FROM_E + entry->state - DIR_EXCLUSIVE);
+
+  if(entry->state == DIR_EXCLUSIVE) {
+    entry->state = DIR_SHARED;
+  } else if(entry->state == DIR_MODIFIED) {
+    if(COHERENCE_PROTOCOL == COHERENCE_MOESI) {
+      entry->state = DIR_OWNED;
+    } else {
+      /* MESI has no dirty sharing: the owner writes the line back */
+      Addr     addr = coh_core_addr(owner, key);
+      Addr     line_addr;
+      L1_Data* data = (L1_Data*)cache_access(&mem->uncores[owner].l1->cache,
+                                             addr, &line_addr, FALSE);
+      if(data)
+        data->dirty = FALSE;
+      entry->state = DIR_SHARED;
+      coh_writeback(owner, addr);
+    }
+  }
+  entry->sharers |= me;
+  return latency;
+}
+
+/**************************************************************************************/
+/* coh_write: proc_id gains the only, modified copy of key. Returns the cycles
+   until the other copies are gone (and the data arrives if another core
+   supplies it, which sets *forward). */
+
+static uns coh_write(uns proc_id, Addr key, Dir_Entry* entry, Flag* forward) {
+  uns64 me      = 1ULL << proc_id;
+  uns64 others  = entry->sharers & ~me;
+  uns   owner   = entry->owner;
+  uns   home    = coh_home(key);
+  uns   latency = 0;
+
+  *forward = entry->state != DIR_SHARED && (others & (1ULL << owner));
+  if(others) {
+    uns to_home = interconnect_send_msg(proc_id, proc_id, home,
+                                        NOC_CTRL_BYTES) +
+                  COHERENCE_DIR_CYCLES;
+    if(*forward)
+      latency = to_home +
+                interconnect_send_msg(proc_id, home, owner, NOC_CTRL_BYTES) +
+                L1_CYCLES +
+                interconnect_send_msg(proc_id, owner, proc_id,
+                                      NOC_CTRL_BYTES + L1_LINE_SIZE);
+    uns inv = to_home +
+              coh_invalidate(proc_id, key, entry, others, TRUE, *forward);
+    latency = MAX2(latency, inv);
+  } else if((entry->sharers & me) && entry->state == DIR_SHARED) {
+    /* sole sharer of a clean line still asks the directory for ownership */
+    latency = interconnect_send_msg(proc_id, proc_id, home, NOC_CTRL_BYTES) +
+              COHERENCE_DIR_CYCLES +
+              interconnect_send_msg(proc_id, home, proc_id, NOC_CTRL_BYTES);
+  }
+
+  entry->state   = DIR_MODIFIED;
+  entry->owner   = proc_id;
+  entry->sharers = me;
+  return latency;
+}
+
+/**************************************************************************************/
+/* coherence_l1_forwarded: */
+
+Flag coherence_l1_forwarded(Mem_Req* req) {
+  Addr       line_addr;
+  Dir_Entry* entry;
+
+  if(COHERENCE_PROTOCOL == COHERENCE_NONE || !coh_req_type(req->type))
+    return FALSE;
+
+  entry = (Dir_Entry*)cache_access(&coh.dir, coh_key(req->addr), &line_addr,
+                                   FALSE);
+  return entry && entry->state != DIR_SHARED && entry->owner != req->proc_id &&
+         (entry->sharers & (1ULL << entry->owner));
+}
+
+/**************************************************************************************/
+/* coherence_l1_miss: */
+
+Flag coherence_l1_miss(Mem_Req* req, uns* latency) {
+  uns        proc_id = req->proc_id;
+  Addr       key, line_addr;
+  Dir_Entry* entry;
+  Flag       forward;
+
+  *latency = 0;
+  if(COHERENCE_PROTOCOL == COHERENCE_NONE || !coh_req_type(req->type))
+    return FALSE;
+
+  key = coh_key(req->addr);
+  if(cache_access(&coh.inv_lines[proc_id], key, &line_addr, FALSE)) {
+    cache_invalidate(&coh.inv_lines[proc_id], key, &line_addr);
+    STAT_EVENT(proc_id, COHERENCE_MISS);
+    STAT_EVENT(proc_id, COHERENCE_MISS_ONPATH + req->off_path);
+  }
+
+  entry = dir_lookup(proc_id, key);
+  if(req->type == MRT_DSTORE)
+    *latency = coh_write(proc_id, key, entry, &forward);
+  else
+    *latency = coh_read(proc_id, key, entry, &forward);
+
+  DEBUG(proc_id, "L1 miss  type:%s  addr:0x%s  state:%d  sharers:0x%llx  "
+        "forward:%d  latency:%u\n", Mem_Req_Type_str(req->type),
+        hexstr64s(req->addr), entry->state, entry->sharers, forward, *latency);
+  return forward;
+}
+
+/**************************************************************************************/
+/* coherence_l1_hit: */
+
+uns coherence_l1_hit(Mem_Req* req) {
+  uns        proc_id = req->proc_id;
+  Addr       key;
+  Dir_Entry* entry;
+  Flag       forward;
+  uns        latency;
+
+  if(COHERENCE_PROTOCOL == COHERENCE_NONE || !coh_req_type(req->type))
+    return 0;
+
+  key   = coh_key(req->addr);
+  entry = dir_lookup(proc_id, key);
+  if(req->type != MRT_DSTORE) {
+    /* a fill that raced an invalidation left a copy the directory lost */
+    if(!(entry->sharers & (1ULL << proc_id)))
+      coh_read(proc_id, key, entry, &forward);
+    return 0;
+  }
+
+  if(entry->state != DIR_SHARED && entry->owner == proc_id) {
+    entry->state = DIR_MODIFIED; /* silent E to M */
+    return 0;
+  }
+  latency = coh_write(proc_id, key, entry, &forward);
+  STAT_EVENT(proc_id, COHERENCE_UPGRADE);
+  return latency;
+}
+
+/**************************************************************************************/
+/* coherence_dcache_store: ownership latency is hidden by the store buffer */
+
+void coherence_dcache_store(uns proc_id, Addr addr) {
+  Addr       key;
+  Dir_Entry* entry;
+  Flag       forward;
+
+  if(COHERENCE_PROTOCOL == COHERENCE_NONE)
+    return;
+
+  key   = coh_key(addr);
+  entry = dir_lookup(proc_id, key);
+  if(entry->state != DIR_SHARED && entry->owner == proc_id) {
+    entry->state = DIR_MODIFIED;
+    return;
+  }
+  coh_write(proc_id, key, entry, &forward);
+  STAT_EVENT(proc_id, COHERENCE_UPGRADE);
+}
+
+/**************************************************************************************/
+/* coherence_l1_evict: the L1 is kept inclusive of the caches above it so that
+   the directory sees every copy. Dirty data above a clean L1 copy is written
+   back here; a dirty L1 copy is written back by the caller. */
+
+void coherence_l1_evict(uns proc_id, Addr line_addr, Flag l1_dirty) {
+  Addr       key = coh_key(line_addr);
+  Addr       dir_line_addr;
+  Dir_Entry* entry;
+
+  if(COHERENCE_PROTOCOL == COHERENCE_NONE)
+    return;
+
+  if(coh_drop_upper(proc_id, line_addr) && !l1_dirty)
+    coh_writeback(proc_id, line_addr);
+  entry = (Dir_Entry*)cache_access(&coh.dir, key, &dir_line_addr, FALSE);
+  if(!entry)
+    return;
+
+  entry->sharers &= ~(1ULL << proc_id);
+  if(entry->state != DIR_SHARED && entry->owner == proc_id)
+    entry->state = DIR_SHARED; /* a dirty owner wrote the line back */
+  if(!entry->sharers) {
+    cache_invalidate(&coh.dir, key, &dir_line_addr);
+    coh.num_valid--;
+  }
+}
@@ -0,0 +1,75 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/coherence.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Sparse directory keeping the private L1s coherent with a MESI
+ *                or MOESI protocol.
+ ***************************************************************************************/
+
+#ifndef __COHERENCE_H__
+#define __COHERENCE_H__
+
+#include "globals/enum.h"
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+#define COHERENCE_PROTOCOL_LIST(elem) elem(NONE) elem(MESI) elem(MOESI)
+
+DECLARE_ENUM(Coherence_Protocol, COHERENCE_PROTOCOL_LIST, COHERENCE_);
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Allocate the directory (nothing to do without a protocol) */
+void init_coherence(void);
+
+/* Account directory occupancy, called every L1 cycle */
+void update_coherence(void);
+
+/* Returns TRUE if coherence_l1_miss() would have another core supply the
+   line of req. Does not change the directory. */
+Flag coherence_l1_forwarded(Mem_Req* req);
+
+/* Called when a demand or prefetch request misses in its private L1. Returns
+   TRUE if another core supplies the line, with the cycles until the data
+   arrives in *latency; otherwise the line comes from memory. Stores also
+   invalidate the other copies. Safe to call again for a retried request. */
+Flag coherence_l1_miss(Mem_Req* req, uns* latency);
+
+/* Called when a request hits in its private L1. Returns the extra cycles a
+   store needs to upgrade a shared line to modified. */
+uns coherence_l1_hit(Mem_Req* req);
+
+/* Called when an on-path store hits in the dcache of proc_id */
+void coherence_dcache_store(uns proc_id, Addr addr);
+
+/* Called when the private L1 of proc_id evicts line_addr. l1_dirty is set if
+   the L1 copy itself was dirty and is being written back. */
+void coherence_l1_evict(uns proc_id, Addr line_addr, Flag l1_dirty);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __COHERENCE_H__ */
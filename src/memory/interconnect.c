@@ -0,0 +1,333 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/interconnect.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : On-chip interconnect between the per-core uncores and the
+ *                L1 slices: a shared bus, a bidirectional ring or a 2D mesh
+ *                with per-link bandwidth and router pipeline latency.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "freq.h"
+#include "memory/interconnect.h"
+#include "memory/mem_req.h"
+#include "memory/memory.param.h"
+#include "statistics.h"
+
+/*
+   The network has one node (tile) per core, and the L1 banks are the slices
+   of the shared L1: slice s sits at node s, so with more banks than cores the
+   extra tiles only hold a slice. With PRIVATE_L1 every core has its own slice
+   at its own node and the network is never crossed.
+
+   Packets use deterministic routing (shortest direction on the ring, XY on
+   the mesh). Every hop costs NOC_ROUTER_CYCLES in the router and
+   NOC_LINK_CYCLES on the link, and every link carries one flit per cycle.
+   Flits are scheduled on each link when the packet is sent: every link keeps
+   a calendar of the cycles it is reserved in, and a flit takes the first free
+   cycle after it gets through the router, so contention is modeled without
+   simulating the router buffers cycle by cycle.
+*/
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_INTERCONNECT, ##args)
+
+/* output links per node: east/clockwise, west/counterclockwise, south, north */
+#define NOC_DIRS 4
+#define NOC_EAST 0
+#define NOC_WEST 1
+#define NOC_SOUTH 2
+#define NOC_NORTH 3
+
+/* cycles ahead of the current cycle a link can be reserved for */
+#define NOC_WINDOW 1024
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Noc_Link_struct {
+  Flag     valid;
+  Counter* slots; /* cycle each calendar slot is reserved for */
+} Noc_Link;
+
+typedef struct Interconnect_struct {
+  uns       num_nodes;
+  uns       cols; /* mesh shape; the last row may be partial */
+  uns       num_links;
+  Noc_Link* links; /* NOC_DIRS output links per node */
+  Counter*  flit_cycles;
+  uns       max_flits;
+} Interconnect;
+
+/**************************************************************************************/
+/* Global Variables */
+
+DEFINE_ENUM(Interconnect_Topology, INTERCONNECT_TOPOLOGY_LIST);
+
+static Interconnect noc;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static uns     noc_neighbor(uns node, uns dir);
+static uns     noc_route(uns node, uns dst);
+static Counter noc_reserve(Noc_Link* link, Counter now, Counter cycle);
+static uns     noc_send(uns proc_id, uns src, uns dst, uns bytes);
+static uns     noc_slice_node(Mem_Req* req);
+
+/**************************************************************************************/
+/* init_interconnect: */
+
+void init_interconnect(void) {
+  if(INTERCONNECT == INTERCONNECT_BUS)
+    return;
+
+  noc.num_nodes = PRIVATE_L1 ? NUM_CORES : MAX2(NUM_CORES, L1_BANKS);
+  noc.cols      = NOC_MESH_COLS;
+  if(!noc.cols) {
+    /* as square as possible */
+    for(noc.cols = 1; noc.cols * noc.cols < noc.num_nodes; noc.cols++)
+      ;
+  }
+  ASSERTM(0, noc.cols <= noc.num_nodes, "NOC_MESH_COLS (%u) > nodes (%u)\n",
+          noc.cols, noc.num_nodes);
+  ASSERT(0, NOC_LINK_BYTES > 0);
+
+  noc.links = (Noc_Link*)calloc(noc.num_nodes * NOC_DIRS, sizeof(Noc_Link));
+  for(uns node = 0; node < noc.num_nodes; node++) {
+    for(uns dir = 0; dir < NOC_DIRS; dir++) {
+      Noc_Link* link = &noc.links[node * NOC_DIRS + dir];
+      if(noc_neighbor(node, dir) == node)
+        continue;
+      link->valid = TRUE;
+      link->slots = (Counter*)malloc(NOC_WINDOW * sizeof(Counter));
+      for(uns ii = 0; ii < NOC_WINDOW; ii++)
+        link->slots[ii] = MAX_CTR;
+      noc.num_links++;
+    }
+  }
+
+  DEBUG(0, "%s interconnect: %u nodes, %u columns, %u links\n",
+        Interconnect_Topology_str(INTERCONNECT), noc.num_nodes, noc.cols,
+        noc.num_links);
+}
+
+/**************************************************************************************/
+/* update_interconnect: */
+
+void update_interconnect(void) {
+  if(INTERCONNECT == INTERCONNECT_BUS)
+    return;
+  /* network-wide stats are kept on core 0 */
+  INC_STAT_EVENT(0, NOC_LINK_TOTAL_CYCLES, noc.num_links);
+}
+
+/**************************************************************************************/
+/* noc_neighbor: the node across the output link dir of node, or node itself
+   if there is no such link */
+
+static uns noc_neighbor(uns node, uns dir) {
+  uns n = noc.num_nodes;
+
+  if(INTERCONNECT == INTERCONNECT_RING) {
+    if(n == 1)
+      return node;
+    switch(dir) {
+      case NOC_EAST:
+        return (node + 1) % n;
+      case NOC_WEST:
+        return n == 2 ? node : (node + n - 1) % n;
+      default:
+        return node;
+    }
+  }
+
+  uns x = node % noc.cols;
+  switch(dir) {
+    case NOC_EAST:
+      return x + 1 < noc.cols && node + 1 < n ? node + 1 : node;
+    case NOC_WEST:
+      return x > 0 ? node - 1 : node;
+    case NOC_SOUTH:
+      return node + noc.cols < n ? node + noc.cols : node;
+    case NOC_NORTH:
+      return node >= noc.cols ? node - noc.cols : node;
+    default:
+      return node;
+  }
+}
+
+/**************************************************************************************/
+/* noc_route: output link node takes towards dst (shortest direction on the
+   ring, X first on the mesh unless the partial last row is in the way) */
+
+static uns noc_route(uns node, uns dst) {
+  ASSERT(0, node != dst);
+
+  if(INTERCONNECT == INTERCONNECT_RING) {
+    uns dist = (dst + noc.num_nodes - node) % noc.num_nodes;
+    return dist <= noc.num_nodes / 2 ? NOC_EAST : NOC_WEST;
+  }
+
+  uns x = node % noc.cols, y = node / noc.cols;
+  uns dx = dst % noc.cols, dy = dst / noc.cols;
+  if(x != dx) {
+    uns dir = x < dx ? NOC_EAST : NOC_WEST;
+    if(noc_neighbor(node, dir) != node)
+      return dir;
+  }
+  ASSERT(0, y != dy);
+  return y < dy ? NOC_SOUTH : NOC_NORTH;
+}
+
+/**************************************************************************************/
+/* noc_reserve: reserve the first free cycle of link at or after cycle */
+
+static Counter noc_reserve(Noc_Link* link, Counter now, Counter cycle) {
+  for(; cycle < now + NOC_WINDOW; cycle++) {
+    Counter* slot = &link->slots[cycle % NOC_WINDOW];
+    if(*slot != cycle) {
+      *slot = cycle;
+      STAT_EVENT(0, NOC_LINK_BUSY_CYCLES);
+      return cycle;
+    }
+  }
+  /* saturated past the calendar, stop tracking the link */
+  return cycle;
+}
+
+/**************************************************************************************/
+/* noc_send: send a packet of bytes from src to dst, reserving the links on
+   the way. Returns the cycles until the tail flit arrives. The network is
+   clocked with the L1, whatever domain the sender is in. */
+
+static uns noc_send(uns proc_id, uns src, uns dst, uns bytes) {
+  uns     flits      = MAX2(1, (bytes + NOC_LINK_BYTES - 1) / NOC_LINK_BYTES);
+  Counter now        = freq_cycle_count(FREQ_DOMAIN_L1);
+  Counter contention = 0;
+  uns     hops       = 0;
+
+  ASSERT(proc_id, src < noc.num_nodes && dst < noc.num_nodes);
+  if(src == dst)
+    return 0;
+
+  if(flits > noc.max_flits) {
+    noc.max_flits   = flits;
+    noc.flit_cycles = (Counter*)realloc(noc.flit_cycles,
+                                        flits * sizeof(Counter));
+  }
+  /* cycle each flit is at the input of the current router */
+  Counter* ready = noc.flit_cycles;
+  for(uns ii = 0; ii < flits; ii++)
+    ready[ii] = now + ii;
+
+  for(uns node = src; node != dst; hops++) {
+    uns       dir  = noc_route(node, dst);
+    Noc_Link* link = &noc.links[node * NOC_DIRS + dir];
+    Counter   last = 0;
+
+    ASSERT(proc_id, link->valid);
+    for(uns ii = 0; ii < flits; ii++) {
+      Counter want = MAX2(ready[ii] + NOC_ROUTER_CYCLES, last + 1);
+      last         = noc_reserve(link, now, want);
+      if(ii == 0)
+        contention += last - want;
+      ready[ii] = last + NOC_LINK_CYCLES;
+    }
+    node = noc_neighbor(node, dir);
+  }
+
+  /* ejection at the destination router */
+  uns latency = ready[flits - 1] + NOC_ROUTER_CYCLES - now;
+  STAT_EVENT(proc_id, NOC_PACKETS);
+  INC_STAT_EVENT(proc_id, NOC_FLITS, flits);
+  INC_STAT_EVENT(proc_id, NOC_HOPS, hops);
+  INC_STAT_EVENT(proc_id, NOC_LATENCY, latency);
+  INC_STAT_EVENT(proc_id, NOC_HOP_LATENCY, latency);
+  INC_STAT_EVENT(proc_id, NOC_CONTENTION_CYCLES, contention);
+  DEBUG(proc_id, "Packet %u->%u  bytes:%u  hops:%u  latency:%u  wait:%llu\n",
+        src, dst, bytes, hops, latency, contention);
+  return latency;
+}
+
+/**************************************************************************************/
+/* noc_slice_node: */
+
+static uns noc_slice_node(Mem_Req* req) {
+  return PRIVATE_L1 ? req->proc_id : req->l1_bank;
+}
+
+/**************************************************************************************/
+/* interconnect_l1_bank: fold the line address so that strided streams spread
+   over the slices */
+
+uns interconnect_l1_bank(Addr addr, uns num_banks) {
+  Addr line = addr >> LOG2(L1_INTERLEAVE_FACTOR);
+  line ^= line >> 17;
+  line ^= line >> 11;
+  line ^= line >> 5;
+  return line % num_banks;
+}
+
+/**************************************************************************************/
+/* interconnect_send_req: */
+
+uns interconnect_send_req(Mem_Req* req) {
+  Flag has_data = req->type == MRT_WB || req->type == MRT_WB_NODIRTY;
+  STAT_EVENT(req->proc_id, NOC_REQ_PACKETS);
+  return noc_send(req->proc_id, req->proc_id, noc_slice_node(req),
+                  NOC_CTRL_BYTES + (has_data ? req->size : 0));
+}
+
+/**************************************************************************************/
+/* interconnect_send_fill: */
+
+uns interconnect_send_fill(Mem_Req* req) {
+  STAT_EVENT(req->proc_id, NOC_FILL_PACKETS);
+  return noc_send(req->proc_id, noc_slice_node(req), req->proc_id,
+                  NOC_CTRL_BYTES + req->size);
+}
+
+/**************************************************************************************/
+/* interconnect_send_msg: message between the tiles of two cores (coherence
+   requests, forwards, invalidations and acks) */
+
+uns interconnect_send_msg(uns proc_id, uns src, uns dst, uns bytes) {
+  if(src == dst)
+    return 0;
+  if(INTERCONNECT == INTERCONNECT_BUS)
+    return MLCQ_TO_L1Q_TRANSFER_LATENCY;
+  return noc_send(proc_id, src, dst, bytes);
+}
@@ -0,0 +1,71 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/interconnect.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : On-chip interconnect between the per-core uncores and the
+ *                L1 slices: a shared bus, a bidirectional ring or a 2D mesh
+ *                with per-link bandwidth and router pipeline latency.
+ ***************************************************************************************/
+
+#ifndef __INTERCONNECT_H__
+#define __INTERCONNECT_H__
+
+#include "globals/enum.h"
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+#define INTERCONNECT_TOPOLOGY_LIST(elem) elem(BUS) elem(RING) elem(MESH)
+
+DECLARE_ENUM(Interconnect_Topology, INTERCONNECT_TOPOLOGY_LIST,
+             INTERCONNECT_);
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Build the ring or mesh (nothing to do for the bus) */
+void init_interconnect(void);
+
+/* Account link utilization, called every L1 cycle */
+void update_interconnect(void);
+
+/* L1 bank (slice) that caches addr, hashed over all slices */
+uns interconnect_l1_bank(Addr addr, uns num_banks);
+
+/* Send a request from the core's uncore to its L1 slice. Returns the cycles
+   until it arrives. */
+uns interconnect_send_req(Mem_Req* req);
+
+/* Send the data of a request from its L1 slice back to the core. Returns the
+   cycles until it arrives. */
+uns interconnect_send_fill(Mem_Req* req);
+
+/* Send a message of bytes between the tiles of cores src and dst on behalf of
+   proc_id. Returns the cycles until it arrives. */
+uns interconnect_send_msg(uns proc_id, uns src, uns dst, uns bytes);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __INTERCONNECT_H__ */
@@ -0,0 +1,278 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/mem_profile.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Extracts the memory-access profile of each core of a cmp run
+ *                in the format replayed by the dumb model.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "general.param.h"
+#include "libs/stack_dist.h"
+#include "memory/mem_profile.h"
+#include "memory/memory.param.h"
+#include "model.h"
+
+/*
+   The profile describes the demand data requests each core sends to the
+   memory system (its dcache misses and write-throughs), in L1_LINE_SIZE
+   lines and L1 cycles, which is what a dumb core generates in their place:
+
+   - reuse: the stack distance of each request over the lines the core
+     requested before, in power-of-two bins. Distances beyond
+     DUMB_MODEL_PROFILE_MAX_REUSE count as cold, as they do in the replay.
+   - stride: the distance from each cold line to the previous cold line.
+     Strides of up to MEM_PROFILE_MAX_STRIDE lines are kept, longer ones
+     become 'rand'.
+   - phase: every DUMB_MODEL_PROFILE_PHASE_CYCLES cycles, the most requests
+     the core had outstanding and the average cycles between its requests.
+     Neighboring phases are merged to fit the phase limit of the replay.
+*/
+
+/**************************************************************************************/
+/* Macros */
+
+#define MEM_PROFILE_MAX_BINS 32   /* DUMB_PROFILE_MAX_BINS in dumb_model.c */
+#define MEM_PROFILE_MAX_PHASES 32 /* DUMB_PROFILE_MAX_PHASES in dumb_model.c */
+#define MEM_PROFILE_MAX_STRIDE 8
+#define MEM_PROFILE_SEEN_BITS 24
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Mem_Profile_Phase_struct {
+  Counter cycles;
+  Counter reqs;
+  uns     mlp; /* most requests outstanding at once */
+} Mem_Profile_Phase;
+
+typedef struct Mem_Profile_Core_struct {
+  Stack_Dist stack;
+  Counter    reuse[MEM_PROFILE_MAX_BINS]; /* bin b covers distances up to
+                                             2^b - 1 */
+  Counter    cold;
+  Counter    stride[2 * MEM_PROFILE_MAX_STRIDE + 1]; /* by stride + max */
+  Counter    stride_rand;
+  Addr       stream_line; /* last cold line */
+  Counter    reads;
+  Counter    writes;
+  uns        outstanding;
+
+  Mem_Profile_Phase  phase;  /* the current phase */
+  Mem_Profile_Phase* phases; /* the finished ones */
+  uns                num_phases;
+  uns                max_phases;
+} Mem_Profile_Core;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Mem_Profile_Core* profile_cores = NULL;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void mem_profile_end_phase(Mem_Profile_Core* core);
+static void mem_profile_write_core(FILE* file, uns proc_id,
+                                   Mem_Profile_Core* core);
+
+/**************************************************************************************/
+/* init_mem_profile: */
+
+void init_mem_profile(void) {
+  if(!DUMB_MODEL_PROFILE_OUT)
+    return;
+  if(SIM_MODEL != CMP_MODEL)
+    FATAL_ERROR(0, "DUMB_MODEL_PROFILE_OUT needs the cmp model\n");
+  if(!DUMB_MODEL_PROFILE_PHASE_CYCLES)
+    FATAL_ERROR(0, "DUMB_MODEL_PROFILE_PHASE_CYCLES must be non-zero\n");
+
+  profile_cores = (Mem_Profile_Core*)calloc(NUM_CORES,
+                                            sizeof(Mem_Profile_Core));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    init_stack_dist(&profile_cores[proc_id].stack, "MEM_PROFILE_STACK",
+                    DUMB_MODEL_PROFILE_MAX_REUSE, MEM_PROFILE_SEEN_BITS);
+  }
+}
+
+/**************************************************************************************/
+/* mem_profile_end_phase: */
+
+static void mem_profile_end_phase(Mem_Profile_Core* core) {
+  if(core->num_phases == core->max_phases) {
+    core->max_phases = MAX2(2 * core->max_phases, 64);
+    core->phases     = (Mem_Profile_Phase*)realloc(
+      core->phases, core->max_phases * sizeof(Mem_Profile_Phase));
+  }
+  core->phases[core->num_phases++] = core->phase;
+  core->phase.cycles               = 0;
+  core->phase.reqs                 = 0;
+  core->phase.mlp                  = core->outstanding;
+}
+
+/**************************************************************************************/
+/* update_mem_profile: */
+
+void update_mem_profile(void) {
+  if(!profile_cores)
+    return;
+
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Mem_Profile_Core* core = &profile_cores[proc_id];
+    if(++core->phase.cycles == DUMB_MODEL_PROFILE_PHASE_CYCLES)
+      mem_profile_end_phase(core);
+  }
+}
+
+/**************************************************************************************/
+/* mem_profile_access: */
+
+void mem_profile_access(uns proc_id, Addr addr, Mem_Req_Type type,
+                        Mem_Req* new_req) {
+  if(!profile_cores || (type != MRT_DFETCH && type != MRT_DSTORE))
+    return;
+
+  Mem_Profile_Core* core = &profile_cores[proc_id];
+  Addr              line = addr >> LOG2(L1_LINE_SIZE);
+  uns               dist = stack_dist_access(&core->stack, line);
+
+  if(dist == STACK_DIST_COLD || dist == STACK_DIST_FAR) {
+    int64 stride = (int64)(line - core->stream_line);
+    if(stride && stride >= -MEM_PROFILE_MAX_STRIDE &&
+       stride <= MEM_PROFILE_MAX_STRIDE)
+      core->stride[stride + MEM_PROFILE_MAX_STRIDE]++;
+    else
+      core->stride_rand++;
+    core->stream_line = line;
+    core->cold++;
+  } else {
+    core->reuse[MIN2(dist ? LOG2(dist) + 1 : 0, MEM_PROFILE_MAX_BINS - 1)]++;
+  }
+
+  if(type == MRT_DSTORE)
+    core->writes++;
+  else
+    core->reads++;
+
+  core->phase.reqs++;
+  if(new_req) {
+    new_req->profiled = TRUE;
+    core->outstanding++;
+    core->phase.mlp = MAX2(core->phase.mlp, core->outstanding);
+  }
+}
+
+/**************************************************************************************/
+/* mem_profile_req_done: */
+
+void mem_profile_req_done(Mem_Req* req) {
+  if(!req->profiled)
+    return;
+  ASSERT(req->proc_id, profile_cores[req->proc_id].outstanding > 0);
+  profile_cores[req->proc_id].outstanding--;
+  req->profiled = FALSE;
+}
+
+/**************************************************************************************/
+/* mem_profile_write_core: */
+
+static void mem_profile_write_core(FILE* file, uns proc_id,
+                                   Mem_Profile_Core* core) {
+  Counter reads  = core->reads;
+  Counter writes = core->writes;
+  uns     last_bin;
+  uns     group;
+
+  fprintf(file, "core %u\n", proc_id);
+
+  /* the replay reads the ratio into uns */
+  while(reads > 0x7fffffff || writes > 0x7fffffff) {
+    reads >>= 1;
+    writes >>= 1;
+  }
+  fprintf(file, "rw %llu %llu\n", reads, writes);
+
+  fprintf(file, "cold %llu\n", core->cold);
+  for(last_bin = MEM_PROFILE_MAX_BINS; last_bin > 0; last_bin--) {
+    if(core->reuse[last_bin - 1])
+      break;
+  }
+  /* empty bins are kept: each bin starts where the previous one ends */
+  for(uns bin = 0; bin < last_bin; bin++) {
+    uns64 max_dist = MIN2((1ULL << bin) - 1,
+                          (uns64)DUMB_MODEL_PROFILE_MAX_REUSE - 1);
+    fprintf(file, "reuse %llu %llu\n", max_dist, core->reuse[bin]);
+  }
+
+  for(int stride = -MEM_PROFILE_MAX_STRIDE; stride <= MEM_PROFILE_MAX_STRIDE;
+      stride++) {
+    Counter weight = core->stride[stride + MEM_PROFILE_MAX_STRIDE];
+    if(weight)
+      fprintf(file, "stride %d %llu\n", stride, weight);
+  }
+  if(core->stride_rand)
+    fprintf(file, "stride rand %llu\n", core->stride_rand);
+
+  if(core->phase.cycles)
+    mem_profile_end_phase(core);
+  group = (core->num_phases + MEM_PROFILE_MAX_PHASES - 1) /
+          MEM_PROFILE_MAX_PHASES;
+  for(uns first = 0; first < core->num_phases; first += group) {
+    Mem_Profile_Phase merged = {0, 0, 0};
+    for(uns ii = first; ii < MIN2(first + group, core->num_phases); ii++) {
+      merged.cycles += core->phases[ii].cycles;
+      merged.reqs += core->phases[ii].reqs;
+      merged.mlp = MAX2(merged.mlp, core->phases[ii].mlp);
+    }
+    fprintf(file, "phase %llu %u %llu\n", merged.cycles, MAX2(merged.mlp, 1),
+            MAX2(merged.reqs ? merged.cycles / merged.reqs : merged.cycles,
+                 1));
+  }
+}
+
+/**************************************************************************************/
+/* finalize_mem_profile: */
+
+void finalize_mem_profile(void) {
+  if(!profile_cores)
+    return;
+
+  FILE* file = fopen(DUMB_MODEL_PROFILE_OUT, "w");
+  if(!file)
+    FATAL_ERROR(0, "Could not open dumb model profile %s\n",
+                DUMB_MODEL_PROFILE_OUT);
+  fprintf(file, "# memory-access profile of a cmp run, replayed with "
+                "DUMB_MODEL_PROFILE\n");
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    mem_profile_write_core(file, proc_id, &profile_cores[proc_id]);
+  fclose(file);
+}
@@ -0,0 +1,58 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/mem_profile.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Extracts the memory-access profile of each core of a cmp run
+ *                in the format replayed by the dumb model.
+ ***************************************************************************************/
+
+#ifndef __MEM_PROFILE_H__
+#define __MEM_PROFILE_H__
+
+#include "globals/global_types.h"
+#include "memory/mem_req.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Start profiling if DUMB_MODEL_PROFILE_OUT names a file */
+void init_mem_profile(void);
+
+/* Advance the current phase, called every L1 cycle */
+void update_mem_profile(void);
+
+/* Record a demand data request of a core entering the memory system. new_req
+   is the request allocated for it, or NULL if it merged into another one. */
+void mem_profile_access(uns proc_id, Addr addr, Mem_Req_Type type,
+                        Mem_Req* new_req);
+
+/* Called when a request buffer is freed */
+void mem_profile_req_done(Mem_Req* req);
+
+/* Write the profile of every core */
+void finalize_mem_profile(void);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __MEM_PROFILE_H__ */
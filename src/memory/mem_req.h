@@ -139,6 +139,7 @@ struct Mem_Req_struct {
   Flag    l1_miss_satisfied; /* did this request miss in L1 and it is already
                                 satisfied? */
   Counter l1_miss_cycle;     /* cycle when this req missed in L1 */
+  Flag    cache_to_cache;    /* was the L1 miss served by another core? */
   Counter mem_queue_cycle;   /* cycle this request entered the mem_queue */
   Counter mem_crit_path_at_entry; /* DVFS perf pred: the global critical path
                                      estimate when the req entered the memory
@@ -153,6 +154,9 @@ struct Mem_Req_struct {
   Flag bw_prefetchable;   /* would this request be a bandwidth prefetch if there
                              was more BW? */
   Flag dirty_l0;          /* should this request dirty the L0 (dcache) line? */
+  Flag dirty_line; /* store from new_mem_dirty_req (no cache above it): dirty
+                      the line in the closest cache it fills or hits */
+  Flag profiled;   /* counted as outstanding by the memory profile */
   Flag wb_requested_back; /* is this a writeback that is requested by the core
                              again? */
   Destination destination; /* which cache level are we filling (only value of L1
@@ -40,6 +40,10 @@
 #include "addr_trans.h"
 #include "bp/bp.h"
 #include "cache_part.h"
+#include "coherence.h"
+#include "interconnect.h"
+#include "map.h"
+#include "mem_profile.h"
 #include "mem_req.h"
 #include "memory.h"
 #include "op.h"
@@ -140,6 +144,9 @@ static Flag mem_complete_l1_access(Mem_Req*         req,
                                    Mem_Queue_Entry* l1_queue_entry,
                                    int* bus_out_queue_insertion_count,
                                    int* reserved_entry_count);
+static void mem_complete_cache_to_cache(Mem_Req*         req,
+                                        Mem_Queue_Entry* l1_queue_entry,
+                                        uns              latency);
 
 static inline Mem_Queue_Entry* mem_insert_req_into_queue(Mem_Req*   new_req,
                                                          Mem_Queue* queue,
@@ -183,6 +190,10 @@ static void mem_init_new_req(Mem_Req* new_req, Mem_Req_Type type,
                              uns size, uns delay, Op* op,
                              Flag done_func(Mem_Req*), Counter unique_num,
                              Flag kicked_out, Counter new_priority);
+static Flag mem_new_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
+                        uns delay, Op* op, Flag done_func(Mem_Req*),
+                        Counter unique_num, Pref_Req_Info* pref_info,
+                        Flag dirty_line);
 
 static inline void init_mem_queue(Mem_Queue* queue, char* name, uns size,
                                   Mem_Queue_Type type);
@@ -206,6 +217,8 @@ static L1_Data*    l1_pref_cache_access(Mem_Req* req);
 
 static inline Flag queue_full(Mem_Queue* queue);
 static inline uns  queue_num_free(Mem_Queue* queue);
+static inline uns  mem_to_l1_latency(Mem_Req* req);
+static inline uns  mem_from_l1_latency(Mem_Req* req);
 
 Flag is_final_state(Mem_Req_State state);
 
@@ -364,6 +377,10 @@ void init_memory() {
 
   init_uncores();
 
+  init_interconnect();
+  init_coherence();
+  init_mem_profile();
+
   init_cache(&mem->pref_l1_cache, "L1_PREF_CACHE", L1_PREF_CACHE_SIZE,
              L1_PREF_CACHE_ASSOC, L1_LINE_SIZE, sizeof(L1_Data),
              L1_CACHE_REPL_POLICY);
@@ -618,6 +635,7 @@ void mem_free_reqbuf(Mem_Req* req) {
   }
 
   perf_pred_l0_miss_end(req);
+  mem_profile_req_done(req);
 
   ASSERT(req->proc_id, mem->num_req_buffers_per_core[req->proc_id] > 0);
   mem->num_req_buffers_per_core[req->proc_id] -= 1;
@@ -660,6 +678,26 @@ static inline uns queue_num_free(Mem_Queue* queue) {
   return (queue->size - queue->reserved_entry_count) - queue->entry_count;
 }
 
+/**************************************************************************************/
+/* mem_to_l1_latency: cycles for a request to get from the core's uncore to
+   its L1 slice */
+
+static inline uns mem_to_l1_latency(Mem_Req* req) {
+  if(INTERCONNECT == INTERCONNECT_BUS)
+    return MLCQ_TO_L1Q_TRANSFER_LATENCY;
+  return interconnect_send_req(req);
+}
+
+/**************************************************************************************/
+/* mem_from_l1_latency: extra cycles for the data of a request to get from
+   its L1 slice back to the core's uncore (none on the bus) */
+
+static inline uns mem_from_l1_latency(Mem_Req* req) {
+  if(INTERCONNECT == INTERCONNECT_BUS)
+    return 0;
+  return interconnect_send_fill(req);
+}
+
 
 /**************************************************************************************/
 /* print_mem_queue: */
@@ -843,6 +881,8 @@ void update_memory_queues() {
 
 void update_on_chip_memory_stats() {
   STAT_EVENT_ALL(L1_CYCLE);
+  update_interconnect();
+  update_coherence();
   STAT_EVENT(0, MIN2(MEM_REQ_DEMANDS__0 + mem_req_demand_entries / 4,
                      MEM_REQ_DEMANDS_64));
   STAT_EVENT(
@@ -880,6 +920,7 @@ void update_memory() {
     pref_update();
     update_memory_queues();
     update_on_chip_memory_stats();
+    update_mem_profile();
 
     mem_process_mlc_fill_reqs();
     mem_process_l1_fill_reqs();
@@ -1005,6 +1046,8 @@ Flag mem_process_l1_hit_access(Mem_Req* req, Mem_Queue_Entry* l1_queue_entry,
                                int lru_position) {
   Flag fill_mlc = MLC_PRESENT && req->destination != DEST_L1 &&
                   (req->type != MRT_WB && req->type != MRT_WB_NODIRTY);
+  /* stores to shared lines wait for the other copies to be invalidated */
+  uns coherence_cycles = coherence_l1_hit(req);
 
   if(data) { /* not perfect l1 */
     if((req->type == MRT_DFETCH) || (req->type == MRT_DSTORE) ||
@@ -1057,7 +1100,7 @@ Flag mem_process_l1_hit_access(Mem_Req* req, Mem_Queue_Entry* l1_queue_entry,
       STAT_EVENT(req->proc_id, L1_WB_HIT);
       STAT_EVENT(req->proc_id, CORE_L1_WB_HIT);
     }
-    data->dirty |= (req->type == MRT_WB);
+    data->dirty |= (req->type == MRT_WB) || (req->dirty_line && !fill_mlc);
   }
 
   DEBUG(req->proc_id,
@@ -1100,7 +1143,8 @@ Flag mem_process_l1_hit_access(Mem_Req* req, Mem_Queue_Entry* l1_queue_entry,
     req->rdy_cycle = cycle_count + L1Q_TO_FSB_TRANSFER_LATENCY;
   } else if(fill_mlc) {
     req->state     = MRS_FILL_MLC;
-    req->rdy_cycle = cycle_count + 1;
+    req->rdy_cycle = cycle_count + 1 + mem_from_l1_latency(req) +
+                     coherence_cycles;
     // insert into mlc queue
     req->queue = &(mem->mlc_fill_queue);
     if(!ORDER_BEYOND_BUS)
@@ -1117,8 +1161,9 @@ Flag mem_process_l1_hit_access(Mem_Req* req, Mem_Queue_Entry* l1_queue_entry,
     mem_free_reqbuf(req);
   } else {
     req->state     = MRS_L1_HIT_DONE;
-    req->rdy_cycle = freq_cycle_count(
-      FREQ_DOMAIN_CORES[req->proc_id]);  // no +1 to match old performance
+    req->rdy_cycle = freq_cycle_count(FREQ_DOMAIN_CORES[req->proc_id]) +
+                     mem_from_l1_latency(req) +
+                     coherence_cycles;  // no +1 to match old performance
     // insert into core fill queue
     req->queue = &(mem->core_fill_queues[req->proc_id]);
     if(!ORDER_BEYOND_BUS)
@@ -1184,7 +1229,7 @@ Flag mem_process_mlc_hit_access(Mem_Req* req, Mem_Queue_Entry* mlc_queue_entry,
         STAT_EVENT(req->proc_id, MLC_WB_HIT);
         STAT_EVENT(req->proc_id, CORE_MLC_WB_HIT);
       }
-      data->dirty |= (req->type == MRT_WB);
+      data->dirty |= (req->type == MRT_WB) || req->dirty_line;
     }
 
     if((req->type == MRT_DFETCH) || (req->type == MRT_DSTORE) ||
@@ -1209,7 +1254,7 @@ Flag mem_process_mlc_hit_access(Mem_Req* req, Mem_Queue_Entry* mlc_queue_entry,
 
     if(MLC_WRITE_THROUGH && (req->type == MRT_WB)) {
       req->state     = MRS_L1_NEW;
-      req->rdy_cycle = cycle_count + MLCQ_TO_L1Q_TRANSFER_LATENCY;
+      req->rdy_cycle = cycle_count + mem_to_l1_latency(req);
     } else {  // writeback done
       /* Remove the entry from request buffer */
       req->state = MRS_MLC_HIT_DONE;
@@ -1441,7 +1486,7 @@ static Flag mem_process_mlc_miss_access(Mem_Req*         req,
       mlc_fill_line(req);
       if(MLC_WRITE_THROUGH && req->type == MRT_WB) {
         req->state     = MRS_L1_NEW;
-        req->rdy_cycle = cycle_count + MLCQ_TO_L1Q_TRANSFER_LATENCY;
+        req->rdy_cycle = cycle_count + mem_to_l1_latency(req);
       } else {  // CMP write back
         req->state     = MRS_MLC_HIT_DONE;
         req->rdy_cycle = cycle_count + 1;
@@ -1455,9 +1500,9 @@ static Flag mem_process_mlc_miss_access(Mem_Req*         req,
   if(!queue_full(&mem->l1_queue)) {
     req->state     = MRS_L1_NEW;
     req->rdy_cycle = cycle_count +
-                     MLCQ_TO_L1Q_TRANSFER_LATENCY; /* this req will be ready to
-                                                      be sent to memory in the
-                                                      next cycle */
+                     mem_to_l1_latency(req); /* this req will be ready to be
+                                                sent to memory in the next
+                                                cycle */
     /* Set the priority so that this entry will be removed from the mlc_queue */
     mlc_queue_entry->priority = Mem_Req_Priority_Offset[MRT_MIN_PRIORITY];
     return TRUE;
@@ -1627,7 +1672,17 @@ static Flag mem_complete_l1_access(Mem_Req*         req,
       l1_miss_send_bus = FALSE;
     Flag l1_miss_access = mem_process_l1_miss_access(req, l1_queue_entry,
                                                      &line_addr, data);
-    if(l1_miss_access && l1_miss_send_bus) {
+    uns  coherence_cycles;
+    if(l1_miss_access && l1_miss_send_bus && coherence_l1_forwarded(req) &&
+       queue_full(&mem->l1fill_queue)) {
+      // a line forwarded by another core needs an l1fill_queue entry; try
+      // again later, as for a request that memory rejects
+      STAT_EVENT(req->proc_id, REJECTED_QUEUE_L1FILL);
+      access_done = FALSE;
+    } else if(l1_miss_access && l1_miss_send_bus &&
+              coherence_l1_miss(req, &coherence_cycles)) {
+      mem_complete_cache_to_cache(req, l1_queue_entry, coherence_cycles);
+    } else if(l1_miss_access && l1_miss_send_bus) {
       if(CONSTANT_MEMORY_LATENCY) {
         mem->uncores[req->proc_id].num_outstanding_l1_misses++;
         mem_complete_bus_in_access(req, l1_queue_entry->priority);
@@ -2405,6 +2460,37 @@ void mem_complete_bus_in_access(Mem_Req* req, Counter priority) {
   }
 }
 
+/**************************************************************************************/
+/* mem_complete_cache_to_cache: another core's L1 supplies the line, so the
+   request skips memory and fills the L1 after the coherence latency */
+
+static void mem_complete_cache_to_cache(Mem_Req*         req,
+                                        Mem_Queue_Entry* l1_queue_entry,
+                                        uns              latency) {
+  DEBUG(req->proc_id,
+        "Mem request served by another core  index:%ld  type:%s  addr:0x%s  "
+        "latency:%u\n",
+        (long int)(req - mem->req_buffer), Mem_Req_Type_str(req->type),
+        hexstr64s(req->addr), latency);
+
+  req->state          = MRS_FILL_L1;
+  req->rdy_cycle      = cycle_count + latency;
+  req->cache_to_cache = TRUE;
+
+  req->queue = &(mem->l1fill_queue);
+  if(!ORDER_BEYOND_BUS)
+    mem_insert_req_into_queue(req, req->queue,
+                              ALL_FIFO_QUEUES ? l1fill_seq_num :
+                                                l1_queue_entry->priority);
+  else
+    mem_insert_req_into_queue(req, req->queue,
+                              ALL_FIFO_QUEUES ? l1fill_seq_num : 0);
+  l1fill_seq_num++;
+
+  /* Set the priority so that this entry will be removed from the l1_queue */
+  l1_queue_entry->priority = Mem_Req_Priority_Offset[MRT_MIN_PRIORITY];
+}
+
 static void remove_from_l1_fill_queue(uns  proc_id,
                                       int* p_l1fill_queue_removal_count) {
   /* Remove requests from l1 fill queue */
@@ -2458,16 +2544,16 @@ static void mem_process_l1_fill_reqs() {
             hexstr64s(req->addr), req->size, mem_req_state_names[req->state]);
       if(l1_fill_line(req)) {
         ASSERT(0, req->type != MRT_WB && req->type != MRT_WB_NODIRTY);
-        if(CONSTANT_MEMORY_LATENCY)
+        if(CONSTANT_MEMORY_LATENCY && !req->cache_to_cache)
           perf_pred_mem_req_done(req);
         if(MLC_PRESENT && req->destination != DEST_L1) {
           req->state     = MRS_FILL_MLC;
-          req->rdy_cycle = cycle_count + 1;
+          req->rdy_cycle = cycle_count + 1 + mem_from_l1_latency(req);
         } else {
           req->state     = MRS_FILL_DONE;
           req->rdy_cycle = cycle_count + 1;
         }
-        if(PERF_PRED_REQS_FINISH_AT_FILL) {
+        if(PERF_PRED_REQS_FINISH_AT_FILL && !req->cache_to_cache) {
           perf_pred_mem_req_done(req);
         }
         if(req->type == MRT_IFETCH || req->type == MRT_DFETCH ||
@@ -2510,8 +2596,9 @@ static void mem_process_l1_fill_reqs() {
 
         remove_from_l1_fill_queue(req->proc_id, &l1fill_queue_removal_count);
       } else {
-        req->rdy_cycle = freq_cycle_count(
-          FREQ_DOMAIN_CORES[req->proc_id]);  // no +1 to match old performance
+        req->rdy_cycle = freq_cycle_count(FREQ_DOMAIN_CORES[req->proc_id]) +
+                         mem_from_l1_latency(req);  // no +1 to match old
+                                                    // performance
         // insert into core fill queue
         req->queue = &(mem->core_fill_queues[req->proc_id]);
         if(!ORDER_BEYOND_BUS)
@@ -3438,7 +3525,9 @@ static void mem_init_new_req(
   */
   new_req->mlc_bank = BANK(addr, MLC(proc_id)->num_banks,
                            MLC_INTERLEAVE_FACTOR);
-  new_req->l1_bank  = BANK(addr, L1(proc_id)->num_banks, L1_INTERLEAVE_FACTOR);
+  new_req->l1_bank  = INTERCONNECT == INTERCONNECT_BUS ?
+                       BANK(addr, L1(proc_id)->num_banks, L1_INTERLEAVE_FACTOR) :
+                       interconnect_l1_bank(addr, L1(proc_id)->num_banks);
   new_req->start_cycle          = freq_cycle_count(FREQ_DOMAIN_L1) + delay;
   new_req->rdy_cycle            = freq_cycle_count(FREQ_DOMAIN_L1) + delay;
   new_req->first_stalling_cycle = mem_req_type_is_stalling(type) ?
@@ -3453,6 +3542,7 @@ static void mem_init_new_req(
   new_req->l1_miss              = FALSE;
   new_req->l1_miss_satisfied    = FALSE;
   new_req->l1_miss_cycle        = MAX_CTR;
+  new_req->cache_to_cache       = FALSE;
   new_req->oldest_op_unique_num = (Counter)0;
   new_req->oldest_op_op_num     = (Counter)0;
   new_req->oldest_op_addr       = (Addr)0;
@@ -3460,6 +3550,8 @@ static void mem_init_new_req(
   new_req->onpath_match_offpath  = FALSE;
   new_req->demand_match_prefetch = FALSE;
   new_req->dirty_l0 = op && op->table_info->mem_type == MEM_ST && !op->off_path;
+  new_req->dirty_line          = FALSE;
+  new_req->profiled            = FALSE;
   new_req->wb_requested_back   = FALSE;
   new_req->wb_used_onpath      = FALSE;
   new_req->mem_seq_num         = 0;
@@ -3520,6 +3612,11 @@ static void mem_init_new_req(
       addr, NUM_ADDR_NON_SIGN_EXTEND_BITS, TRUE);
   }
 
+  /* without an MLC the request crosses the interconnect to its L1 slice
+     right away */
+  if(!to_mlc && INTERCONNECT != INTERCONNECT_BUS)
+    new_req->rdy_cycle += interconnect_send_req(new_req);
+
   DEBUG(new_req->proc_id,
         "New mem request is initiated index:%ld type:%s addr:0x%s state:%s\n",
         (long int)(new_req - mem->req_buffer), Mem_Req_Type_str(new_req->type),
@@ -3603,6 +3700,28 @@ Flag new_mem_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
                  uns delay, Op* op, Flag done_func(Mem_Req*),
                  Counter unique_num, /* This counter is used when op is NULL */
                  Pref_Req_Info* pref_info) {
+  return mem_new_req(type, proc_id, addr, size, delay, op, done_func,
+                     unique_num, pref_info, FALSE);
+}
+
+/**************************************************************************************/
+/* new_mem_dirty_req: */
+/* A store from a requester without a cache of its own (the dumb model): the
+   line is dirtied in the closest cache it fills or hits */
+
+Flag new_mem_dirty_req(uns8 proc_id, Addr addr, uns size, uns delay,
+                       Flag done_func(Mem_Req*), Counter unique_num) {
+  return mem_new_req(MRT_DSTORE, proc_id, addr, size, delay, NULL, done_func,
+                     unique_num, NULL, TRUE);
+}
+
+/**************************************************************************************/
+/* mem_new_req: */
+
+static Flag mem_new_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
+                        uns delay, Op* op, Flag done_func(Mem_Req*),
+                        Counter unique_num, Pref_Req_Info* pref_info,
+                        Flag dirty_line) {
   Mem_Req*         new_req              = NULL;
   Mem_Req*         matching_req         = NULL;
   Mem_Queue_Entry* queue_entry          = NULL;
@@ -3696,10 +3815,15 @@ Flag new_mem_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
     }
 
     // cmp FIXME cmp support
-    return (mem_adjust_matching_request(
-      matching_req, type, addr, size, destination, delay, op, done_func,
-      unique_num, demand_hit_prefetch, demand_hit_writeback, &queue_entry,
-      new_priority, ramulator_match));
+    if(!mem_adjust_matching_request(
+         matching_req, type, addr, size, destination, delay, op, done_func,
+         unique_num, demand_hit_prefetch, demand_hit_writeback, &queue_entry,
+         new_priority, ramulator_match))
+      return FALSE;
+    matching_req->dirty_line |= dirty_line;
+    if(op)
+      mem_profile_access(proc_id, addr, type, NULL);
+    return TRUE;
   }
 
   /* Step 2.5: Check if there is space in the appropriate queue */
@@ -3826,6 +3950,9 @@ Flag new_mem_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
   mem_init_new_req(new_req, type, to_mlc ? QUEUE_MLC : QUEUE_L1, proc_id, addr,
                    size, delay, op, done_func, unique_num, kicked_out,
                    new_priority);
+  new_req->dirty_line = dirty_line;
+  if(op)
+    mem_profile_access(proc_id, addr, type, new_req);
 
   /* Step 6: Insert the request into the appropriate queue if it is not already
    * there */
@@ -4080,6 +4207,16 @@ static Flag new_mem_mlc_wb_req(Mem_Req_Type type, uns8 proc_id, Addr addr,
 }
 
 
+/**************************************************************************************/
+/* new_mem_coherence_wb_req: write back a dirty line that the coherence
+   protocol took from the L1 of proc_id. Returns FALSE if it must be retried. */
+
+Flag new_mem_coherence_wb_req(uns8 proc_id, Addr addr) {
+  return new_mem_l1_wb_req(MRT_WB, proc_id, addr, L1_LINE_SIZE, 0, NULL, NULL,
+                           unique_count);
+}
+
+
 static Flag new_mem_l1_wb_req(Mem_Req_Type type, uns8 proc_id, Addr addr,
                               uns size, uns delay, Op* op,
                               Flag    done_func(Mem_Req*),
@@ -4254,6 +4391,7 @@ void op_nuke_mem_req(Op* op) {
 Flag l1_fill_line(Mem_Req* req) {
   L1_Data* data;
   Addr     line_addr, repl_line_addr = 0;
+  Flag     repl_dirty = FALSE;
   Op*      top;
   int      tmp_num = 0;
   UNUSED(tmp_num);
@@ -4304,6 +4442,7 @@ Flag l1_fill_line(Mem_Req* req) {
 
   /* If we are replacing anything, check if we need to write it back */
   if(repl_line_valid) {
+    repl_dirty = data->dirty;
     if(!L1_WRITE_THROUGH && !L1_IGNORE_WB && data->dirty) {
       /* need to do a write-back */
       DEBUG(data->proc_id, "Scheduling writeback of addr:0x%s\n",
@@ -4475,6 +4614,8 @@ Flag l1_fill_line(Mem_Req* req) {
     data = (L1_Data*)cache_insert(&L1(req->proc_id)->cache, req->proc_id,
                                   req->addr, &line_addr, &repl_line_addr);
   }
+  if(repl_line_addr)
+    coherence_l1_evict(req->proc_id, repl_line_addr, repl_dirty);
 
   STAT_EVENT(req->proc_id, NORESET_L1_FILL);
   if(mem_req_type_is_prefetch(req->type) || req->demand_match_prefetch)
@@ -4553,6 +4694,9 @@ Flag l1_fill_line(Mem_Req* req) {
                  (req->state != MRS_FILL_L1));  // write back can fill l1
                                                 // directly - reqs filling core
                                                 // should not dirty the line
+  /* an op-less store dirties the l1 unless the line goes on to the mlc */
+  data->dirty |= req->dirty_line &&
+                 !(MLC_PRESENT && req->destination != DEST_L1);
   data->prefetch = req->type == MRT_DPRF || req->type == MRT_IPRF ||
                    req->demand_match_prefetch;
   data->seen_prefetch = req->demand_match_prefetch; /* If demand matches
@@ -4793,6 +4937,7 @@ Flag mlc_fill_line(Mem_Req* req) {
                  (req->state != MRS_FILL_MLC));  // write back can fill mlc
                                                  // directly - reqs filling core
                                                  // should not dirty the line
+  data->dirty |= req->dirty_line;
   data->prefetch = req->type == MRT_DPRF || req->type == MRT_IPRF ||
                    req->demand_match_prefetch;
   data->seen_prefetch = req->demand_match_prefetch; /* If demand matches
@@ -4975,30 +5120,35 @@ void mark_ops_as_l1_miss_satisfied(Mem_Req* req) {
 /* recursively go through the wake up lists of the op and mark ops as
  * l1_miss_dep */
 static void mark_l1_miss_deps(Op* op) {
-  Wake_Up_Entry* temp;
+  Wake_Up_Chunk* chunk;
+  uns            jj;
 
   ASSERT(op->proc_id,
          (op->engine_info.l1_miss && !op->engine_info.l1_miss_satisfied) ||
            op->engine_info.dep_on_l1_miss);
 
-  for(temp = op->wake_up_head; temp; temp = temp->next) {
-    Op*     dep_op         = temp->op;
-    Counter dep_unique_num = temp->unique_num;
-
-
-    if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
-      ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
-      /*printf("MARK c: %s dep_op: %s %s %s %s op: %s %s %s %s\n",
-         unsstr64(cycle_count), unsstr64(dep_op->unique_num),
-         unsstr64(dep_op->exec_cycle), disasm_op(dep_op, TRUE),
-         unsstr64(dep_op->oracle_info.va), unsstr64(op->unique_num),
-         unsstr64(op->exec_cycle), disasm_op(op, TRUE),
-         unsstr64(op->oracle_info.va)); */
-      ASSERT(dep_op->proc_id, !dep_op->engine_info.l1_miss ||
-                                dep_op->table_info->mem_type == MEM_ST);
-      if(!dep_op->engine_info.dep_on_l1_miss) {
-        dep_op->engine_info.dep_on_l1_miss = TRUE;
-        mark_l1_miss_deps(dep_op);
+  for(chunk = wake_up_list_head(op); chunk;
+      chunk = wake_up_list_next(op, chunk)) {
+    for(jj = 0; jj < chunk->count; jj++) {
+      Wake_Up_Entry* temp           = &chunk->entries[jj];
+      Op*            dep_op         = temp->op;
+      Counter        dep_unique_num = temp->unique_num;
+
+
+      if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
+        ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
+        /*printf("MARK c: %s dep_op: %s %s %s %s op: %s %s %s %s\n",
+           unsstr64(cycle_count), unsstr64(dep_op->unique_num),
+           unsstr64(dep_op->exec_cycle), disasm_op(dep_op, TRUE),
+           unsstr64(dep_op->oracle_info.va), unsstr64(op->unique_num),
+           unsstr64(op->exec_cycle), disasm_op(op, TRUE),
+           unsstr64(op->oracle_info.va)); */
+        ASSERT(dep_op->proc_id, !dep_op->engine_info.l1_miss ||
+                                  dep_op->table_info->mem_type == MEM_ST);
+        if(!dep_op->engine_info.dep_on_l1_miss) {
+          dep_op->engine_info.dep_on_l1_miss = TRUE;
+          mark_l1_miss_deps(dep_op);
+        }
       }
     }
   }
@@ -5010,7 +5160,8 @@ static void mark_l1_miss_deps(Op* op) {
  * l1_miss_dep */
 
 static void unmark_l1_miss_deps(Op* op) {
-  Wake_Up_Entry* temp;
+  Wake_Up_Chunk* chunk;
+  uns            jj;
 
   ASSERT(op->proc_id, op->engine_info.l1_miss_satisfied ||
                         (!op->engine_info.dep_on_l1_miss &&
@@ -5018,43 +5169,47 @@ static void unmark_l1_miss_deps(Op* op) {
 
   /* Go thru the wake up list and unmark ops if they are not dependent on
    * another l1 miss */
-  for(temp = op->wake_up_head; temp; temp = temp->next) {
-    Op*     dep_op         = temp->op;
-    Counter dep_unique_num = temp->unique_num;
-
-    if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
-      int      ii;
-      Op_Info* op_info              = &dep_op->oracle_info;
-      Flag     still_dep_on_l1_miss = FALSE;
-
-      ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
-      ASSERT(dep_op->proc_id, dep_op->engine_info.dep_on_l1_miss ||
-                                dep_op->engine_info.was_dep_on_l1_miss);
-
-      if(dep_op->engine_info.dep_on_l1_miss) {
-        /* Determine if the op is dependent on another l1_miss */
-        for(ii = 0; ii < op_info->num_srcs; ii++) {
-          Src_Info* src_info = &op_info->src_info[ii];
-          Op*       src_op   = src_info->op;
-
-          if(src_op->unique_num == src_info->unique_num &&
-             src_op->op_pool_valid) {
-            if(src_op->unique_num != op->unique_num)
-              if((src_op->engine_info.l1_miss &&
-                  !src_op->engine_info.l1_miss_satisfied) ||
-                 src_op->engine_info.dep_on_l1_miss)
-                still_dep_on_l1_miss = TRUE;
+  for(chunk = wake_up_list_head(op); chunk;
+      chunk = wake_up_list_next(op, chunk)) {
+    for(jj = 0; jj < chunk->count; jj++) {
+      Wake_Up_Entry* temp           = &chunk->entries[jj];
+      Op*            dep_op         = temp->op;
+      Counter        dep_unique_num = temp->unique_num;
+
+      if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
+        int      ii;
+        Op_Info* op_info              = &dep_op->oracle_info;
+        Flag     still_dep_on_l1_miss = FALSE;
+
+        ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
+        ASSERT(dep_op->proc_id, dep_op->engine_info.dep_on_l1_miss ||
+                                  dep_op->engine_info.was_dep_on_l1_miss);
+
+        if(dep_op->engine_info.dep_on_l1_miss) {
+          /* Determine if the op is dependent on another l1_miss */
+          for(ii = 0; ii < op_info->num_srcs; ii++) {
+            Src_Info* src_info = &op_info->src_info[ii];
+            Op*       src_op   = src_info->op;
+
+            if(src_op->unique_num == src_info->unique_num &&
+               src_op->op_pool_valid) {
+              if(src_op->unique_num != op->unique_num)
+                if((src_op->engine_info.l1_miss &&
+                    !src_op->engine_info.l1_miss_satisfied) ||
+                   src_op->engine_info.dep_on_l1_miss)
+                  still_dep_on_l1_miss = TRUE;
+            }
+            if(still_dep_on_l1_miss)
+              break;
           }
-          if(still_dep_on_l1_miss)
-            break;
-        }
 
-        /* If the op is not dependent on another l1 miss, then go ahead and
-           unmark it and figure out if we need to unmark its dependents */
-        if(!still_dep_on_l1_miss) {
-          dep_op->engine_info.dep_on_l1_miss     = FALSE;
-          dep_op->engine_info.was_dep_on_l1_miss = TRUE;
-          unmark_l1_miss_deps(dep_op);
+          /* If the op is not dependent on another l1 miss, then go ahead and
+             unmark it and figure out if we need to unmark its dependents */
+          if(!still_dep_on_l1_miss) {
+            dep_op->engine_info.dep_on_l1_miss     = FALSE;
+            dep_op->engine_info.was_dep_on_l1_miss = TRUE;
+            unmark_l1_miss_deps(dep_op);
+          }
         }
       }
     }
@@ -5157,6 +5312,7 @@ void stats_per_core_collect(uns8 proc_id) {
 /* mem_done */
 void finalize_memory() {
   perf_pred_done();
+  finalize_mem_profile();
 }
 
 /***************************************************************************************/
@@ -231,12 +231,15 @@ L1_Data* do_mlc_access_addr(Addr);
 Flag new_mem_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
                  uns delay, Op* op, Flag done_func(Mem_Req*),
                  Counter unique_num, Pref_Req_Info*);
+Flag new_mem_dirty_req(uns8 proc_id, Addr addr, uns size, uns delay,
+                       Flag done_func(Mem_Req*), Counter unique_num);
 void mem_free_reqbuf(Mem_Req* req);
 void mem_complete_bus_in_access(Mem_Req* req, Counter priority);
 void print_mem_queue(Mem_Queue_Type queue_type);
 Flag new_mem_dc_wb_req(Mem_Req_Type type, uns8 proc_id, Addr addr, uns size,
                        uns delay, Op* op, Flag done_func(Mem_Req*),
                        Counter unique_num, Flag used_onpath);
+Flag new_mem_coherence_wb_req(uns8 proc_id, Addr addr);
 Flag mlc_fill_line(Mem_Req* req);
 Flag l1_fill_line(Mem_Req* req);
 
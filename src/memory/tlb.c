@@ -0,0 +1,549 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/tlb.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Per-core L1 instruction/data TLBs, a shared second level TLB
+ *                and a page walker that loads page-table entries through the
+ *                data cache.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "dcache_stage.h"
+#include "debug/debug.param.h"
+#include "libs/cache_lib.h"
+#include "memory/memory.h"
+#include "memory/memory.param.h"
+#include "memory/tlb.h"
+#include "statistics.h"
+
+/*
+   Translations follow x86-64 4-level paging: 4KB pages, and 2MB huge pages
+   whose walk ends at the page directory. There is no OS, so the page tables
+   are laid out by the simulator: the table at each level lives at an address
+   derived from the virtual address bits above it, in a physical region above
+   the user address space. Neighboring pages therefore share page-table lines
+   the same way they would with real page tables.
+
+   All the TLB-like structures are Caches with one-byte "lines", indexed by
+   the virtual address shifted down to the page (or page-table entry) number.
+
+   A miss in the L1 TLB allocates a Tlb_Miss entry, which stays until the
+   second level TLB lookup or the page walk is done and then fills the L1
+   TLB. Retries of the access find the entry and are not counted as new
+   misses. Misses that find every walker busy wait in their entry and start
+   a walk as soon as one is free.
+*/
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_TLB, ##args)
+
+#define TLB_VA_BITS 48
+#define TLB_PAGE_BITS 12
+#define TLB_HUGE_PAGE_BITS 21
+#define TLB_LEVEL_BITS 9
+#define TLB_LEVELS 4
+#define TLB_PTE_SIZE 8
+#define TLB_PT_REGION_BIT 47
+
+/* number of virtual address bits translated below the given level */
+#define TLB_LEVEL_SHIFT(level) \
+  (TLB_PAGE_BITS + TLB_LEVEL_BITS * ((level) - 1))
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Tlb_Data_struct {
+  Counter rdy_cycle; /* cycle the translation can be used */
+} Tlb_Data;
+
+typedef enum Tlb_Walk_State_enum {
+  WALK_IDLE,        /* walker is free */
+  WALK_ISSUE,       /* load of the current level's entry needs to be sent */
+  WALK_WAIT_DCACHE, /* entry hit in the dcache, ready at rdy_cycle */
+  WALK_WAIT_MEM,    /* entry missed in the dcache, waiting for the fill */
+} Tlb_Walk_State;
+
+typedef struct Tlb_Walk_struct {
+  Tlb_Walk_State state;
+  Addr           va;
+  Flag           huge;
+  Flag           inst;
+  uns            level;     /* page-table level being loaded (4 = PML4) */
+  Addr           line_addr; /* dcache line holding the current entry */
+  Counter        rdy_cycle;
+  Counter        start_cycle;
+} Tlb_Walk;
+
+typedef struct Tlb_Miss_struct {
+  Flag    valid;
+  Flag    inst;
+  Flag    huge;
+  Flag    queued;    /* waiting for a free page walker */
+  Addr    va;
+  Addr    key;
+  Counter miss_cycle;
+  Counter rdy_cycle; /* MAX_CTR until the page walk is done */
+} Tlb_Miss;
+
+typedef struct Core_Tlbs_struct {
+  Cache dtlb;
+  Cache dtlb_huge;
+  Cache itlb;
+  Cache itlb_huge;
+  Cache stlb;
+  Cache stlb_huge;
+  Cache pwc[TLB_LEVELS - 1]; /* page walk caches, indexed by level - 2 */
+
+  Tlb_Walk* walks;
+  Tlb_Miss* misses;
+} Core_Tlbs;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Core_Tlbs* core_tlbs = NULL;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void init_tlb_cache(Cache*, const char*, uns, uns);
+static Flag tlb_huge_page(Addr va);
+static Addr tlb_key(Addr va, uns shift);
+static Cache* tlb_l1(Core_Tlbs* tlbs, Flag inst, Flag huge);
+static Tlb_Data* tlb_fill(Cache*, uns8, Addr key, Counter rdy_cycle);
+static Tlb_Miss* tlb_find_miss(Core_Tlbs* tlbs, Addr key, Flag huge,
+                               Flag inst);
+static Tlb_Miss* tlb_walk_pending(Core_Tlbs* tlbs, Addr key, Flag huge);
+static void tlb_miss_done(uns8 proc_id, Tlb_Miss* miss);
+static void tlb_start_queued_walk(uns8 proc_id, Tlb_Walk* walk);
+static Addr tlb_pte_addr(uns8 proc_id, Addr va, uns level);
+static void tlb_start_walk(uns8 proc_id, Tlb_Walk* walk, Addr va, Flag huge,
+                           Flag inst);
+static void tlb_walk_access(uns8 proc_id, Tlb_Walk* walk);
+static void tlb_walk_entry_done(uns8 proc_id, Tlb_Walk* walk);
+
+/**************************************************************************************/
+/* init_tlb: */
+
+void init_tlb(void) {
+  if(!TLB_ON)
+    return;
+
+  core_tlbs = (Core_Tlbs*)calloc(NUM_CORES, sizeof(Core_Tlbs));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Core_Tlbs* tlbs = &core_tlbs[proc_id];
+    init_tlb_cache(&tlbs->dtlb, "DTLB", DTLB_ENTRIES, DTLB_ASSOC);
+    init_tlb_cache(&tlbs->dtlb_huge, "DTLB_HUGE", DTLB_HUGE_ENTRIES,
+                   DTLB_HUGE_ASSOC);
+    init_tlb_cache(&tlbs->itlb, "ITLB", ITLB_ENTRIES, ITLB_ASSOC);
+    init_tlb_cache(&tlbs->itlb_huge, "ITLB_HUGE", ITLB_HUGE_ENTRIES,
+                   ITLB_HUGE_ASSOC);
+    init_tlb_cache(&tlbs->stlb, "STLB", STLB_ENTRIES, STLB_ASSOC);
+    init_tlb_cache(&tlbs->stlb_huge, "STLB_HUGE", STLB_HUGE_ENTRIES,
+                   STLB_HUGE_ASSOC);
+    init_tlb_cache(&tlbs->pwc[0], "PWC_PD", PWC_ENTRIES, PWC_ASSOC);
+    init_tlb_cache(&tlbs->pwc[1], "PWC_PDPT", PWC_ENTRIES, PWC_ASSOC);
+    init_tlb_cache(&tlbs->pwc[2], "PWC_PML4", PWC_ENTRIES, PWC_ASSOC);
+
+    ASSERTM(proc_id, PAGE_WALKERS > 0, "Need at least one page walker\n");
+    tlbs->walks = (Tlb_Walk*)calloc(PAGE_WALKERS, sizeof(Tlb_Walk));
+    ASSERTM(proc_id, TLB_MISS_ENTRIES > 0,
+            "Need at least one TLB miss entry\n");
+    tlbs->misses = (Tlb_Miss*)calloc(TLB_MISS_ENTRIES, sizeof(Tlb_Miss));
+  }
+}
+
+static void init_tlb_cache(Cache* cache, const char* name, uns entries,
+                           uns assoc) {
+  ASSERTM(0, entries % assoc == 0 && is_power_of_2(entries / assoc),
+          "%s: entries / assoc must be a power of two\n", name);
+  init_cache(cache, name, entries, assoc, 1, sizeof(Tlb_Data), REPL_TRUE_LRU);
+}
+
+/**************************************************************************************/
+/* tlb_huge_page: is the 2MB region holding va mapped by a huge page? */
+
+static Flag tlb_huge_page(Addr va) {
+  if(!TLB_HUGE_PAGE_PERCENT)
+    return FALSE;
+  Addr region = (va & N_BIT_MASK(TLB_VA_BITS)) >> TLB_HUGE_PAGE_BITS;
+  return ((region * 0x9e3779b97f4a7c15ULL) >> 32) % 100 <
+         TLB_HUGE_PAGE_PERCENT;
+}
+
+static Addr tlb_key(Addr va, uns shift) {
+  return va >> shift;
+}
+
+static Cache* tlb_l1(Core_Tlbs* tlbs, Flag inst, Flag huge) {
+  if(inst)
+    return huge ? &tlbs->itlb_huge : &tlbs->itlb;
+  return huge ? &tlbs->dtlb_huge : &tlbs->dtlb;
+}
+
+/* tlb_fill: make the translation for key usable at rdy_cycle, inserting it if
+   needed */
+
+static Tlb_Data* tlb_fill(Cache* cache, uns8 proc_id, Addr key,
+                          Counter rdy_cycle) {
+  Addr      line_addr, repl_line_addr;
+  Tlb_Data* data = (Tlb_Data*)cache_access(cache, key, &line_addr, FALSE);
+  if(!data)
+    data = (Tlb_Data*)cache_insert(cache, proc_id, key, &line_addr,
+                                   &repl_line_addr);
+  data->rdy_cycle = rdy_cycle;
+  return data;
+}
+
+/**************************************************************************************/
+/* tlb_find_miss: outstanding miss of the given L1 TLB for key */
+
+static Tlb_Miss* tlb_find_miss(Core_Tlbs* tlbs, Addr key, Flag huge,
+                               Flag inst) {
+  for(uns ii = 0; ii < TLB_MISS_ENTRIES; ii++) {
+    Tlb_Miss* miss = &tlbs->misses[ii];
+    if(miss->valid && miss->key == key && miss->huge == huge &&
+       miss->inst == inst)
+      return miss;
+  }
+  return NULL;
+}
+
+/**************************************************************************************/
+/* tlb_walk_pending: a miss of either L1 TLB for key that is walking or
+   waiting for a walker */
+
+static Tlb_Miss* tlb_walk_pending(Core_Tlbs* tlbs, Addr key, Flag huge) {
+  for(uns ii = 0; ii < TLB_MISS_ENTRIES; ii++) {
+    Tlb_Miss* miss = &tlbs->misses[ii];
+    if(miss->valid && miss->key == key && miss->huge == huge &&
+       miss->rdy_cycle == MAX_CTR)
+      return miss;
+  }
+  return NULL;
+}
+
+/**************************************************************************************/
+/* tlb_miss_done: install the translation in the L1 TLB and free the entry */
+
+static void tlb_miss_done(uns8 proc_id, Tlb_Miss* miss) {
+  ASSERT(proc_id, miss->valid && miss->rdy_cycle <= cycle_count);
+  tlb_fill(tlb_l1(&core_tlbs[proc_id], miss->inst, miss->huge), proc_id,
+           miss->key, cycle_count);
+  miss->valid = FALSE;
+}
+
+/**************************************************************************************/
+/* tlb_translate: */
+
+Flag tlb_translate(uns8 proc_id, Addr va, Flag inst, Flag off_path) {
+  Core_Tlbs* tlbs  = &core_tlbs[proc_id];
+  Flag       huge  = tlb_huge_page(va);
+  uns        shift = huge ? TLB_HUGE_PAGE_BITS : TLB_PAGE_BITS;
+  Addr       key   = tlb_key(va, shift);
+  Cache*     l1    = tlb_l1(tlbs, inst, huge);
+  Addr       line_addr;
+
+  Tlb_Miss* miss = tlb_find_miss(tlbs, key, huge, inst);
+  if(miss) {
+    if(miss->rdy_cycle > cycle_count)
+      return FALSE;  // miss already being handled
+    tlb_miss_done(proc_id, miss);
+  }
+
+  if(cache_access(l1, key, &line_addr, TRUE)) {
+    STAT_EVENT(proc_id, inst ? ITLB_HIT : DTLB_HIT);
+    return TRUE;
+  }
+
+  for(miss = tlbs->misses; miss < tlbs->misses + TLB_MISS_ENTRIES; miss++) {
+    if(!miss->valid)
+      break;
+  }
+  if(miss == tlbs->misses + TLB_MISS_ENTRIES) {
+    // not counted as a miss yet: the access is retried
+    STAT_EVENT(proc_id, TLB_MISS_ENTRIES_FULL);
+    return FALSE;
+  }
+
+  STAT_EVENT(proc_id, inst ? ITLB_MISS : DTLB_MISS);
+  if(!off_path)
+    STAT_EVENT(proc_id, inst ? ITLB_MPKI : DTLB_MPKI);
+  if(huge)
+    STAT_EVENT(proc_id, TLB_HUGE_PAGE_MISS);
+
+  /* a miss from the other L1 TLB may be walking the same page already */
+  Tlb_Miss* pending = tlb_walk_pending(tlbs, key, huge);
+  miss->valid      = TRUE;
+  miss->inst       = inst;
+  miss->huge       = huge;
+  miss->queued     = FALSE;
+  miss->va         = va;
+  miss->key        = key;
+  miss->miss_cycle = cycle_count;
+  miss->rdy_cycle  = MAX_CTR;
+
+  Cache* stlb = huge ? &tlbs->stlb_huge : &tlbs->stlb;
+  if(cache_access(stlb, key, &line_addr, TRUE)) {
+    STAT_EVENT(proc_id, STLB_HIT);
+    miss->rdy_cycle = cycle_count + STLB_CYCLES;
+    return FALSE;
+  }
+  STAT_EVENT(proc_id, STLB_MISS);
+  if(!off_path)
+    STAT_EVENT(proc_id, STLB_MPKI);
+
+  if(pending) {
+    STAT_EVENT(proc_id, PAGE_WALK_MERGED);
+    miss->queued = pending->queued;
+    return FALSE;
+  }
+
+  for(uns ii = 0; ii < PAGE_WALKERS; ii++) {
+    Tlb_Walk* walk = &tlbs->walks[ii];
+    if(walk->state == WALK_IDLE) {
+      tlb_start_walk(proc_id, walk, va, huge, inst);
+      return FALSE;
+    }
+  }
+
+  /* update_tlb starts the walk once a walker is free */
+  STAT_EVENT(proc_id, PAGE_WALKERS_FULL);
+  miss->queued = TRUE;
+  return FALSE;
+}
+
+/**************************************************************************************/
+/* tlb_ready: */
+
+Flag tlb_ready(uns8 proc_id, Addr va, Flag inst) {
+  Core_Tlbs* tlbs = &core_tlbs[proc_id];
+  Flag       huge = tlb_huge_page(va);
+  Addr       key  = tlb_key(va, huge ? TLB_HUGE_PAGE_BITS : TLB_PAGE_BITS);
+  Tlb_Miss*  miss = tlb_find_miss(tlbs, key, huge, inst);
+  return !miss || miss->rdy_cycle <= cycle_count;
+}
+
+/**************************************************************************************/
+/* tlb_warmup: */
+
+void tlb_warmup(uns8 proc_id, Addr va, Flag inst) {
+  Core_Tlbs* tlbs  = &core_tlbs[proc_id];
+  Flag       huge  = tlb_huge_page(va);
+  Addr       key   = tlb_key(va, huge ? TLB_HUGE_PAGE_BITS : TLB_PAGE_BITS);
+  Cache*     l1    = tlb_l1(tlbs, inst, huge);
+  Addr       line_addr;
+
+  if(cache_access(l1, key, &line_addr, TRUE))
+    return;
+  tlb_fill(l1, proc_id, key, 0);
+  if(cache_access(huge ? &tlbs->stlb_huge : &tlbs->stlb, key, &line_addr,
+                  TRUE))
+    return;
+  tlb_fill(huge ? &tlbs->stlb_huge : &tlbs->stlb, proc_id, key, 0);
+  for(uns level = huge ? 3 : 2; level <= TLB_LEVELS; level++)
+    tlb_fill(&tlbs->pwc[level - 2], proc_id,
+             tlb_key(va, TLB_LEVEL_SHIFT(level)), 0);
+}
+
+/**************************************************************************************/
+/* tlb_pte_addr: address of the page-table entry translating va at level */
+
+static Addr tlb_pte_addr(uns8 proc_id, Addr va, uns level) {
+  Addr masked_va = va & N_BIT_MASK(TLB_VA_BITS);
+  Addr index     = (masked_va >> TLB_LEVEL_SHIFT(level)) &
+               N_BIT_MASK(TLB_LEVEL_BITS);
+  Addr table = masked_va >> TLB_LEVEL_SHIFT(level + 1);
+  /* one region per level, one page per table */
+  Addr addr = (1ULL << TLB_PT_REGION_BIT) | ((Addr)(level - 1) << 44) |
+              (table << TLB_PAGE_BITS) | (index * TLB_PTE_SIZE);
+  return convert_to_cmp_addr(proc_id, addr);
+}
+
+/**************************************************************************************/
+/* tlb_start_walk: skip the levels whose entries hit in the page walk caches
+ */
+
+static void tlb_start_walk(uns8 proc_id, Tlb_Walk* walk, Addr va, Flag huge,
+                           Flag inst) {
+  Core_Tlbs* tlbs = &core_tlbs[proc_id];
+  Addr       line_addr;
+  uns        level;
+
+  /* the PD entry is the leaf of a huge page walk, so it is not cached */
+  for(level = huge ? 3 : 2; level <= TLB_LEVELS; level++) {
+    if(cache_access(&tlbs->pwc[level - 2], tlb_key(va, TLB_LEVEL_SHIFT(level)),
+                    &line_addr, TRUE))
+      break;
+  }
+  /* a hit on the entry of a level means the walk starts one level below */
+  level = level - 1;
+
+  walk->state       = WALK_ISSUE;
+  walk->va          = va;
+  walk->huge        = huge;
+  walk->inst        = inst;
+  walk->level       = level;
+  walk->start_cycle = cycle_count;
+  STAT_EVENT(proc_id, PAGE_WALK);
+  STAT_EVENT(proc_id, PAGE_WALK_START_PML4 + TLB_LEVELS - level);
+  DEBUG(proc_id, "Starting %s walk for va:0x%s at level %u\n",
+        huge ? "huge page" : "page", hexstr64s(va), level);
+}
+
+/**************************************************************************************/
+/* tlb_start_queued_walk: start the walk of the oldest miss waiting for a
+   walker, which the misses of the same page joined */
+
+static void tlb_start_queued_walk(uns8 proc_id, Tlb_Walk* walk) {
+  Core_Tlbs* tlbs   = &core_tlbs[proc_id];
+  Tlb_Miss*  oldest = NULL;
+
+  for(uns ii = 0; ii < TLB_MISS_ENTRIES; ii++) {
+    Tlb_Miss* miss = &tlbs->misses[ii];
+    if(miss->valid && miss->queued &&
+       (!oldest || miss->miss_cycle < oldest->miss_cycle))
+      oldest = miss;
+  }
+  if(!oldest)
+    return;
+
+  for(uns ii = 0; ii < TLB_MISS_ENTRIES; ii++) {
+    Tlb_Miss* miss = &tlbs->misses[ii];
+    if(miss->valid && miss->key == oldest->key && miss->huge == oldest->huge)
+      miss->queued = FALSE;
+  }
+  tlb_start_walk(proc_id, walk, oldest->va, oldest->huge, oldest->inst);
+}
+
+/**************************************************************************************/
+/* tlb_walk_access: load the entry of the current level */
+
+static void tlb_walk_access(uns8 proc_id, Tlb_Walk* walk) {
+  Addr pte_addr = tlb_pte_addr(proc_id, walk->va, walk->level);
+  Addr line_addr;
+
+  if(cache_access(&dc->dcache, pte_addr, &line_addr, TRUE)) {
+    STAT_EVENT(proc_id, PAGE_WALK_ACCESS);
+    STAT_EVENT(proc_id, PAGE_WALK_ACCESS_DCACHE_HIT);
+    walk->state     = WALK_WAIT_DCACHE;
+    walk->rdy_cycle = cycle_count + DCACHE_CYCLES;
+  } else if(new_mem_req(MRT_DFETCH, proc_id, line_addr, DCACHE_LINE_SIZE,
+                        DCACHE_CYCLES - 1, NULL, dcache_fill_line,
+                        unique_count, 0)) {
+    STAT_EVENT(proc_id, PAGE_WALK_ACCESS);
+    walk->state = WALK_WAIT_MEM;
+  } else {
+    STAT_EVENT(proc_id, PAGE_WALK_ACCESS_REJECTED);
+    return;  // retry next cycle
+  }
+  walk->line_addr = line_addr;
+  DEBUG(proc_id, "Walk for va:0x%s loading level %u entry at 0x%s (%s)\n",
+        hexstr64s(walk->va), walk->level, hexstr64s(pte_addr),
+        walk->state == WALK_WAIT_MEM ? "dcache miss" : "dcache hit");
+}
+
+/**************************************************************************************/
+/* tlb_walk_entry_done: the entry of the current level has been loaded */
+
+static void tlb_walk_entry_done(uns8 proc_id, Tlb_Walk* walk) {
+  Core_Tlbs* tlbs = &core_tlbs[proc_id];
+  uns        leaf = walk->huge ? 2 : 1;
+
+  if(walk->level > leaf) {
+    tlb_fill(&tlbs->pwc[walk->level - 2], proc_id,
+             tlb_key(walk->va, TLB_LEVEL_SHIFT(walk->level)), cycle_count);
+    walk->level--;
+    walk->state = WALK_ISSUE;
+    tlb_walk_access(proc_id, walk);
+    return;
+  }
+
+  Addr key = tlb_key(walk->va,
+                     walk->huge ? TLB_HUGE_PAGE_BITS : TLB_PAGE_BITS);
+  tlb_fill(walk->huge ? &tlbs->stlb_huge : &tlbs->stlb, proc_id, key,
+           cycle_count);
+  /* misses from both L1 TLBs may have joined this walk */
+  Tlb_Miss* miss;
+  while((miss = tlb_walk_pending(tlbs, key, walk->huge))) {
+    ASSERT(proc_id, !miss->queued);
+    miss->rdy_cycle = cycle_count;
+    tlb_miss_done(proc_id, miss);
+  }
+
+  INC_STAT_EVENT(proc_id, PAGE_WALK_CYCLES, cycle_count - walk->start_cycle);
+  DEBUG(proc_id, "Walk for va:0x%s done after %s cycles\n",
+        hexstr64s(walk->va), unsstr64(cycle_count - walk->start_cycle));
+  walk->state = WALK_IDLE;
+}
+
+/**************************************************************************************/
+/* update_tlb: */
+
+void update_tlb(uns8 proc_id) {
+  if(!TLB_ON)
+    return;
+
+  Core_Tlbs* tlbs = &core_tlbs[proc_id];
+  for(uns ii = 0; ii < TLB_MISS_ENTRIES; ii++) {
+    Tlb_Miss* miss = &tlbs->misses[ii];
+    if(miss->valid && miss->rdy_cycle <= cycle_count)
+      tlb_miss_done(proc_id, miss);
+  }
+  for(uns ii = 0; ii < PAGE_WALKERS; ii++) {
+    Tlb_Walk* walk = &tlbs->walks[ii];
+    if(walk->state == WALK_IDLE)
+      tlb_start_queued_walk(proc_id, walk);
+    if(walk->state == WALK_ISSUE)
+      tlb_walk_access(proc_id, walk);
+    else if(walk->state == WALK_WAIT_DCACHE && cycle_count >= walk->rdy_cycle)
+      tlb_walk_entry_done(proc_id, walk);
+  }
+}
+
+/**************************************************************************************/
+/* tlb_dcache_fill: */
+
+void tlb_dcache_fill(uns8 proc_id, Addr line_addr) {
+  Core_Tlbs* tlbs = &core_tlbs[proc_id];
+  for(uns ii = 0; ii < PAGE_WALKERS; ii++) {
+    Tlb_Walk* walk = &tlbs->walks[ii];
+    if(walk->state == WALK_WAIT_MEM &&
+       walk->line_addr >> LOG2(DCACHE_LINE_SIZE) ==
+         line_addr >> LOG2(DCACHE_LINE_SIZE)) {
+      walk->state     = WALK_WAIT_DCACHE;
+      walk->rdy_cycle = cycle_count;
+    }
+  }
+}
@@ -0,0 +1,63 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/tlb.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Per-core L1 instruction/data TLBs, a shared second level TLB
+ *                and a page walker that loads page-table entries through the
+ *                data cache.
+ ***************************************************************************************/
+
+#ifndef __TLB_H__
+#define __TLB_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Initialize the TLBs of every core */
+void init_tlb(void);
+
+/* Translate va for a fetch (inst) or a data access. Returns TRUE if the
+   translation can be used this cycle. Otherwise a second level TLB lookup or
+   page walk is under way and the caller should retry. */
+Flag tlb_translate(uns8 proc_id, Addr va, Flag inst, Flag off_path);
+
+/* Returns FALSE while a miss on va is outstanding, without updating any
+   state. Once it returns TRUE, tlb_translate should be retried (the
+   translation may have been evicted again, which makes it a new miss). */
+Flag tlb_ready(uns8 proc_id, Addr va, Flag inst);
+
+/* Install the translation for va without timing (warmup mode) */
+void tlb_warmup(uns8 proc_id, Addr va, Flag inst);
+
+/* Advance the page walks of a core. Call every core cycle. */
+void update_tlb(uns8 proc_id);
+
+/* Report a dcache fill, which may complete a page-table entry load */
+void tlb_dcache_fill(uns8 proc_id, Addr line_addr);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __TLB_H__ */
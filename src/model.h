@@ -39,6 +39,7 @@
 typedef enum Model_Id_enum {
   CMP_MODEL,
   DUMB_MODEL,
+  INTERVAL_MODEL,
   NUM_MODELS,
 } Model_Id;
 
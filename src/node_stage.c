@@ -42,6 +42,7 @@
 #include "exec_ports.h"
 #include "frontend/frontend.h"
 #include "memory/memory.h"
+#include "memory/tlb.h"
 #include "node_stage.h"
 #include "thread.h"
 
@@ -51,6 +52,7 @@
 #include "map.h"
 #include "memory/memory.param.h"
 #include "sim.h"
+#include "smt.h"
 #include "statistics.h"
 
 #include "bp/tagescl.h"
@@ -88,6 +90,7 @@ Flag is_node_table_empty(void);
 void collect_not_ready_to_retire_stats(Op* op);
 Flag is_node_table_full(void);
 void collect_node_table_full_stats(Op* op);
+static void lsq_release(Op* op);
 
 /**************************************************************************************/
 /* set_node_stage:*/
@@ -128,6 +131,9 @@ void reset_node_stage() {
   node->next_op_into_rs = NULL;
 
   node->node_count           = 0;
+  node->lq_count             = 0;
+  node->sq_count             = 0;
+  node->rs_count             = 0;
   node->ret_op               = 1;
   node->last_scheduled_opnum = 0;
   node->mem_blocked          = FALSE;
@@ -151,6 +157,9 @@ void reset_all_ops_node_stage() {
 
   node->node_count       = 0;
   node->node_count       = 0;
+  node->lq_count         = 0;
+  node->sq_count         = 0;
+  node->rs_count         = 0;
   node->mem_blocked      = FALSE;
   node->ret_stall_length = 0;
 }
@@ -241,7 +250,10 @@ void flush_window() {
          op->state == OS_WAIT_FWD) {
         ASSERT(op->proc_id, node->rs[op->rs_id].rs_op_count > 0);
         node->rs[op->rs_id].rs_op_count--;
+        node->rs_count--;
       }
+      if(LSQ_ON)
+        lsq_release(op);
       free_op(op);
     } else {
       /* Keep op */
@@ -351,7 +363,8 @@ void debug_print_rs() {
     if(printed % 8)
       DPRINTF("\n");
 
-    ASSERTM(node->proc_id, printed == rs->rs_op_count,
+    /* SMT siblings share the reservation stations but not the node table */
+    ASSERTM(node->proc_id, SMT_THREADS > 1 || printed == rs->rs_op_count,
             "printed=%d, rs_op_count=%d\n", printed, rs->rs_op_count);
   }
 }
@@ -378,6 +391,10 @@ void update_node_stage(Stage_Data* src_sd) {
   DEBUG(node->proc_id, "Beginning '%s' stage\n", node->sd.name);
   STAT_EVENT(node->proc_id, NODE_CYCLE);
   STAT_EVENT(node->proc_id, POWER_CYCLE);
+  if(LSQ_ON) {
+    INC_STAT_EVENT(node->proc_id, LQ_OCCUPANCY, node->lq_count);
+    INC_STAT_EVENT(node->proc_id, SQ_OCCUPANCY, node->sq_count);
+  }
 
   /* insert ops coming from the previous stage*/
   node_issue(src_sd);
@@ -417,7 +434,9 @@ void node_issue(Stage_Data* src_sd) {
   for(ii = 0; ii < src_sd->max_op_count; ii++) {
     /* if node table is full, stall */
     if(is_node_table_full()) {
-      collect_node_table_full_stats(node->node_head);
+      /* with a shared SMT reorder buffer the siblings may hold every entry */
+      if(node->node_head)
+        collect_node_table_full_stats(node->node_head);
       rob_block_issue_reason = ROB_BLOCK_ISSUE_FULL;
       return;
     }
@@ -433,6 +452,24 @@ void node_issue(Stage_Data* src_sd) {
     if((op->table_info->bar_type & BAR_ISSUE) && (node->node_count > 0))
       break;
 
+    /* memory ops also need a load or store queue entry */
+    if(LSQ_ON) {
+      if(op->table_info->mem_type == MEM_LD &&
+         node->lq_count >= LOAD_QUEUE_ENTRIES) {
+        STAT_EVENT(node->proc_id, LQ_FULL_CYCLE);
+        rob_block_issue_reason = ROB_BLOCK_ISSUE_LQ_FULL;
+        return;
+      }
+      if(op->table_info->mem_type == MEM_ST &&
+         node->sq_count >= STORE_QUEUE_ENTRIES) {
+        STAT_EVENT(node->proc_id, SQ_FULL_CYCLE);
+        rob_block_issue_reason = ROB_BLOCK_ISSUE_SQ_FULL;
+        return;
+      }
+      node->lq_count += op->table_info->mem_type == MEM_LD;
+      node->sq_count += op->table_info->mem_type == MEM_ST;
+    }
+
     /* remove op from previous stage */
     src_sd->ops[ii] = NULL;
     src_sd->op_count--;
@@ -475,6 +512,20 @@ void node_issue(Stage_Data* src_sd) {
   }
 }
 
+/**************************************************************************************/
+/* lsq_release: give back the load or store queue entry of an op leaving the
+   node table */
+
+static void lsq_release(Op* op) {
+  if(op->table_info->mem_type == MEM_LD) {
+    ASSERT(node->proc_id, node->lq_count > 0);
+    node->lq_count--;
+  } else if(op->table_info->mem_type == MEM_ST) {
+    ASSERT(node->proc_id, node->sq_count > 0);
+    node->sq_count--;
+  }
+}
+
 /**************************************************************************************/
 /* check_if_mem_blocked: Memory is blocked when there are no more MSHRs in the
  * L1 Q (i.e., there is no way to handle a D-Cache miss). This function checks
@@ -587,64 +638,44 @@ inline static void sort_node_ready_list() {
  */
 
 void oldest_first_sched(Op* op) {
-  int32 youngest_slot_op_id = -1;  //-1 means not found
-
-  // Iterate through the FUs that this RS is connected to.
-  Reservation_Station* rs = &node->rs[op->rs_id];
-  for(uns32 i = 0; i < rs->num_fus; ++i) {
-    Func_Unit* fu    = rs->connected_fus[i];
-    uns32      fu_id = fu->fu_id;
-
-    // check if this op can be executed by this FU
-    if(get_fu_type(op->table_info->op_type, op->table_info->is_simd) &
-       fu->type) {
-      Op* s_op = node->sd.ops[fu_id];
-      if(!s_op) {  // nobody has been scheduled to this FU yet
-        DEBUG(node->proc_id,
-              "Scheduler selecting    op_num:%s  fu_id:%d op:%s l1:%d\n",
-              unsstr64(op->op_num), fu_id, disasm_op(op, TRUE),
-              op->engine_info.l1_miss);
-        ASSERT(node->proc_id, fu_id < node->sd.max_op_count);
-        op->fu_num                 = fu_id;
-        node->sd.ops[op->fu_num]   = op;
-        node->last_scheduled_opnum = op->op_num;
-        node->sd.op_count += !s_op;
-        ASSERT(node->proc_id, node->sd.op_count <= node->sd.max_op_count);
-        youngest_slot_op_id = -1;
-        break;
-      } else if(op->op_num < s_op->op_num) {
-        // The slot is not empty, but we are older than the op that is in the
-        // slot
-        if(youngest_slot_op_id == -1) {
-          youngest_slot_op_id = fu_id;
-        } else {
-          Op* youngest_op = node->sd.ops[youngest_slot_op_id];
-          if(s_op->op_num > youngest_op->op_num) {
-            // this slot is younger than the youngest known op
-            youngest_slot_op_id = fu_id;
-          }
-        }
-      }
+  int32 fu_id = -1;  //-1 means not found
+
+  // FUs that are connected to this op's RS and can execute it
+  Reservation_Station* rs   = &node->rs[op->rs_id];
+  uns                  type = FU_TYPE_IDX(op->table_info->op_type,
+                                         op->table_info->is_simd);
+  uns64 candidates = rs->fu_mask & node->fu_eligible[type];
+  uns64 free_fus   = candidates & ~node->sched_fu_mask;
+
+  if(free_fus) {
+    // the lowest numbered FU nobody has been scheduled to yet
+    fu_id = __builtin_ctzll(free_fus);
+    node->sched_fu_mask |= 1ull << fu_id;
+    node->sd.op_count++;
+  } else {
+    /*No empty slot: take the slot holding the youngest op that is younger
+     * than us, if any*/
+    for(uns64 fus = candidates; fus; fus &= fus - 1) {
+      uns32 slot = __builtin_ctzll(fus);
+      Op*   s_op = node->sd.ops[slot];
+      if(op->op_num < s_op->op_num &&
+         (fu_id == -1 || s_op->op_num > node->sd.ops[fu_id]->op_num))
+        fu_id = slot;
     }
+    if(fu_id == -1)
+      return;  // no slot is younger than us, do nothing
+    // replacing an op, not adding a new one: op_count is unchanged
   }
 
-  if(youngest_slot_op_id != -1) {
-    /*Did not find an empty slot, but we did find a slot that is younger that
-     * us*/
-    uns32 fu_id = youngest_slot_op_id;
-    DEBUG(node->proc_id,
-          "Scheduler selecting    op_num:%s  fu_id:%d op:%s l1:%d\n",
-          unsstr64(op->op_num), fu_id, disasm_op(op, TRUE),
-          op->engine_info.l1_miss);
-    ASSERT(node->proc_id, fu_id < node->sd.max_op_count);
-    op->fu_num                 = fu_id;
-    node->sd.ops[op->fu_num]   = op;
-    node->last_scheduled_opnum = op->op_num;
-    node->sd.op_count += 0;  // replacing an op, not adding a new one.
-    ASSERT(node->proc_id, node->sd.op_count <= node->sd.max_op_count);
-  } else {
-    /*Did not find an empty slot or a slot that is younger than me, do nothing*/
-  }
+  DEBUG(node->proc_id,
+        "Scheduler selecting    op_num:%s  fu_id:%d op:%s l1:%d\n",
+        unsstr64(op->op_num), fu_id, disasm_op(op, TRUE),
+        op->engine_info.l1_miss);
+  ASSERT(node->proc_id, fu_id < node->sd.max_op_count);
+  op->fu_num                 = fu_id;
+  node->sd.ops[op->fu_num]   = op;
+  node->last_scheduled_opnum = op->op_num;
+  ASSERT(node->proc_id, node->sd.op_count <= node->sd.max_op_count);
 }
 
 /**************************************************************************************/
@@ -663,6 +694,7 @@ void node_sched_ops() {
   /* the next stage is supposed to clear them out, regardless of
      whether they are actually sent to a functional unit */
   ASSERT(node->proc_id, node->sd.op_count == 0);
+  node->sched_fu_mask = 0;
 
   // Check to see if the L1 Q is (still) full
   check_if_mem_blocked();
@@ -676,6 +708,13 @@ void node_sched_ops() {
       else
         op->state = OS_READY;
     }
+    if(op->state == OS_WAIT_TLB) {
+      /* the dcache stage translates again and may miss again */
+      if(!tlb_ready(node->proc_id, op->oracle_info.va, FALSE))
+        continue;
+      else
+        op->state = OS_READY;
+    }
     if(op->state == OS_TENTATIVE || op->state == OS_WAIT_DCACHE)
       continue;
     ASSERTM(node->proc_id,
@@ -821,12 +860,15 @@ void node_retire() {
                  LD_EXEC_CYCLES_0 + (op->done_cycle - op->sched_cycle));
     }
     if(op->table_info->mem_type == MEM_LD) {
-      STAT_EVENT(op->proc_id, LD_NO_DEPENDENTS + (op->wake_up_head ? 1 : 0));
+      STAT_EVENT(op->proc_id, LD_NO_DEPENDENTS + (op->wake_up_count ? 1 : 0));
     }
     STAT_EVENT(op->proc_id, RET_OP_EXEC_COUNT_0 + MIN2(32, op->exec_count));
 
     op->retire_cycle = cycle_count;
 
+    if(LSQ_ON)
+      lsq_release(op);
+
     if(model->op_retired_hook)
       model->op_retired_hook(op);
     else
@@ -864,6 +906,8 @@ void node_retire() {
 int64 find_emptiest_rs(Op* op) {
   int64 emptiest_rs_id    = -1;
   int64 emptiest_rs_slots = -1;
+  uns64 eligible          = node->fu_eligible[FU_TYPE_IDX(
+    op->table_info->op_type, op->table_info->is_simd)];
 
   /*Iterate through RSs looking for an available RS that is connected
     to an FU that can execute the OP.*/
@@ -872,20 +916,15 @@ int64 find_emptiest_rs(Op* op) {
     ASSERT(node->proc_id, !rs->size || rs->rs_op_count <= rs->size);
     ASSERTM(node->proc_id, rs->size,
             "Infinite RS not suppoted by find_emptiest_rs issuer.");
-    for(uns32 i = 0; i < rs->num_fus; ++i) {
-      Func_Unit* fu = rs->connected_fus[i];
-
-      // This FU can execute this op
-      if(get_fu_type(op->table_info->op_type, op->table_info->is_simd) &
-         fu->type) {
-        // Find the emptiest RS
-        int32 num_empty_slots = rs->size - rs->rs_op_count;
-        if(num_empty_slots != 0) {
-          if(emptiest_rs_slots < num_empty_slots) {
-            // Found a new emptiest rs
-            emptiest_rs_id    = rs_id;
-            emptiest_rs_slots = num_empty_slots;
-          }
+    // This RS is connected to an FU that can execute this op
+    if(rs->fu_mask & eligible) {
+      // Find the emptiest RS
+      int32 num_empty_slots = rs->size - rs->rs_op_count;
+      if(num_empty_slots != 0) {
+        if(emptiest_rs_slots < num_empty_slots) {
+          // Found a new emptiest rs
+          emptiest_rs_id    = rs_id;
+          emptiest_rs_slots = num_empty_slots;
         }
       }
     }
@@ -927,6 +966,7 @@ void node_fill_rs() {
     op->state = OS_IN_RS;
     op->rs_id = (Counter)rs_id;
     rs->rs_op_count++;
+    node->rs_count++;
     num_fill_rs++;
     DEBUG(node->proc_id, "Filling %s with op_num:%s (%d)\n", rs->name,
           unsstr64(op->op_num), rs->rs_op_count);
@@ -968,6 +1008,7 @@ void node_handle_scheduled_ops() {
       op->in_rdy_list = FALSE;
       ASSERT(node->proc_id, node->rs[op->rs_id].rs_op_count > 0);
       node->rs[op->rs_id].rs_op_count--;
+      node->rs_count--;
     } else {
       last = &op->next_rdy;
     }
@@ -979,9 +1020,9 @@ void node_handle_scheduled_ops() {
  * ready ops */
 
 Flag is_node_stage_stalled() {
-  return (node->node_count == NODE_TABLE_SIZE) && /* node table is full */
-         !node->rdy_head &&                       /* no ready ops */
-         !node->next_op_into_rs; /* no ops waiting to enter RS */
+  return is_node_table_full() &&  /* node table is full */
+         !node->rdy_head &&         /* no ready ops */
+         !node->next_op_into_rs;    /* no ops waiting to enter RS */
 }
 
 void debug_print_retired_uop(Op* op) {
@@ -1067,6 +1108,8 @@ void collect_not_ready_to_retire_stats(Op* op) {
 
 Flag is_node_table_full() {
   ASSERT(node->proc_id, node->node_count <= NODE_TABLE_SIZE);
+  if(SMT_THREADS > 1)
+    return smt_node_table_full(node->proc_id);
   return (node->node_count == NODE_TABLE_SIZE);
 }
 
@@ -44,6 +44,7 @@ typedef struct Reservation_Station_struct {
   Func_Unit** connected_fus;  // FUs that this reservation station is connected
                               // to.
   uns32 num_fus;              // number of fus that this rs is connected to.
+  uns64 fu_mask;              // connected FUs as a bitmask of fu_ids
   uns32 rs_op_count;          // number of ops in this reservation station
 } Reservation_Station;
 
@@ -54,6 +55,10 @@ typedef struct Node_Stage_struct {
   Op*   node_head;   // linked-list of ops in the node stage
   Op*   node_tail;   // linked-list of ops in the node stage
   int32 node_count;  // number of ops in the node table
+  uns   lq_count;    // loads holding a load queue entry (LSQ_ON)
+  uns   sq_count;    // stores holding a store queue entry (LSQ_ON)
+  uns   rs_count;    // ops of this thread in the reservation stations, which
+                     // are shared by the threads of an SMT core
 
   Op* rdy_head;  // linked-list of ops that are ready to schedule. Ops
                  // are put in here when they are issued, or after they
@@ -66,6 +71,8 @@ typedef struct Node_Stage_struct {
   Op* next_op_into_rs;      // oldest issued op not yet in the scheduling window
                             // (RS)
   Reservation_Station* rs;  // information about all of the reservation stations
+  uns64* fu_eligible;    // per FU_TYPE_IDX: mask of fu_ids that can execute it
+  uns64  sched_fu_mask;  // FU slots of sd already filled this cycle
 
   Flag mem_blocked;       // are we out of mem req buffers for this core
   uns  mem_block_length;  // length of the current memory block
@@ -74,6 +74,7 @@
     elem(MISS)         /* op has missed in the dcache */                       \
     elem(WAIT_DCACHE)  /* op is waiting for a dcache port */                   \
     elem(WAIT_MEM)     /* op is waiting for a miss_buffer entry */             \
+    elem(WAIT_TLB)     /* op is waiting for its address translation */         \
     elem(DONE)         /* op is finished executing, awaiting retirement */
 
 DECLARE_ENUM(Op_State, OP_STATE_LIST, OS_);
@@ -82,11 +83,10 @@ DECLARE_ENUM(Op_State, OP_STATE_LIST, OS_);
 /*------------------------------------------------------------------------------------*/
 // {{{ Wake_Up_Entry
 typedef struct Wake_Up_Entry_struct {
-  Op*                          op;
-  Counter                      unique_num;
-  Dep_Type                     dep_type;
-  uns8                         rdy_bit;
-  struct Wake_Up_Entry_struct* next;
+  Op*      op;
+  Counter  unique_num;
+  Dep_Type dep_type;
+  uns8     rdy_bit;
 } Wake_Up_Entry;
 // }}}
 
@@ -199,6 +199,7 @@ struct Op_struct {
   Flag prog_input;  // is this op directly related to an input value of the
                     // program ?
   Addr          fetch_addr;       // fetch address used to fetch the instruction
+  Flag          uop_cache_hit;    // delivered by the uop cache, skips decode
   uns           cf_within_fetch;  // branch number within a fetch cycle
   Recovery_Info recovery_info;    // information that will be used to recover a
                                   // mispredict by the op
@@ -228,12 +229,15 @@ struct Op_struct {
   Flag wake_up_signaled[NUM_DEP_TYPES];  // set to true once a wake up has been
                                          // signaled by the op for the given
                                          // type
-  Wake_Up_Entry* wake_up_head;  // list of ops that are dependent on this op, by
-                                // dependency type
-  Wake_Up_Entry* wake_up_tail;  // last entry in each wake up list (for speed)
   uns wake_up_count;   // count of ops to be awakened by this op (wake up list
-                       // length)
+                       // length, the list itself lives in map.c's arena)
   Counter wake_cycle;  // used by wake up logic for time wake up signal is sent
+  struct Op_struct* fwd_store_op;  // youngest older store the load reads from
+  Counter fwd_store_unique;        // unique_num of fwd_store_op
+  Counter mem_dep_pred_unique;     // unique_num of the store the store sets
+                                   // made the load wait for (0 if none)
+  uns8 value_pred;  // Value_Pred_Outcome of the load value prediction
+  uns8 addr_pred;   // Value_Pred_Outcome of the load address prediction
   // }}}
 
   struct Mem_Req_struct* req;  // pointer to memory request responsible for
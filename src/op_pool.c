@@ -51,6 +51,7 @@ allocates them once and then hands out pointers every time 'alloc_op' is called.
 #include "frontend/pin_trace_fe.h"
 
 #include "sim.h"
+#include "value_pred.h"
 
 /**************************************************************************************/
 /* Macros */
@@ -204,6 +205,7 @@ void op_pool_setup_op(uns proc_id, Op* op) {
   op->thread_id           = 0;
   op->off_path            = FALSE;  // FIXME: check
   op->fetch_addr          = 0;
+  op->uop_cache_hit       = FALSE;
   op->state               = OS_FETCHED;
   op->fu_num              = -1;
   op->issue_cycle         = MAX_CTR;
@@ -224,6 +226,12 @@ void op_pool_setup_op(uns proc_id, Op* op) {
 
   op->req = NULL;
 
+  op->fwd_store_op        = NULL;
+  op->fwd_store_unique    = 0;
+  op->mem_dep_pred_unique = 0;
+  op->value_pred          = VP_PRED_NONE;
+  op->addr_pred           = VP_PRED_NONE;
+
   /* pipelined scheduler fields */
   op->chkpt_num        = MAX_CTR;
   op->node_id          = MAX_CTR;
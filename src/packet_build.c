@@ -35,6 +35,7 @@
 #include "icache_stage.h"
 #include "op.h"
 #include "packet_build.h"
+#include "uop_cache.h"
 
 #include "bp/bp.param.h"
 #include "core.param.h"
@@ -238,7 +239,9 @@ Flag packet_build(Pb_Data* pb_data, Break_Reason* break_fetch, Op* const op,
 
     // issue width reached
     if(pb_data->pb_ident == PB_ICACHE) {
-      if(ic->sd.op_count + 1 == ISSUE_WIDTH) {
+      uns width = UOP_CACHE_ENABLE ? uop_cache_fetch_width(ic->proc_id) :
+                                     ISSUE_WIDTH;
+      if(ic->sd.op_count + 1 == width) {
         *break_fetch = BREAK_ISSUE_WIDTH;
         return PB_BREAK_AFTER;
       }
@@ -0,0 +1,242 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_bop.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Best-Offset Prefetcher (Michaud, HPCA 2016)
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+
+#include "globals/assert.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/pref_bop.h"
+#include "prefetcher/pref_bop.param.h"
+#include "prefetcher/pref_common.h"
+#include "statistics.h"
+
+/*
+   Best-offset prefetcher: on every ul1 miss or first hit to a prefetched line
+   X, prefetch X + D within the page. D is relearned continuously: each trigger
+   tests one candidate offset d by checking whether X - d is in the recent
+   requests (rr) table, i.e. whether a prefetch with offset d issued for X - d
+   would have completed by now. Lines enter the rr table PREF_BOP_DELAY cycles
+   after they trigger, which stands in for the fill latency. The offset with
+   the highest score at the end of a learning phase becomes D.
+*/
+
+/**************************************************************************************/
+/* Macros */
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_PREF_BOP, ##args)
+
+#define BOP_RR_VALID 0x80000000U
+
+/**************************************************************************************/
+/* Global Variables */
+
+Pref_BOP* bop_hwp_core;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void pref_bop_train(uns8 proc_id, Addr lineAddr);
+
+/**************************************************************************************/
+
+static Flag bop_smooth_number(uns n) {
+  while(n % 2 == 0)
+    n /= 2;
+  while(n % 3 == 0)
+    n /= 3;
+  while(n % 5 == 0)
+    n /= 5;
+  return n == 1;
+}
+
+static inline uns bop_rr_index(Addr line_index) {
+  return (line_index ^ (line_index >> LOG2(PREF_BOP_RR_TABLE_N))) &
+         N_BIT_MASK(LOG2(PREF_BOP_RR_TABLE_N));
+}
+
+static inline uns32 bop_rr_tag(Addr line_index) {
+  return ((line_index >> LOG2(PREF_BOP_RR_TABLE_N)) &
+          N_BIT_MASK(PREF_BOP_RR_TAG_BITS)) |
+         BOP_RR_VALID;
+}
+
+static inline Flag bop_same_page(Addr line_index_a, Addr line_index_b) {
+  const uns page_shift = LOG2(VA_PAGE_SIZE_BYTES) - LOG2(DCACHE_LINE_SIZE);
+  return (line_index_a >> page_shift) == (line_index_b >> page_shift);
+}
+
+void pref_bop_init(HWP* hwp) {
+  if(!PREF_BOP_ON)
+    return;
+  ASSERTM(0, is_power_of_2(PREF_BOP_RR_TABLE_N),
+          "pref_bop_rr_table_n must be a power of two\n");
+  ASSERTM(0, PREF_BOP_RR_TAG_BITS > 0 && PREF_BOP_RR_TAG_BITS < 32,
+          "pref_bop_rr_tag_bits must be between 1 and 31\n");
+  ASSERT(0, PREF_BOP_DELAY_QUEUE_N > 0);
+  hwp->hwp_info->enabled = TRUE;
+
+  bop_hwp_core = (Pref_BOP*)calloc(NUM_CORES, sizeof(Pref_BOP));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Pref_BOP* bop = &bop_hwp_core[proc_id];
+    bop->hwp_info = hwp->hwp_info;
+    bop->rr_table = (uns32*)calloc(PREF_BOP_RR_TABLE_N, sizeof(uns32));
+
+    bop->offsets = (int*)malloc(sizeof(int) * 2 * PREF_BOP_MAX_OFFSET);
+    for(uns ii = 1; ii <= PREF_BOP_MAX_OFFSET; ii++) {
+      if(!bop_smooth_number(ii))
+        continue;
+      bop->offsets[bop->num_offsets++] = ii;
+      if(PREF_BOP_NEGATIVE_OFFSETS)
+        bop->offsets[bop->num_offsets++] = -(int)ii;
+    }
+    ASSERT(0, bop->num_offsets > 0);
+    bop->scores = (uns*)calloc(bop->num_offsets, sizeof(uns));
+
+    bop->best_offset = 1;
+    bop->prefetch_on = TRUE;
+
+    bop->delay_queue = (BOP_Delay_Entry*)calloc(PREF_BOP_DELAY_QUEUE_N,
+                                                sizeof(BOP_Delay_Entry));
+  }
+}
+
+void pref_bop_per_core_done(uns proc_id) {
+  pref_report_hwp_stats(proc_id, bop_hwp_core[proc_id].hwp_info->id,
+                        PREF_BOP_SENT);
+}
+
+void pref_bop_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                       uns32 global_hist) {
+  pref_bop_train(proc_id, lineAddr);
+}
+
+void pref_bop_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                          uns32 global_hist) {
+  pref_bop_train(proc_id, lineAddr);
+}
+
+static void bop_rr_insert(Pref_BOP* bop, Addr line_index) {
+  bop->rr_table[bop_rr_index(line_index)] = bop_rr_tag(line_index);
+}
+
+static Flag bop_rr_hit(Pref_BOP* bop, Addr line_index) {
+  return bop->rr_table[bop_rr_index(line_index)] == bop_rr_tag(line_index);
+}
+
+// moves the base lines whose delay has elapsed into the rr table
+static void bop_drain_delay_queue(Pref_BOP* bop) {
+  while(bop->delay_count &&
+        bop->delay_queue[bop->delay_head].rdy_cycle <= cycle_count) {
+    bop_rr_insert(bop, bop->delay_queue[bop->delay_head].line_index);
+    bop->delay_head = (bop->delay_head + 1) % PREF_BOP_DELAY_QUEUE_N;
+    bop->delay_count--;
+  }
+}
+
+static void bop_delay_queue_push(Pref_BOP* bop, Addr line_index) {
+  if(bop->delay_count == PREF_BOP_DELAY_QUEUE_N) {
+    // full: let the oldest entry in early
+    bop_rr_insert(bop, bop->delay_queue[bop->delay_head].line_index);
+    bop->delay_head = (bop->delay_head + 1) % PREF_BOP_DELAY_QUEUE_N;
+    bop->delay_count--;
+  }
+  uns tail = (bop->delay_head + bop->delay_count) % PREF_BOP_DELAY_QUEUE_N;
+  bop->delay_queue[tail].line_index = line_index;
+  bop->delay_queue[tail].rdy_cycle  = cycle_count + PREF_BOP_DELAY;
+  bop->delay_count++;
+}
+
+static void bop_end_phase(uns8 proc_id, Pref_BOP* bop) {
+  uns best = 0;
+  for(uns ii = 1; ii < bop->num_offsets; ii++) {
+    if(bop->scores[ii] > bop->scores[best])
+      best = ii;
+  }
+  bop->best_offset = bop->offsets[best];
+  bop->prefetch_on = bop->scores[best] > PREF_BOP_BAD_SCORE;
+
+  DEBUG(proc_id, "BOP phase end: best offset %d score %u round %u\n",
+        bop->best_offset, bop->scores[best], bop->round);
+  STAT_EVENT(proc_id, PREF_BOP_PHASES);
+  if(!bop->prefetch_on)
+    STAT_EVENT(proc_id, PREF_BOP_PHASES_OFF);
+
+  memset(bop->scores, 0, sizeof(uns) * bop->num_offsets);
+  bop->test_index = 0;
+  bop->round      = 0;
+}
+
+static void bop_learn(uns8 proc_id, Pref_BOP* bop, Addr line_index) {
+  uns ii = bop->test_index;
+  if(bop_rr_hit(bop, line_index - bop->offsets[ii])) {
+    if(++bop->scores[ii] >= PREF_BOP_SCORE_MAX) {
+      bop_end_phase(proc_id, bop);
+      return;
+    }
+  }
+  if(++bop->test_index == bop->num_offsets) {
+    bop->test_index = 0;
+    if(++bop->round >= PREF_BOP_ROUND_MAX)
+      bop_end_phase(proc_id, bop);
+  }
+}
+
+static void pref_bop_train(uns8 proc_id, Addr lineAddr) {
+  Pref_BOP* bop       = &bop_hwp_core[proc_id];
+  Addr      lineIndex = lineAddr >> LOG2(DCACHE_LINE_SIZE);
+
+  bop_drain_delay_queue(bop);
+  bop_learn(proc_id, bop, lineIndex);
+
+  if(bop->prefetch_on) {
+    for(uns ii = 1; ii <= PREF_BOP_DEGREE; ii++) {
+      Addr pref_index = lineIndex + (int)ii * bop->best_offset;
+      if(!bop_same_page(lineIndex, pref_index)) {
+        STAT_EVENT(proc_id, PREF_BOP_PAGE_CROSS_DROPPED);
+        break;
+      }
+      ASSERT(proc_id,
+             proc_id == (pref_index >> (58 - LOG2(DCACHE_LINE_SIZE))));
+      if(!pref_addto_ul1req_queue(proc_id, pref_index, bop->hwp_info->id))
+        break;  // q is full
+      STAT_EVENT(proc_id, PREF_BOP_ISSUED);
+    }
+  }
+
+  // a prefetch of lineIndex + D issued now completes after the delay, at
+  // which point lineIndex is the base the rr table should remember
+  bop_delay_queue_push(bop, lineIndex);
+}
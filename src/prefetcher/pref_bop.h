@@ -0,0 +1,70 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_bop.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Best-Offset Prefetcher (Michaud, HPCA 2016)
+ ***************************************************************************************/
+#ifndef __PREF_BOP_H__
+#define __PREF_BOP_H__
+
+#include "pref_common.h"
+
+typedef struct BOP_Delay_Entry_Struct {
+  Addr    line_index;
+  Counter rdy_cycle;
+} BOP_Delay_Entry;
+
+typedef struct Pref_BOP_Struct {
+  HWP_Info* hwp_info;
+
+  // recent requests table: tags of base lines whose prefetch would have
+  // completed by now
+  uns32* rr_table;
+
+  // learning phase state
+  int* offsets;
+  uns  num_offsets;
+  uns* scores;
+  uns  test_index;  // offset tested by the next trigger access
+  uns  round;
+
+  int  best_offset;
+  Flag prefetch_on;
+
+  // base lines waiting to enter the rr table (models the fill latency)
+  BOP_Delay_Entry* delay_queue;
+  uns              delay_head;
+  uns              delay_count;
+} Pref_BOP;
+
+/*************************************************************/
+/* HWP Interface */
+void pref_bop_init(HWP* hwp);
+void pref_bop_per_core_done(uns proc_id);
+void pref_bop_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                       uns32 global_hist);
+void pref_bop_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                          uns32 global_hist);
+
+#endif /*  __PREF_BOP_H__*/
@@ -55,9 +55,12 @@
 #include "prefetcher/l2l1pref.h"
 #include "prefetcher/pref.param.h"
 #include "prefetcher/pref_2dc.h"
+#include "prefetcher/pref_bop.h"
 #include "prefetcher/pref_ghb.h"
+#include "prefetcher/pref_ipstride.h"
 #include "prefetcher/pref_markov.h"
 #include "prefetcher/pref_phase.h"
+#include "prefetcher/pref_spp.h"
 #include "statistics.h"
 /**************************************************************************************
  * Usage Notes
@@ -87,6 +90,17 @@ FILE* PREF_TRACE_OUT;
 FILE* PREF_DEGFB_FILE;
 
 static void pref_core_init(HWP_Core* pref_core);
+static void pref_req_queue_index_init(Pref_Req_Queue_Index* index,
+                                      uns                   queue_size);
+static Pref_Req_Queue_Index_Entry* pref_req_queue_index_lookup(
+  const Pref_Req_Queue_Index* index, Addr line_index);
+static void pref_req_queue_set(Pref_Mem_Req* queue, Pref_Req_Queue_Index* index,
+                               int slot, const Pref_Mem_Req* new_req);
+static void pref_req_queue_invalidate(Pref_Mem_Req*         queue,
+                                      Pref_Req_Queue_Index* index, int slot);
+static int  pref_req_queue_find_valid(const Pref_Mem_Req*   queue,
+                                      Pref_Req_Queue_Index* index,
+                                      uns queue_size, Addr line_index);
 static void pref_update_core(uns proc_id);
 static void pref_polbv_update_on_evict(uns8 pref_proc_id, uns8 evicted_proc_id,
                                        Addr evicted_addr);
@@ -124,6 +138,137 @@ void pref_core_init(HWP_Core* pref_core) {
 
   pref_core->ul1req_queue_req_pos  = -1;
   pref_core->ul1req_queue_send_pos = 0;
+
+  pref_req_queue_index_init(&pref_core->dl0req_queue_index,
+                            PREF_DL0REQ_QUEUE_SIZE);
+  pref_req_queue_index_init(&pref_core->umlc_req_queue_index,
+                            PREF_UMLC_REQ_QUEUE_SIZE);
+  pref_req_queue_index_init(&pref_core->ul1req_queue_index,
+                            PREF_UL1REQ_QUEUE_SIZE);
+}
+
+/**************************************************************************************/
+/* Request queue index: an open addressed (linear probing) hash from line index
+   to the queue slots holding it. The table is at least twice the queue size,
+   so it is never more than half full. */
+
+static inline uns pref_req_queue_index_hash(const Pref_Req_Queue_Index* index,
+                                            Addr line_index) {
+  return (uns)((line_index * 0x9e3779b97f4a7c15ULL) >> 32) & index->mask;
+}
+
+static void pref_req_queue_index_init(Pref_Req_Queue_Index* index,
+                                      uns                   queue_size) {
+  uns num_entries = 1;
+  while(num_entries < 2 * queue_size)
+    num_entries <<= 1;
+  index->entries   = (Pref_Req_Queue_Index_Entry*)calloc(
+    num_entries, sizeof(Pref_Req_Queue_Index_Entry));
+  index->mask      = num_entries - 1;
+  index->num_valid = 0;
+}
+
+static Pref_Req_Queue_Index_Entry* pref_req_queue_index_lookup(
+  const Pref_Req_Queue_Index* index, Addr line_index) {
+  uns pos = pref_req_queue_index_hash(index, line_index);
+  while(index->entries[pos].line_index) {
+    if(index->entries[pos].line_index == line_index)
+      return &index->entries[pos];
+    pos = (pos + 1) & index->mask;
+  }
+  return NULL;
+}
+
+static Pref_Req_Queue_Index_Entry* pref_req_queue_index_insert(
+  Pref_Req_Queue_Index* index, Addr line_index) {
+  uns pos = pref_req_queue_index_hash(index, line_index);
+  while(index->entries[pos].line_index &&
+        index->entries[pos].line_index != line_index)
+    pos = (pos + 1) & index->mask;
+  index->entries[pos].line_index = line_index;
+  return &index->entries[pos];
+}
+
+// backward shift deletion, so lookups never need tombstones
+static void pref_req_queue_index_remove(Pref_Req_Queue_Index*       index,
+                                        Pref_Req_Queue_Index_Entry* entry) {
+  uns hole = entry - index->entries;
+  uns pos  = hole;
+  while(TRUE) {
+    pos = (pos + 1) & index->mask;
+    if(!index->entries[pos].line_index)
+      break;
+    uns home = pref_req_queue_index_hash(index, index->entries[pos].line_index);
+    if(((pos - home) & index->mask) >= ((pos - hole) & index->mask)) {
+      index->entries[hole] = index->entries[pos];
+      hole                 = pos;
+    }
+  }
+  memset(&index->entries[hole], 0, sizeof(Pref_Req_Queue_Index_Entry));
+}
+
+// replaces the request in the given slot, keeping the index in sync
+static void pref_req_queue_set(Pref_Mem_Req* queue, Pref_Req_Queue_Index* index,
+                               int slot, const Pref_Mem_Req* new_req) {
+  Pref_Mem_Req*               old_req = &queue[slot];
+  Pref_Req_Queue_Index_Entry* entry;
+
+  if(old_req->line_index) {
+    entry = pref_req_queue_index_lookup(index, old_req->line_index);
+    ASSERT(0, entry && entry->num_slots > 0);
+    if(old_req->valid) {
+      entry->num_valid--;
+      index->num_valid--;
+    }
+    if(--entry->num_slots == 0)
+      pref_req_queue_index_remove(index, entry);
+  }
+
+  *old_req = *new_req;
+
+  if(new_req->line_index) {
+    entry = pref_req_queue_index_insert(index, new_req->line_index);
+    entry->num_slots++;
+    if(new_req->valid) {
+      if(entry->num_valid++ == 0)
+        entry->valid_slot = slot;
+      index->num_valid++;
+    }
+  }
+}
+
+static void pref_req_queue_invalidate(Pref_Mem_Req*         queue,
+                                      Pref_Req_Queue_Index* index, int slot) {
+  if(!queue[slot].valid)
+    return;
+  Pref_Req_Queue_Index_Entry* entry = pref_req_queue_index_lookup(
+    index, queue[slot].line_index);
+  ASSERT(0, entry && entry->num_valid > 0);
+  entry->num_valid--;
+  index->num_valid--;
+  queue[slot].valid = FALSE;
+}
+
+// returns the lowest valid slot holding line_index, or -1 if there is none
+static int pref_req_queue_find_valid(const Pref_Mem_Req*   queue,
+                                     Pref_Req_Queue_Index* index,
+                                     uns queue_size, Addr line_index) {
+  Pref_Req_Queue_Index_Entry* entry = pref_req_queue_index_lookup(index,
+                                                                  line_index);
+  if(!entry || !entry->num_valid)
+    return -1;
+  if(entry->num_valid == 1 && queue[entry->valid_slot].valid &&
+     queue[entry->valid_slot].line_index == line_index)
+    return entry->valid_slot;
+  // several valid copies (or a stale hint): rare, fall back to a scan
+  for(uns ii = 0; ii < queue_size; ii++) {
+    if(queue[ii].valid && queue[ii].line_index == line_index) {
+      entry->valid_slot = ii;
+      return ii;
+    }
+  }
+  ASSERT(0, FALSE);
+  return -1;
 }
 
 void pref_init(void) {
@@ -177,6 +322,15 @@ void pref_init(void) {
     memset(pref_table[ii].hwp_info->curr_late_core, 0,
            sizeof(Counter) * NUM_CORES);
 
+    pref_table[ii].hwp_info->total_useful_core = (Counter*)calloc(
+      NUM_CORES, sizeof(Counter));
+    pref_table[ii].hwp_info->total_sent_core = (Counter*)calloc(
+      NUM_CORES, sizeof(Counter));
+    pref_table[ii].hwp_info->total_late_core = (Counter*)calloc(
+      NUM_CORES, sizeof(Counter));
+    pref_table[ii].hwp_info->total_misses_core = (Counter*)calloc(
+      NUM_CORES, sizeof(Counter));
+
     pref_table[ii].hwp_info->dyn_degree_core = (uns*)calloc(NUM_CORES,
                                                             sizeof(uns));
     for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
@@ -325,6 +479,7 @@ void pref_umlc_miss(uns8 proc_id, Addr line_addr, Addr load_PC,
 
   for(ii = 0; ii < pref_table_size; ii++) {
     if(pref_table[ii].hwp_info->enabled && pref_table[ii].umlc_miss_func) {
+      pref_table[ii].hwp_info->total_misses_core[proc_id]++;
       pref_table[ii].umlc_miss_func(proc_id, line_addr, load_PC, global_hist);
     }
   }
@@ -354,6 +509,7 @@ void pref_umlc_pref_hit_late(uns8 proc_id, Addr line_addr, Addr load_PC,
     return;
 
   pref_table[prefetcher_id].hwp_info->curr_late_core[proc_id]++;
+  pref_table[prefetcher_id].hwp_info->total_late_core[proc_id]++;
   pref_umlc_pref_hit(proc_id, line_addr, -1, load_PC, global_hist,
                      prefetcher_id);
 }
@@ -373,6 +529,7 @@ void pref_umlc_pref_hit(uns8 proc_id, Addr line_addr, Addr load_PC,
             hexstr64s(0), hexstr64s(line_addr), "UMLC_PREFHIT");
 
   pref_table[prefetcher_id].hwp_info->curr_useful_core[proc_id]++;
+  pref_table[prefetcher_id].hwp_info->total_useful_core[proc_id]++;
 
   for(ii = 0; ii < pref_table_size; ii++) {
     if(pref_table[ii].hwp_info->enabled && pref_table[ii].umlc_pref_hit) {
@@ -404,6 +561,7 @@ void pref_ul1_miss(uns8 proc_id, Addr line_addr, Addr load_PC,
 
   for(ii = 0; ii < pref_table_size; ii++) {
     if(pref_table[ii].hwp_info->enabled && pref_table[ii].ul1_miss_func) {
+      pref_table[ii].hwp_info->total_misses_core[proc_id]++;
       pref_table[ii].ul1_miss_func(proc_id, line_addr, load_PC, global_hist);
     }
   }
@@ -435,6 +593,7 @@ void pref_ul1_pref_hit_late(uns8 proc_id, Addr line_addr, Addr load_PC,
     return;
 
   pref_table[prefetcher_id].hwp_info->curr_late_core[proc_id]++;
+  pref_table[prefetcher_id].hwp_info->total_late_core[proc_id]++;
   pref_ul1_pref_hit(proc_id, line_addr, load_PC, global_hist, -1,
                     prefetcher_id);
   if(PREF_REPORT_PREF_MATCH_AS_MISS)
@@ -458,6 +617,7 @@ void pref_ul1_pref_hit(uns8 proc_id, Addr line_addr, Addr load_PC,
             hexstr64s(0), hexstr64s(line_addr), "UL1_PREFHIT");
 
   pref_table[prefetcher_id].hwp_info->curr_useful_core[proc_id]++;
+  pref_table[prefetcher_id].hwp_info->total_useful_core[proc_id]++;
 
   for(ii = 0; ii < pref_table_size; ii++) {
     if(pref_table[ii].hwp_info->enabled && pref_table[ii].ul1_pref_hit) {
@@ -469,16 +629,16 @@ void pref_ul1_pref_hit(uns8 proc_id, Addr line_addr, Addr load_PC,
 Flag pref_dl0req_queue_filter(Addr line_addr) {
   if(!PREF_DL0REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns           proc_id      = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* dl0req_queue = pref.cores[proc_id]->dl0req_queue;
-  for(uns ii = 0; ii < PREF_DL0REQ_QUEUE_SIZE; ii++) {
-    if(dl0req_queue[ii].valid &&
-       (dl0req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      dl0req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_DL0REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
+  uns       proc_id   = get_proc_id_from_cmp_addr(line_addr);
+  HWP_Core* pref_core = pref.cores[proc_id];
+  int       slot      = pref_req_queue_find_valid(
+    pref_core->dl0req_queue, &pref_core->dl0req_queue_index,
+    PREF_DL0REQ_QUEUE_SIZE, line_addr >> LOG2(DCACHE_LINE_SIZE));
+  if(slot >= 0) {
+    pref_req_queue_invalidate(pref_core->dl0req_queue,
+                              &pref_core->dl0req_queue_index, slot);
+    STAT_EVENT(0, PREF_DL0REQ_QUEUE_HIT_BY_DEMAND);
+    return TRUE;
   }
   return FALSE;
 }
@@ -486,16 +646,16 @@ Flag pref_dl0req_queue_filter(Addr line_addr) {
 Flag pref_umlc_req_queue_filter(Addr line_addr) {
   if(!PREF_UMLC_REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns           proc_id        = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* umlc_req_queue = pref.cores[proc_id]->umlc_req_queue;
-  for(uns ii = 0; ii < PREF_UMLC_REQ_QUEUE_SIZE; ii++) {
-    if(umlc_req_queue[ii].valid &&
-       (umlc_req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      umlc_req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
+  uns       proc_id   = get_proc_id_from_cmp_addr(line_addr);
+  HWP_Core* pref_core = pref.cores[proc_id];
+  int       slot      = pref_req_queue_find_valid(
+    pref_core->umlc_req_queue, &pref_core->umlc_req_queue_index,
+    PREF_UMLC_REQ_QUEUE_SIZE, line_addr >> LOG2(DCACHE_LINE_SIZE));
+  if(slot >= 0) {
+    pref_req_queue_invalidate(pref_core->umlc_req_queue,
+                              &pref_core->umlc_req_queue_index, slot);
+    STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_HIT_BY_DEMAND);
+    return TRUE;
   }
   return FALSE;
 }
@@ -503,51 +663,45 @@ Flag pref_umlc_req_queue_filter(Addr line_addr) {
 Flag pref_ul1req_queue_filter(Addr line_addr) {
   if(!PREF_UL1REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns           proc_id      = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* ul1req_queue = pref.cores[proc_id]->ul1req_queue;
-  for(uns ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-    if(ul1req_queue[ii].valid &&
-       (ul1req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      ul1req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_UL1REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
+  uns       proc_id   = get_proc_id_from_cmp_addr(line_addr);
+  HWP_Core* pref_core = pref.cores[proc_id];
+  int       slot      = pref_req_queue_find_valid(
+    pref_core->ul1req_queue, &pref_core->ul1req_queue_index,
+    PREF_UL1REQ_QUEUE_SIZE, line_addr >> LOG2(DCACHE_LINE_SIZE));
+  if(slot >= 0) {
+    pref_req_queue_invalidate(pref_core->ul1req_queue,
+                              &pref_core->ul1req_queue_index, slot);
+    STAT_EVENT(0, PREF_UL1REQ_QUEUE_HIT_BY_DEMAND);
+    return TRUE;
   }
   return FALSE;
 }
 
 Flag pref_ul1req_queue_match(Addr line_addr) {
-  uns           proc_id      = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* ul1req_queue = pref.cores[proc_id]->ul1req_queue;
-  for(uns ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-    if(ul1req_queue[ii].valid &&
-       (ul1req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) ==
-         (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      return TRUE;
-    }
-  }
-  return FALSE;
+  uns                         proc_id = get_proc_id_from_cmp_addr(line_addr);
+  Pref_Req_Queue_Index_Entry* entry   = pref_req_queue_index_lookup(
+    &pref.cores[proc_id]->ul1req_queue_index,
+    line_addr >> LOG2(DCACHE_LINE_SIZE));
+  return entry && entry->num_valid > 0;
 }
 
 Flag pref_addto_dl0req_queue(uns8 proc_id, Addr line_index,
                              uns8 prefetcher_id) {
-  int          ii;
   Pref_Mem_Req new_req = {0};
   if(!line_index)  // addr = 0
     return TRUE;
   Pref_Mem_Req* dl0req_queue = pref.cores[proc_id]->dl0req_queue;
   int* dl0req_queue_req_pos  = &pref.cores[proc_id]->dl0req_queue_req_pos;
-  if(PREF_DL0REQ_ADD_FILTER_ON) {
-    for(ii = 0; ii < PREF_DL0REQ_QUEUE_SIZE; ii++) {
-      if(dl0req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_DL0REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  Pref_Req_Queue_Index* dl0req_queue_index =
+    &pref.cores[proc_id]->dl0req_queue_index;
+  if(PREF_DL0REQ_ADD_FILTER_ON &&
+     pref_req_queue_index_lookup(dl0req_queue_index, line_index)) {
+    STAT_EVENT(0, PREF_DL0REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if(dl0req_queue[(*dl0req_queue_req_pos + 1) % PREF_DL0REQ_QUEUE_SIZE].valid) {
     STAT_EVENT_ALL(PREF_DL0REQ_QUEUE_FULL);
+    STAT_EVENT(0, PREF_DL0REQ_QUEUE_DROPPED);  // new or overwritten req
     if(!PREF_DL0REQ_QUEUE_OVERWRITE_ON_FULL) {
       return FALSE;  // Q full
     }
@@ -561,29 +715,29 @@ Flag pref_addto_dl0req_queue(uns8 proc_id, Addr line_index,
 
   *dl0req_queue_req_pos = (*dl0req_queue_req_pos + 1) % PREF_DL0REQ_QUEUE_SIZE;
 
-  dl0req_queue[*dl0req_queue_req_pos] = new_req;
+  pref_req_queue_set(dl0req_queue, dl0req_queue_index, *dl0req_queue_req_pos,
+                     &new_req);
   return TRUE;
 }
 
 Flag pref_addto_umlc_req_queue(uns8 proc_id, Addr line_index,
                                uns8 prefetcher_id) {
-  int          ii;
   Pref_Mem_Req new_req = {0};
   if(!line_index)  // addr = 0
     return TRUE;
   Pref_Mem_Req* umlc_req_queue = pref.cores[proc_id]->umlc_req_queue;
   int* umlc_req_queue_req_pos  = &pref.cores[proc_id]->umlc_req_queue_req_pos;
-  if(PREF_UMLC_REQ_ADD_FILTER_ON) {
-    for(ii = 0; ii < PREF_UMLC_REQ_QUEUE_SIZE; ii++) {
-      if(umlc_req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  Pref_Req_Queue_Index* umlc_req_queue_index =
+    &pref.cores[proc_id]->umlc_req_queue_index;
+  if(PREF_UMLC_REQ_ADD_FILTER_ON &&
+     pref_req_queue_index_lookup(umlc_req_queue_index, line_index)) {
+    STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if(umlc_req_queue[(*umlc_req_queue_req_pos + 1) % PREF_UMLC_REQ_QUEUE_SIZE]
        .valid) {
     STAT_EVENT_ALL(PREF_UMLC_REQ_QUEUE_FULL);
+    STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_DROPPED);  // new or overwritten req
     if(!PREF_UMLC_REQ_QUEUE_OVERWRITE_ON_FULL) {
       return FALSE;  // Q full
     }
@@ -600,7 +754,8 @@ Flag pref_addto_umlc_req_queue(uns8 proc_id, Addr line_index,
   *umlc_req_queue_req_pos = (*umlc_req_queue_req_pos + 1) %
                             PREF_UMLC_REQ_QUEUE_SIZE;
 
-  umlc_req_queue[*umlc_req_queue_req_pos] = new_req;
+  pref_req_queue_set(umlc_req_queue, umlc_req_queue_index,
+                     *umlc_req_queue_req_pos, &new_req);
   return TRUE;
 }
 
@@ -613,29 +768,28 @@ Flag pref_addto_ul1req_queue(uns8 proc_id, Addr line_index,
 Flag pref_addto_ul1req_queue_set(uns8 proc_id, Addr line_index,
                                  uns8 prefetcher_id, uns distance, Addr loadPC,
                                  uns32 global_hist, Flag bw) {
-  int          ii;
-  Pref_Mem_Req new_req;
+  Pref_Mem_Req new_req = {0};
   Addr         line_addr;
   if(!line_index)  // addr = 0
     return TRUE;
 
   Pref_Mem_Req* ul1req_queue = pref.cores[proc_id]->ul1req_queue;
   int* ul1req_queue_req_pos  = &pref.cores[proc_id]->ul1req_queue_req_pos;
+  Pref_Req_Queue_Index* ul1req_queue_index =
+    &pref.cores[proc_id]->ul1req_queue_index;
 
   line_addr = (line_index) << LOG2(DCACHE_LINE_SIZE);
 
   pref_feed_back_info_update(prefetcher_id);
 
-  if(PREF_UL1REQ_ADD_FILTER_ON) {
-    for(ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-      if(ul1req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_UL1REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  if(PREF_UL1REQ_ADD_FILTER_ON &&
+     pref_req_queue_index_lookup(ul1req_queue_index, line_index)) {
+    STAT_EVENT(0, PREF_UL1REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if(ul1req_queue[(*ul1req_queue_req_pos + 1) % PREF_UL1REQ_QUEUE_SIZE].valid) {
     STAT_EVENT_ALL(PREF_UL1REQ_QUEUE_FULL);
+    STAT_EVENT(0, PREF_UL1REQ_QUEUE_DROPPED);  // new or overwritten req
     if(!PREF_UL1REQ_QUEUE_OVERWRITE_ON_FULL) {
       return FALSE;  // Q full
     }
@@ -653,7 +807,8 @@ Flag pref_addto_ul1req_queue_set(uns8 proc_id, Addr line_index,
 
   *ul1req_queue_req_pos = (*ul1req_queue_req_pos + 1) % PREF_UL1REQ_QUEUE_SIZE;
 
-  ul1req_queue[*ul1req_queue_req_pos] = new_req;
+  pref_req_queue_set(ul1req_queue, ul1req_queue_index, *ul1req_queue_req_pos,
+                     &new_req);
   return TRUE;
 }
 
@@ -691,6 +846,19 @@ void pref_update_core(uns proc_id) {
   int* umlc_req_queue_send_pos = &pref.cores[proc_id]->umlc_req_queue_send_pos;
   Pref_Mem_Req* ul1req_queue   = pref.cores[proc_id]->ul1req_queue;
   int* ul1req_queue_send_pos   = &pref.cores[proc_id]->ul1req_queue_send_pos;
+  Pref_Req_Queue_Index* umlc_req_queue_index =
+    &pref.cores[proc_id]->umlc_req_queue_index;
+  Pref_Req_Queue_Index* ul1req_queue_index =
+    &pref.cores[proc_id]->ul1req_queue_index;
+
+  // sample the occupancy of the queues before scheduling from them
+  STAT_EVENT(proc_id, PREF_REQ_QUEUE_SAMPLES);
+  INC_STAT_EVENT(proc_id, PREF_DL0REQ_QUEUE_OCCUPANCY,
+                 pref.cores[proc_id]->dl0req_queue_index.num_valid);
+  INC_STAT_EVENT(proc_id, PREF_UMLC_REQ_QUEUE_OCCUPANCY,
+                 umlc_req_queue_index->num_valid);
+  INC_STAT_EVENT(proc_id, PREF_UL1REQ_QUEUE_OCCUPANCY,
+                 ul1req_queue_index->num_valid);
 
   set_dcache_stage(&cmp_model.dcache_stage[proc_id]);
 
@@ -767,7 +935,9 @@ void pref_update_core(uns proc_id) {
         STAT_EVENT(0, PREF_MLCQ_STALL);
         if(PREF_REQ_DROP &&
            MEM_REQ_BUFFER_ENTRIES == mem_get_req_count(proc_id)) {
-          umlc_req_queue[q_index].valid = FALSE;
+          pref_req_queue_invalidate(umlc_req_queue, umlc_req_queue_index,
+                                    q_index);
+          STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_DROPPED);
         } else {
           inc_send_pos = FALSE;
         }
@@ -781,7 +951,8 @@ void pref_update_core(uns proc_id) {
         DEBUG(0, "Sent req %llx to umlc Qpos:%d\n",
               umlc_req_queue[q_index].line_index, *umlc_req_queue_send_pos);
         STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_SENTREQ);
-        umlc_req_queue[q_index].valid = FALSE;
+        pref_req_queue_invalidate(umlc_req_queue, umlc_req_queue_index,
+                                  q_index);
       } else {
         STAT_EVENT(0, PREF_UMLC_REQ_SEND_QUEUE_STALL);
         inc_send_pos = FALSE;
@@ -824,7 +995,8 @@ void pref_update_core(uns proc_id) {
         STAT_EVENT(0, PREF_L1Q_STALL);
         if(PREF_REQ_DROP &&
            MEM_REQ_BUFFER_ENTRIES == mem_get_req_count(proc_id)) {
-          ul1req_queue[q_index].valid = FALSE;
+          pref_req_queue_invalidate(ul1req_queue, ul1req_queue_index, q_index);
+          STAT_EVENT(0, PREF_UL1REQ_QUEUE_DROPPED);
         } else {
           inc_send_pos = FALSE;
         }
@@ -838,7 +1010,7 @@ void pref_update_core(uns proc_id) {
         DEBUG(0, "Sent req %llx to ul1 Qpos:%d\n",
               ul1req_queue[q_index].line_index, *ul1req_queue_send_pos);
         STAT_EVENT(0, PREF_UL1REQ_QUEUE_SENTREQ);
-        ul1req_queue[q_index].valid = FALSE;
+        pref_req_queue_invalidate(ul1req_queue, ul1req_queue_index, q_index);
       } else {
         STAT_EVENT(0, PREF_UL1REQ_SEND_QUEUE_STALL);
         inc_send_pos = FALSE;
@@ -866,6 +1038,7 @@ void pref_ul1sent(uns8 proc_id, Addr addr, uns8 prefetcher_id) {
 
   // prefetch missed in the ul1 and went out on the bus
   pref_table[prefetcher_id].hwp_info->curr_sent_core[proc_id]++;
+  pref_table[prefetcher_id].hwp_info->total_sent_core[proc_id]++;
 
   STAT_EVENT_ALL(PREF_L1_TOTAL_SENT);
   STAT_EVENT(proc_id, CORE_PREF_L1_SENT);
@@ -1373,6 +1546,33 @@ float pref_get_timeliness(uns8 proc_id, uns8 prefetcher_id) {
   return timely;
 }
 
+// fraction of the demand misses the prefetcher trained on that it covered
+float pref_get_coverage(uns8 proc_id, uns8 prefetcher_id) {
+  HWP_Info* hwp_info = pref_table[prefetcher_id].hwp_info;
+  Counter   total    = hwp_info->total_useful_core[proc_id] +
+                  hwp_info->total_misses_core[proc_id];
+  return total ? (float)hwp_info->total_useful_core[proc_id] / (float)total :
+                 0.0;
+}
+
+/* Adds the run totals of a prefetcher to five consecutive stats starting at
+   first_stat: SENT, USEFUL (ratio to SENT, i.e. accuracy), LATE (ratio to
+   USEFUL), COVERAGE_BASE (useful + misses) and COVERED (ratio to
+   COVERAGE_BASE, i.e. coverage). */
+void pref_report_hwp_stats(uns8 proc_id, uns8 prefetcher_id,
+                           Stat_Enum first_stat) {
+  HWP_Info* hwp_info = pref_table[prefetcher_id].hwp_info;
+  INC_STAT_EVENT(proc_id, first_stat, hwp_info->total_sent_core[proc_id]);
+  INC_STAT_EVENT(proc_id, first_stat + 1,
+                 hwp_info->total_useful_core[proc_id]);
+  INC_STAT_EVENT(proc_id, first_stat + 2, hwp_info->total_late_core[proc_id]);
+  INC_STAT_EVENT(proc_id, first_stat + 3,
+                 hwp_info->total_useful_core[proc_id] +
+                   hwp_info->total_misses_core[proc_id]);
+  INC_STAT_EVENT(proc_id, first_stat + 4,
+                 hwp_info->total_useful_core[proc_id]);
+}
+
 float pref_get_ul1pollution(uns8 proc_id) {
   float pol;
   if(PREF_UPDATE_INTERVAL != 0) {
@@ -30,6 +30,7 @@
 #define __PREF_COMMON_H__
 
 #include "memory/mem_req.h"
+#include "statistics.h"
 
 #define PREF_TRACKERS_NUM 16
 
@@ -69,6 +70,12 @@ struct HWP_Info_struct {
   Counter* curr_sent_core;
   Counter* curr_late_core;
 
+  // Totals over the whole run, for end of run reporting
+  Counter* total_useful_core;
+  Counter* total_sent_core;
+  Counter* total_late_core;
+  Counter* total_misses_core;  // demand misses the prefetcher trained on
+
   uns* dyn_degree_core;
 };
 
@@ -123,12 +130,33 @@ struct HWP_struct {
                                             // time
 };
 
+/* Line index hash kept alongside each request queue so that demand filtering
+   and duplicate checks do not have to scan the queue. Every queue slot with a
+   non-zero line_index is counted, valid or not, because the add filters also
+   match requests that were already sent. */
+typedef struct Pref_Req_Queue_Index_Entry_struct {
+  Addr line_index;  // 0 if the entry is unused
+  uns  num_slots;   // queue slots holding this line
+  uns  num_valid;   // valid queue slots holding this line
+  int  valid_slot;  // hint: a slot that was valid for this line
+} Pref_Req_Queue_Index_Entry;
+
+typedef struct Pref_Req_Queue_Index_struct {
+  Pref_Req_Queue_Index_Entry* entries;
+  uns                         mask;
+  uns                         num_valid;  // valid requests in the queue
+} Pref_Req_Queue_Index;
+
 /* Per core prefetching data */
 typedef struct HWP_Core_struct {
   Pref_Mem_Req* dl0req_queue;    // L1 req queue
   Pref_Mem_Req* umlc_req_queue;  // MLC req queue
   Pref_Mem_Req* ul1req_queue;    // L2 req queue
 
+  Pref_Req_Queue_Index dl0req_queue_index;
+  Pref_Req_Queue_Index umlc_req_queue_index;
+  Pref_Req_Queue_Index ul1req_queue_index;
+
   int dl0req_queue_req_pos;
   int dl0req_queue_send_pos;
 
@@ -231,6 +259,10 @@ float       pref_get_timeliness(uns8 proc_id, uns8 prefetcher_id);
 HWP_DynAggr pref_get_degfb(uns8 proc_id, uns8 prefetcher_id);
 
 
+float pref_get_coverage(uns8 proc_id, uns8 prefetcher_id);
+void  pref_report_hwp_stats(uns8 proc_id, uns8 prefetcher_id,
+                            Stat_Enum first_stat);
+
 float pref_get_overallaccuracy(HWP_Type);
 float pref_get_ul1pollution(uns8 proc_id);
 
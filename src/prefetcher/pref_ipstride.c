@@ -0,0 +1,222 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_ipstride.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Per-IP stride/stream classifying prefetcher, after the
+ *                constant stride and global stream classes of IPCP
+ *                (Pakalapati and Panda, ISCA 2020)
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+
+#include "globals/assert.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/pref_common.h"
+#include "prefetcher/pref_ipstride.h"
+#include "prefetcher/pref_ipstride.param.h"
+#include "statistics.h"
+
+/*
+   IP stride/stream prefetcher: each trigger is classified by the load that
+   caused it.
+   - stream: the access falls in a region (PREF_IPSTRIDE_REGION_LINES lines)
+     that has been densely touched. The next lines in the region's dominant
+     direction are prefetched.
+   - stride: the load's last accesses had a constant line stride with enough
+     confidence. The next strides are prefetched.
+   - otherwise nothing is prefetched.
+   Stream takes priority because a dense region makes the per-IP stride
+   meaningless. Prefetches never cross a page.
+*/
+
+/**************************************************************************************/
+/* Macros */
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_PREF_IPSTRIDE, ##args)
+
+/**************************************************************************************/
+/* Global Variables */
+
+Pref_IPStride* ipstride_hwp_core;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void pref_ipstride_train(uns8 proc_id, Addr lineAddr, Addr loadPC);
+
+/**************************************************************************************/
+
+static inline Flag ipstride_same_page(Addr line_index_a, Addr line_index_b) {
+  const uns page_shift = LOG2(VA_PAGE_SIZE_BYTES) - LOG2(DCACHE_LINE_SIZE);
+  return (line_index_a >> page_shift) == (line_index_b >> page_shift);
+}
+
+void pref_ipstride_init(HWP* hwp) {
+  if(!PREF_IPSTRIDE_ON)
+    return;
+  ASSERTM(0, is_power_of_2(PREF_IPSTRIDE_TABLE_N),
+          "pref_ipstride_table_n must be a power of two\n");
+  ASSERTM(0,
+          is_power_of_2(PREF_IPSTRIDE_REGION_LINES) &&
+            PREF_IPSTRIDE_REGION_LINES <= 64,
+          "pref_ipstride_region_lines must be a power of two up to 64\n");
+  ASSERT(0, PREF_IPSTRIDE_REGION_N > 0);
+  hwp->hwp_info->enabled = TRUE;
+
+  ipstride_hwp_core = (Pref_IPStride*)calloc(NUM_CORES, sizeof(Pref_IPStride));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Pref_IPStride* ipstride = &ipstride_hwp_core[proc_id];
+    ipstride->hwp_info      = hwp->hwp_info;
+    ipstride->ip_table      = (IPStride_Table_Entry*)calloc(
+      PREF_IPSTRIDE_TABLE_N, sizeof(IPStride_Table_Entry));
+    ipstride->region_table = (IPStride_Region_Entry*)calloc(
+      PREF_IPSTRIDE_REGION_N, sizeof(IPStride_Region_Entry));
+  }
+}
+
+void pref_ipstride_per_core_done(uns proc_id) {
+  pref_report_hwp_stats(proc_id, ipstride_hwp_core[proc_id].hwp_info->id,
+                        PREF_IPSTRIDE_SENT);
+}
+
+void pref_ipstride_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                            uns32 global_hist) {
+  pref_ipstride_train(proc_id, lineAddr, loadPC);
+}
+
+void pref_ipstride_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                               uns32 global_hist) {
+  pref_ipstride_train(proc_id, lineAddr, loadPC);
+}
+
+// records the access in its region and returns the region
+static IPStride_Region_Entry* ipstride_update_region(Pref_IPStride* ipstride,
+                                                     Addr lineIndex) {
+  const uns region_shift = LOG2(PREF_IPSTRIDE_REGION_LINES);
+  Addr      region       = lineIndex >> region_shift;
+  uns       bit          = lineIndex & N_BIT_MASK(region_shift);
+  IPStride_Region_Entry* entry = NULL;
+
+  for(uns ii = 0; ii < PREF_IPSTRIDE_REGION_N; ii++) {
+    IPStride_Region_Entry* cand = &ipstride->region_table[ii];
+    if(cand->valid && cand->region == region) {
+      entry = cand;
+      break;
+    }
+    if(!entry || (entry->valid &&
+                  (!cand->valid || cand->last_access < entry->last_access)))
+      entry = cand;
+  }
+
+  if(!entry->valid || entry->region != region) {
+    memset(entry, 0, sizeof(IPStride_Region_Entry));
+    entry->valid     = TRUE;
+    entry->region    = region;
+    entry->last_line = lineIndex;
+  }
+  entry->last_access = cycle_count;
+
+  if(!(entry->touched & (1ULL << bit))) {
+    entry->touched |= 1ULL << bit;
+    entry->num_touched++;
+  }
+  if(lineIndex > entry->last_line)
+    entry->direction++;
+  else if(lineIndex < entry->last_line)
+    entry->direction--;
+  entry->last_line = lineIndex;
+  return entry;
+}
+
+static void ipstride_issue(uns8 proc_id, Pref_IPStride* ipstride,
+                           Addr lineIndex, int stride, uns degree) {
+  for(uns ii = 1; ii <= degree; ii++) {
+    Addr pref_index = lineIndex + (int)ii * stride;
+    if(!ipstride_same_page(lineIndex, pref_index))
+      break;
+    ASSERT(proc_id,
+           proc_id == (pref_index >> (58 - LOG2(DCACHE_LINE_SIZE))));
+    if(!pref_addto_ul1req_queue(proc_id, pref_index, ipstride->hwp_info->id))
+      break;  // q is full
+    STAT_EVENT(proc_id, PREF_IPSTRIDE_ISSUED);
+  }
+}
+
+static void pref_ipstride_train(uns8 proc_id, Addr lineAddr, Addr loadPC) {
+  Pref_IPStride*         ipstride  = &ipstride_hwp_core[proc_id];
+  Addr                   lineIndex = lineAddr >> LOG2(DCACHE_LINE_SIZE);
+  IPStride_Region_Entry* region = ipstride_update_region(ipstride, lineIndex);
+
+  if(loadPC == 0) {
+    return;  // no point hashing on a null address
+  }
+  STAT_EVENT(proc_id, PREF_IPSTRIDE_TRIGGERS);
+
+  uns index = ((loadPC >> 2) ^ (loadPC >> (2 + LOG2(PREF_IPSTRIDE_TABLE_N)))) &
+              (PREF_IPSTRIDE_TABLE_N - 1);
+  IPStride_Table_Entry* entry = &ipstride->ip_table[index];
+  if(!entry->valid || entry->load_addr != loadPC) {
+    memset(entry, 0, sizeof(IPStride_Table_Entry));
+    entry->valid     = TRUE;
+    entry->load_addr = loadPC;
+  } else {
+    int stride = lineIndex - entry->last_line;
+    if(stride != 0) {
+      if(stride == entry->stride) {
+        if(entry->conf < PREF_IPSTRIDE_CONF_MAX)
+          entry->conf++;
+      } else if(entry->conf > 0) {
+        entry->conf--;
+      } else {
+        entry->stride = stride;
+      }
+    }
+  }
+  entry->last_line = lineIndex;
+
+  if(region->num_touched * 100 >=
+     PREF_IPSTRIDE_DENSE_THRESHOLD * PREF_IPSTRIDE_REGION_LINES) {
+    STAT_EVENT(proc_id, PREF_IPSTRIDE_STREAM_TRIGGERS);
+    ipstride_issue(proc_id, ipstride, lineIndex,
+                   region->direction >= 0 ? 1 : -1,
+                   PREF_IPSTRIDE_STREAM_DEGREE);
+  } else if(entry->stride != 0 &&
+            entry->conf >= PREF_IPSTRIDE_CONF_THRESHOLD) {
+    STAT_EVENT(proc_id, PREF_IPSTRIDE_STRIDE_TRIGGERS);
+    ipstride_issue(proc_id, ipstride, lineIndex, entry->stride,
+                   PREF_IPSTRIDE_STRIDE_DEGREE);
+  } else {
+    STAT_EVENT(proc_id, PREF_IPSTRIDE_UNCLASSIFIED);
+  }
+  DEBUG(proc_id, "IP %llx line %llx stride %d conf %u region touched %u\n",
+        loadPC, lineIndex, entry->stride, entry->conf, region->num_touched);
+}
@@ -0,0 +1,68 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_ipstride.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Per-IP stride/stream classifying prefetcher, after the
+ *                constant stride and global stream classes of IPCP
+ *                (Pakalapati and Panda, ISCA 2020)
+ ***************************************************************************************/
+#ifndef __PREF_IPSTRIDE_H__
+#define __PREF_IPSTRIDE_H__
+
+#include "pref_common.h"
+
+typedef struct IPStride_Table_Entry_Struct {
+  Flag valid;
+  Addr load_addr;
+  Addr last_line;
+  int  stride;
+  uns  conf;
+} IPStride_Table_Entry;
+
+typedef struct IPStride_Region_Entry_Struct {
+  Flag    valid;
+  Addr    region;
+  uns64   touched;  // bitmap of the lines accessed in the region
+  uns     num_touched;
+  int     direction;  // > 0 if accesses mostly ascend
+  Addr    last_line;
+  Counter last_access;  // for lru
+} IPStride_Region_Entry;
+
+typedef struct Pref_IPStride_Struct {
+  HWP_Info*              hwp_info;
+  IPStride_Table_Entry*  ip_table;
+  IPStride_Region_Entry* region_table;
+} Pref_IPStride;
+
+/*************************************************************/
+/* HWP Interface */
+void pref_ipstride_init(HWP* hwp);
+void pref_ipstride_per_core_done(uns proc_id);
+void pref_ipstride_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                            uns32 global_hist);
+void pref_ipstride_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                               uns32 global_hist);
+
+#endif /*  __PREF_IPSTRIDE_H__*/
@@ -0,0 +1,359 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_spp.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Signature Path Prefetcher (Kim et al., MICRO 2016) with a
+ *                Perceptron-based Prefetch Filter (Bhatia et al., ISCA 2019)
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+
+#include "globals/assert.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/pref_common.h"
+#include "prefetcher/pref_spp.h"
+#include "prefetcher/pref_spp.param.h"
+#include "statistics.h"
+
+/*
+   Signature path prefetcher: every page keeps a signature, a short hash of
+   the last few line deltas seen in it. The pattern table maps a signature to
+   the deltas that followed it, with counters that give each delta's
+   probability. On a trigger SPP walks this chain ahead of the demand stream,
+   multiplying the probabilities along the way, and offers every delta whose
+   path confidence is above the prefetch threshold as a candidate. It stops
+   when the confidence of the most likely path drops below the lookahead
+   threshold.
+
+   With PREF_SPP_PPF_ON, SPP's candidates go through a perceptron filter
+   instead of being issued directly. The filter sums one weight per feature
+   of the candidate and issues it if the sum reaches the threshold. Weights
+   are trained up when an issued or rejected line is later demanded, and down
+   when an issued line's record is replaced without the line being used.
+   Eviction of unused prefetches is not visible to HWPs, so record
+   replacement stands in for it.
+*/
+
+/**************************************************************************************/
+/* Macros */
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_PREF_SPP, ##args)
+
+#define SPP_PAGE_SHIFT (LOG2(VA_PAGE_SIZE_BYTES) - LOG2(DCACHE_LINE_SIZE))
+#define SPP_PAGE_LINES (1U << SPP_PAGE_SHIFT)
+
+/**************************************************************************************/
+/* Global Variables */
+
+Pref_SPP* spp_hwp_core;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static void pref_spp_train(uns8 proc_id, Addr lineAddr, Addr loadPC);
+
+/**************************************************************************************/
+
+static inline uns spp_hash(Addr key, uns entries) {
+  return (key ^ (key >> 13) ^ (key >> 27)) & (entries - 1);
+}
+
+// deltas are folded into the signature in sign-magnitude form
+static inline uns spp_next_signature(uns signature, int delta) {
+  uns delta_bits = delta < 0 ? ((uns)(-delta) & N_BIT_MASK(SPP_PAGE_SHIFT)) |
+                                 (1U << SPP_PAGE_SHIFT) :
+                               (uns)delta;
+  return ((signature << 3) ^ delta_bits) & N_BIT_MASK(PREF_SPP_SIG_BITS);
+}
+
+void pref_spp_init(HWP* hwp) {
+  if(!PREF_SPP_ON)
+    return;
+  ASSERTM(0,
+          is_power_of_2(PREF_SPP_ST_N) && is_power_of_2(PREF_SPP_PT_N) &&
+            is_power_of_2(PREF_SPP_PPF_TABLE_N) &&
+            is_power_of_2(PREF_SPP_PPF_RECORD_N),
+          "SPP table sizes must be powers of two\n");
+  ASSERT(0, PREF_SPP_PT_DELTAS > 0 && PREF_SPP_COUNTER_MAX > 1);
+  ASSERT(0, PREF_SPP_PPF_WEIGHT_BITS > 1 && PREF_SPP_PPF_WEIGHT_BITS < 16);
+  hwp->hwp_info->enabled = TRUE;
+
+  spp_hwp_core = (Pref_SPP*)calloc(NUM_CORES, sizeof(Pref_SPP));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Pref_SPP* spp = &spp_hwp_core[proc_id];
+    spp->hwp_info = hwp->hwp_info;
+
+    spp->signature_table = (SPP_Signature_Entry*)calloc(
+      PREF_SPP_ST_N, sizeof(SPP_Signature_Entry));
+    spp->pattern_table = (SPP_Pattern_Entry*)calloc(PREF_SPP_PT_N,
+                                                    sizeof(SPP_Pattern_Entry));
+    for(uns ii = 0; ii < PREF_SPP_PT_N; ii++) {
+      spp->pattern_table[ii].deltas  = (int*)calloc(PREF_SPP_PT_DELTAS,
+                                                   sizeof(int));
+      spp->pattern_table[ii].c_delta = (uns*)calloc(PREF_SPP_PT_DELTAS,
+                                                    sizeof(uns));
+    }
+
+    for(uns ii = 0; ii < SPP_PPF_NUM_FEATURES; ii++) {
+      spp->ppf_weights[ii] = (int*)calloc(PREF_SPP_PPF_TABLE_N, sizeof(int));
+    }
+    spp->ppf_issued   = (SPP_PPF_Record*)calloc(PREF_SPP_PPF_RECORD_N,
+                                              sizeof(SPP_PPF_Record));
+    spp->ppf_rejected = (SPP_PPF_Record*)calloc(PREF_SPP_PPF_RECORD_N,
+                                                sizeof(SPP_PPF_Record));
+  }
+}
+
+void pref_spp_per_core_done(uns proc_id) {
+  pref_report_hwp_stats(proc_id, spp_hwp_core[proc_id].hwp_info->id,
+                        PREF_SPP_SENT);
+}
+
+void pref_spp_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                       uns32 global_hist) {
+  pref_spp_train(proc_id, lineAddr, loadPC);
+}
+
+void pref_spp_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                          uns32 global_hist) {
+  pref_spp_train(proc_id, lineAddr, loadPC);
+}
+
+/**************************************************************************************/
+/* Perceptron prefetch filter */
+
+static int ppf_sum(Pref_SPP* spp, const uns* feature_index) {
+  int sum = 0;
+  for(uns ii = 0; ii < SPP_PPF_NUM_FEATURES; ii++)
+    sum += spp->ppf_weights[ii][feature_index[ii]];
+  return sum;
+}
+
+static void ppf_train(uns8 proc_id, Pref_SPP* spp, const uns* feature_index,
+                      Flag positive) {
+  const int weight_max = (1 << (PREF_SPP_PPF_WEIGHT_BITS - 1)) - 1;
+  const int weight_min = -(1 << (PREF_SPP_PPF_WEIGHT_BITS - 1));
+  int       sum        = ppf_sum(spp, feature_index);
+
+  // only train while the perceptron is not yet confident in this direction
+  if(positive ? sum >= PREF_SPP_PPF_POS_THRESHOLD :
+                sum <= PREF_SPP_PPF_NEG_THRESHOLD)
+    return;
+  for(uns ii = 0; ii < SPP_PPF_NUM_FEATURES; ii++) {
+    int* weight = &spp->ppf_weights[ii][feature_index[ii]];
+    if(positive && *weight < weight_max)
+      (*weight)++;
+    else if(!positive && *weight > weight_min)
+      (*weight)--;
+  }
+  STAT_EVENT(proc_id, positive ? PREF_SPP_PPF_TRAIN_POSITIVE :
+                                 PREF_SPP_PPF_TRAIN_NEGATIVE);
+}
+
+static void ppf_features(Addr line_index, Addr loadPC, uns signature,
+                         int delta, uns depth, uns confidence,
+                         uns* feature_index) {
+  const uns n = PREF_SPP_PPF_TABLE_N;
+  feature_index[0] = spp_hash(loadPC, n);
+  feature_index[1] = spp_hash(loadPC ^ ((Addr)depth << 16), n);
+  feature_index[2] = spp_hash(loadPC ^ ((Addr)(delta + SPP_PAGE_LINES) << 20),
+                              n);
+  feature_index[3] = line_index & (n - 1);
+  feature_index[4] = spp_hash(line_index >> SPP_PAGE_SHIFT, n);
+  feature_index[5] = confidence & (n - 1);
+  feature_index[6] = spp_hash(
+    signature ^ ((Addr)(delta + SPP_PAGE_LINES) << PREF_SPP_SIG_BITS), n);
+}
+
+static void ppf_record(SPP_PPF_Record* record, Addr line_index,
+                       const uns* feature_index) {
+  record->valid      = TRUE;
+  record->used       = FALSE;
+  record->line_index = line_index;
+  memcpy(record->feature_index, feature_index, sizeof(record->feature_index));
+}
+
+// a demand access to line_index: reward the filter for issuing it, or for
+// not having rejected it
+static void ppf_demand(uns8 proc_id, Pref_SPP* spp, Addr line_index) {
+  uns             pos      = spp_hash(line_index, PREF_SPP_PPF_RECORD_N);
+  SPP_PPF_Record* issued   = &spp->ppf_issued[pos];
+  SPP_PPF_Record* rejected = &spp->ppf_rejected[pos];
+
+  if(issued->valid && issued->line_index == line_index && !issued->used) {
+    issued->used = TRUE;
+    ppf_train(proc_id, spp, issued->feature_index, TRUE);
+  }
+  if(rejected->valid && rejected->line_index == line_index) {
+    rejected->valid = FALSE;
+    ppf_train(proc_id, spp, rejected->feature_index, TRUE);
+  }
+}
+
+/**************************************************************************************/
+/* Signature path prefetcher */
+
+static void spp_update_pattern(SPP_Pattern_Entry* pattern, int delta) {
+  uns slot = 0;
+  for(uns ii = 0; ii < PREF_SPP_PT_DELTAS; ii++) {
+    if(pattern->c_delta[ii] && pattern->deltas[ii] == delta) {
+      slot = ii;
+      break;
+    }
+    if(pattern->c_delta[ii] < pattern->c_delta[slot])
+      slot = ii;
+  }
+  if(pattern->c_delta[slot] == 0 || pattern->deltas[slot] != delta) {
+    pattern->deltas[slot]  = delta;
+    pattern->c_delta[slot] = 0;
+  }
+
+  pattern->c_delta[slot]++;
+  pattern->c_sig++;
+  if(pattern->c_sig >= PREF_SPP_COUNTER_MAX ||
+     pattern->c_delta[slot] >= PREF_SPP_COUNTER_MAX) {
+    pattern->c_sig /= 2;
+    for(uns ii = 0; ii < PREF_SPP_PT_DELTAS; ii++)
+      pattern->c_delta[ii] /= 2;
+  }
+}
+
+// returns TRUE if the candidate was issued
+static Flag spp_issue(uns8 proc_id, Pref_SPP* spp, Addr pref_index,
+                      Addr loadPC, uns signature, int delta, uns depth,
+                      uns confidence) {
+  uns feature_index[SPP_PPF_NUM_FEATURES];
+
+  STAT_EVENT(proc_id, PREF_SPP_CANDIDATES);
+  if(PREF_SPP_PPF_ON) {
+    ppf_features(pref_index, loadPC, signature, delta, depth, confidence,
+                 feature_index);
+    uns pos = spp_hash(pref_index, PREF_SPP_PPF_RECORD_N);
+    if(ppf_sum(spp, feature_index) < PREF_SPP_PPF_THRESHOLD) {
+      STAT_EVENT(proc_id, PREF_SPP_PPF_REJECTED);
+      ppf_record(&spp->ppf_rejected[pos], pref_index, feature_index);
+      return FALSE;
+    }
+    STAT_EVENT(proc_id, PREF_SPP_PPF_ACCEPTED);
+    SPP_PPF_Record* issued = &spp->ppf_issued[pos];
+    if(issued->valid && !issued->used && issued->line_index != pref_index)
+      ppf_train(proc_id, spp, issued->feature_index, FALSE);
+    if(!issued->valid || issued->line_index != pref_index)
+      ppf_record(issued, pref_index, feature_index);
+  }
+
+  ASSERT(proc_id, proc_id == (pref_index >> (58 - LOG2(DCACHE_LINE_SIZE))));
+  if(!pref_addto_ul1req_queue(proc_id, pref_index, spp->hwp_info->id))
+    return FALSE;  // q is full
+  STAT_EVENT(proc_id, PREF_SPP_ISSUED);
+  return TRUE;
+}
+
+static void spp_lookahead(uns8 proc_id, Pref_SPP* spp, Addr page,
+                          uns offset, uns signature, Addr loadPC) {
+  uns confidence    = 100;  // path confidence in percent
+  uns num_prefetches = 0;
+  uns depth;
+
+  for(depth = 0; depth < PREF_SPP_MAX_DEPTH; depth++) {
+    SPP_Pattern_Entry* pattern = &spp->pattern_table[spp_hash(
+      signature, PREF_SPP_PT_N)];
+    if(pattern->c_sig == 0)
+      break;
+
+    int best = -1;
+    for(uns ii = 0; ii < PREF_SPP_PT_DELTAS; ii++) {
+      if(!pattern->c_delta[ii])
+        continue;
+      if(best < 0 || pattern->c_delta[ii] > pattern->c_delta[best])
+        best = ii;
+
+      uns delta_confidence = confidence * pattern->c_delta[ii] /
+                             pattern->c_sig;
+      int target           = (int)offset + pattern->deltas[ii];
+      if(delta_confidence < PREF_SPP_PREFETCH_THRESHOLD || target < 0 ||
+         target >= (int)SPP_PAGE_LINES)
+        continue;
+      if(num_prefetches >= PREF_SPP_MAX_PREFETCHES)
+        break;
+      Addr pref_index = (page << SPP_PAGE_SHIFT) + target;
+      if(spp_issue(proc_id, spp, pref_index, loadPC, signature,
+                   pattern->deltas[ii], depth, delta_confidence))
+        num_prefetches++;
+    }
+    if(best < 0 || num_prefetches >= PREF_SPP_MAX_PREFETCHES)
+      break;
+
+    confidence = confidence * pattern->c_delta[best] / pattern->c_sig;
+    int next   = (int)offset + pattern->deltas[best];
+    if(confidence < PREF_SPP_LOOKAHEAD_THRESHOLD || next < 0 ||
+       next >= (int)SPP_PAGE_LINES)
+      break;
+    offset    = next;
+    signature = spp_next_signature(signature, pattern->deltas[best]);
+  }
+  INC_STAT_EVENT(proc_id, PREF_SPP_LOOKAHEAD_DEPTH, depth);
+}
+
+static void pref_spp_train(uns8 proc_id, Addr lineAddr, Addr loadPC) {
+  Pref_SPP*            spp       = &spp_hwp_core[proc_id];
+  Addr                 lineIndex = lineAddr >> LOG2(DCACHE_LINE_SIZE);
+  Addr                 page      = lineIndex >> SPP_PAGE_SHIFT;
+  uns                  offset    = lineIndex & N_BIT_MASK(SPP_PAGE_SHIFT);
+  SPP_Signature_Entry* entry     = &spp->signature_table[spp_hash(
+    page, PREF_SPP_ST_N)];
+
+  STAT_EVENT(proc_id, PREF_SPP_TRIGGERS);
+  if(PREF_SPP_PPF_ON)
+    ppf_demand(proc_id, spp, lineIndex);
+
+  if(!entry->valid || entry->page != page) {
+    entry->valid       = TRUE;
+    entry->page        = page;
+    entry->last_offset = offset;
+    entry->signature   = 0;
+    return;
+  }
+
+  int delta = (int)offset - (int)entry->last_offset;
+  if(delta == 0)
+    return;
+
+  spp_update_pattern(
+    &spp->pattern_table[spp_hash(entry->signature, PREF_SPP_PT_N)], delta);
+  entry->signature   = spp_next_signature(entry->signature, delta);
+  entry->last_offset = offset;
+
+  DEBUG(proc_id, "SPP page %llx offset %u delta %d signature %x\n", page,
+        offset, delta, entry->signature);
+  spp_lookahead(proc_id, spp, page, offset, entry->signature, loadPC);
+}
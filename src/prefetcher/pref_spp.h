@@ -0,0 +1,78 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : pref_spp.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Signature Path Prefetcher (Kim et al., MICRO 2016) with a
+ *                Perceptron-based Prefetch Filter (Bhatia et al., ISCA 2019)
+ ***************************************************************************************/
+#ifndef __PREF_SPP_H__
+#define __PREF_SPP_H__
+
+#include "pref_common.h"
+
+#define SPP_PPF_NUM_FEATURES 7
+
+typedef struct SPP_Signature_Entry_Struct {
+  Flag valid;
+  Addr page;
+  uns  last_offset;
+  uns  signature;
+} SPP_Signature_Entry;
+
+typedef struct SPP_Pattern_Entry_Struct {
+  uns  c_sig;
+  int* deltas;
+  uns* c_delta;
+} SPP_Pattern_Entry;
+
+// a filtered candidate, kept until the line is demanded or the record is
+// replaced
+typedef struct SPP_PPF_Record_Struct {
+  Flag valid;
+  Flag used;
+  Addr line_index;
+  uns  feature_index[SPP_PPF_NUM_FEATURES];
+} SPP_PPF_Record;
+
+typedef struct Pref_SPP_Struct {
+  HWP_Info* hwp_info;
+
+  SPP_Signature_Entry* signature_table;
+  SPP_Pattern_Entry*   pattern_table;
+
+  int*            ppf_weights[SPP_PPF_NUM_FEATURES];
+  SPP_PPF_Record* ppf_issued;    // candidates that were prefetched
+  SPP_PPF_Record* ppf_rejected;  // candidates the filter dropped
+} Pref_SPP;
+
+/*************************************************************/
+/* HWP Interface */
+void pref_spp_init(HWP* hwp);
+void pref_spp_per_core_done(uns proc_id);
+void pref_spp_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                       uns32 global_hist);
+void pref_spp_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
+                          uns32 global_hist);
+
+#endif /*  __PREF_SPP_H__*/
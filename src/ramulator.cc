@@ -27,9 +27,9 @@
  ***************************************************************************************/
 
 #include <deque>
-#include <list>
-#include <map>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 
 #include "ramulator/Config.h"
@@ -69,8 +69,9 @@ void stats_callback(int coreid, int type);
 deque<pair<long, Mem_Req*>> resp_queue;  // completed read request that need to
                                          // send back to Scarab
 
-map<long, list<Mem_Req*>> inflight_read_reqs;
-// map<long, Mem_Req*> inflight_read_reqs;
+// Scarab requests waiting on an in-flight Ramulator read, keyed by physical
+// address. At most one Ifetch and one Dfetch request can share an entry.
+unordered_map<long, vector<Mem_Req*>> inflight_read_reqs;
 
 void ramulator_init() {
   ASSERTM(0, ICACHE_LINE_SIZE == DCACHE_LINE_SIZE,
@@ -85,6 +86,9 @@ void ramulator_init() {
 
   wrapper = new ScarabWrapper(*configs, DCACHE_LINE_SIZE, &stats_callback);
 
+  inflight_read_reqs.reserve(NUM_CORES * (RAMULATOR_READQ_ENTRIES +
+                                          MEM_L1_FILL_QUEUE_ENTRIES));
+
   DPRINTF("Initialized Ramulator. \n");
 }
 
@@ -144,6 +148,7 @@ void init_configs() {
   configs->add("readq_entries", to_string(RAMULATOR_READQ_ENTRIES));
   configs->add("writeq_entries", to_string(RAMULATOR_WRITEQ_ENTRIES));
   configs->add("output_dir", OUTPUT_DIR);
+  configs->add("tick_threads", to_string(RAMULATOR_TICK_THREADS));
 
   // TODO: make these optional and use the preset values specified by
   // RAMULATOR_SPEED for timings that are not explicitly provided in
@@ -296,12 +301,33 @@ void to_ramulator_req(const Mem_Req* scarab_req, Request* ramulator_req) {
 }
 
 void ramulator_tick() {
-  wrapper->tick();
+  Flag ticked = wrapper->tick();
+
+  STAT_EVENT(0, RAMULATOR_CYCLES);
+  if(!ticked)
+    STAT_EVENT(0, RAMULATOR_IDLE_CYCLES);
+
+  if(resp_queue.empty())
+    return;
 
-  if(resp_queue.size() > 0) {
-    if(try_completing_request(resp_queue.front().second))
-      resp_queue.pop_front();
+  // Reads completed by different channels in the same cycle are returned
+  // together, as long as the L1 fill queue has room for them
+  uns drain_width = RAMULATOR_RESP_DRAIN_WIDTH ? RAMULATOR_RESP_DRAIN_WIDTH :
+                                                 RAMULATOR_CHANNELS;
+  uns delivered   = 0;
+
+  INC_STAT_EVENT(0, RAMULATOR_RESP_QUEUE_OCCUPANCY, resp_queue.size());
+  while(!resp_queue.empty() && delivered < drain_width) {
+    if(!try_completing_request(resp_queue.front().second)) {
+      STAT_EVENT(0, RAMULATOR_RESP_L1FILL_FULL);
+      break;
+    }
+    resp_queue.pop_front();
+    delivered++;
   }
+  if(!resp_queue.empty() && delivered == drain_width)
+    STAT_EVENT(0, RAMULATOR_RESP_WIDTH_LIMITED);
+  INC_STAT_EVENT(0, RAMULATOR_RESP_DELIVERED, delivered);
 }
 
 int ramulator_get_chip_width() {
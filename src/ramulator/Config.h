@@ -70,7 +70,8 @@ private:
         // Other
         {"record_cmd_trace", "off"},
         {"print_cmd_trace", "off"},
-        {"use_rest_of_addr_as_row_addr", "on"}
+        {"use_rest_of_addr_as_row_addr", "on"},
+        {"tick_threads", "1"}
     };
 
 	template<typename T>
@@ -88,7 +88,7 @@ void Controller<TLDRAM>::tick(){
                   channel->update_serving_requests(
                       req.addr_vec.data(), -1, clk);
           }
-            req.callback(req);
+            respond(req);
             pending.pop_front();
         }
     }
@@ -184,6 +184,12 @@ void Controller<TLDRAM>::tick(){
     queue->q.erase(req);
 }
 
+// TLDRAM migrates rows in its tick(), so it is never fast-forwarded
+template <>
+long Controller<TLDRAM>::get_next_event_cycle(){
+    return clk + 1;
+}
+
 template<>
 void Controller<TLDRAM>::cmd_issue_autoprecharge(typename TLDRAM::Command& cmd,
                                                     const vector<int>& addr_vec) {
@@ -127,6 +127,14 @@ public:
     // callback function for passing stats to Scarab when an event occurs
     void (*stats_callback)(int, int) = nullptr;
 
+    // When set, read responses, stats callbacks and the printed command trace
+    // are buffered by tick() and delivered later by flush_callbacks(). Used
+    // when the channels of a memory are ticked concurrently.
+    bool defer_callbacks = false;
+    vector<Request> deferred_responses;
+    vector<pair<int, int>> deferred_stats;
+    string deferred_cmd_trace;
+
 
     /* Constructor */
     Controller(const Config& configs, DRAM<T>* channel, void (*_stats_callback)(int,int)) :
@@ -377,7 +385,7 @@ public:
                   channel->update_serving_requests(
                       req.addr_vec.data(), -1, clk);
                 }
-                req.callback(req);
+                respond(req);
                 pending.pop_front();
             }
         }
@@ -490,6 +498,52 @@ public:
         queue->q.erase(req);
     }
 
+    // The earliest clock at which tick() can change any state other than the
+    // clock itself and the per-cycle queue-length sums. Every tick() strictly
+    // before that clock is idle and can be replaced by fast_forward().
+    long get_next_event_cycle()
+    {
+        if (readq.size() || actq.size() || otherq.size())
+            return clk + 1;
+        // writes are held back until the controller switches to write mode
+        if (writeq.size() && (write_mode ||
+                writeq.size() > unsigned(wr_high_watermark * writeq.max)))
+            return clk + 1;
+        // speculative precharges may be issued even with empty queues
+        if (rowpolicy->type != RowPolicy<T>::Type::Opened && rowtable->table.size())
+            return clk + 1;
+
+        long next = refresh->get_next_refresh_cycle();
+        if (pending.size())
+            next = min(next, pending[0].depart);
+        return max(next, clk + 1);
+    }
+
+    // Equivalent to calling tick() 'cycles' times while idle
+    void fast_forward(long cycles)
+    {
+        assert(clk + cycles < get_next_event_cycle());
+        clk += cycles;
+        req_queue_length_sum += cycles * (writeq.size() + pending.size());
+        read_req_queue_length_sum += cycles * pending.size();
+        write_req_queue_length_sum += cycles * writeq.size();
+        refresh->fast_forward(cycles);
+    }
+
+    // Deliver buffered callbacks in the order tick() produced them
+    void flush_callbacks()
+    {
+        for (auto& req : deferred_responses)
+            req.callback(req);
+        for (auto& stat : deferred_stats)
+            stats_callback(stat.first, stat.second);
+        if (!deferred_cmd_trace.empty())
+            fputs(deferred_cmd_trace.c_str(), stdout);
+        deferred_responses.clear();
+        deferred_stats.clear();
+        deferred_cmd_trace.clear();
+    }
+
     bool is_ready(list<Request>::iterator req)
     {
         typename T::Command cmd = get_first_cmd(req);
@@ -559,6 +613,22 @@ public:
     }
 
 private:
+    void respond(Request& req)
+    {
+        if (defer_callbacks)
+            deferred_responses.push_back(req);
+        else
+            req.callback(req);
+    }
+
+    void stat_event(int coreid, StatCallbackType type)
+    {
+        if (defer_callbacks)
+            deferred_stats.push_back(make_pair(coreid, int(type)));
+        else
+            stats_callback(coreid, int(type));
+    }
+
     typename T::Command get_first_cmd(list<Request>::iterator req)
     {
         typename T::Command cmd = channel->spec->translate[int(req->type)];
@@ -622,16 +692,16 @@ private:
         channel->update(cmd, addr_vec.data(), clk);
 
         if(channel->spec->is_opening(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_ACT));
+            stat_event(coreid, StatCallbackType::DRAM_ACT);
 
         if(channel->spec->is_closing(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_PRE));
+            stat_event(coreid, StatCallbackType::DRAM_PRE);
         
         if(channel->spec->is_reading(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_READ));
+            stat_event(coreid, StatCallbackType::DRAM_READ);
 
         if(channel->spec->is_writing(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_WRITE));
+            stat_event(coreid, StatCallbackType::DRAM_WRITE);
 
 
         if(cmd == T::Command::PRE){
@@ -657,10 +727,21 @@ private:
             }
         }
         if (print_cmd_trace){
-            printf("%5s %10ld:", channel->spec->command_name[int(cmd)].c_str(), clk);
-            for (int lev = 0; lev < int(T::Level::MAX); lev++)
-                printf(" %5d", addr_vec[lev]);
-            printf("\n");
+            // format into a buffer so a parallel tick can print it in channel
+            // order from flush_callbacks()
+            char buf[32];
+            string line;
+            snprintf(buf, sizeof(buf), "%5s %10ld:", channel->spec->command_name[int(cmd)].c_str(), clk);
+            line += buf;
+            for (int lev = 0; lev < int(T::Level::MAX); lev++) {
+                snprintf(buf, sizeof(buf), " %5d", addr_vec[lev]);
+                line += buf;
+            }
+            line += "\n";
+            if (defer_callbacks)
+                deferred_cmd_trace += line;
+            else
+                fputs(line.c_str(), stdout);
         }
     }
     vector<int> get_addr_vec(typename T::Command cmd, list<Request>::iterator req){
@@ -681,6 +762,9 @@ void Controller<ALDRAM>::update_temp(ALDRAM::Temp current_temperature);
 template <>
 void Controller<TLDRAM>::tick();
 
+template <>
+long Controller<TLDRAM>::get_next_event_cycle();
+
 template <>
 void Controller<TLDRAM>::cmd_issue_autoprecharge(typename TLDRAM::Command& cmd,
                                                     const vector<int>& addr_vec);
@@ -28,6 +28,7 @@
 #include "Controller.h"
 #include "SpeedyController.h"
 #include "Statistics.h"
+#include "TickPool.h"
 #include "GDDR5.h"
 #include "HBM.h"
 #include "DDR3.h"
@@ -54,6 +55,8 @@ public:
     virtual ~MemoryBase() {}
     virtual double clk_ns() const = 0;
     virtual void tick() = 0;
+    virtual long get_next_event_cycle() = 0;
+    virtual void fast_forward(long cycles) = 0;
     virtual bool send(Request req) = 0;
     virtual int pending_requests() = 0;
     virtual void finish(void) = 0;
@@ -87,6 +90,7 @@ class Memory : public MemoryBase
 protected:
   ScalarStat dram_capacity;
   ScalarStat num_dram_cycles;
+  ScalarStat num_skipped_dram_cycles;
   ScalarStat num_incoming_requests;
   VectorStat num_read_requests;
   VectorStat num_write_requests;
@@ -137,6 +141,10 @@ public:
     T * spec;
     vector<int> addr_bits;
 
+    // ticks the channel controllers concurrently when tick_threads > 1
+    TickPool* tick_pool = nullptr;
+    function<void(int)> tick_ctrl;
+
     int tx_bits;
 
     Memory(const Config& configs, vector<Controller<T>*> ctrls)
@@ -181,6 +189,16 @@ public:
 
         use_rest_of_addr_as_row_addr = configs.use_rest_of_addr_as_row_addr();
 
+        // spinning workers only pay off with a host core each
+        int tick_threads = min(configs.get_int("tick_threads"), int(ctrls.size()));
+        tick_threads = min(tick_threads, int(thread::hardware_concurrency()));
+        if (tick_threads > 1) {
+          tick_pool = new TickPool(tick_threads);
+          tick_ctrl = [this](int c) { this->ctrls[c]->tick(); };
+          for (auto ctrl : ctrls)
+            ctrl->defer_callbacks = true;
+        }
+
         dram_capacity
             .name("dram_capacity")
             .desc("Number of bytes in simulated DRAM")
@@ -193,6 +211,11 @@ public:
             .desc("Number of DRAM cycles simulated")
             .precision(0)
             ;
+        num_skipped_dram_cycles
+            .name("skipped_dram_cycles")
+            .desc("Number of idle DRAM cycles fast-forwarded without ticking the controllers")
+            .precision(0)
+            ;
         num_incoming_requests
             .name("incoming_requests")
             .desc("Number of incoming requests to DRAM")
@@ -284,6 +307,7 @@ public:
 
     ~Memory()
     {
+        delete tick_pool;
         for (auto ctrl: ctrls)
             delete ctrl;
         delete spec;
@@ -328,22 +352,64 @@ public:
         int cur_que_req_num = 0;
         int cur_que_readreq_num = 0;
         int cur_que_writereq_num = 0;
+        bool is_active = false;
         for (auto ctrl : ctrls) {
           cur_que_req_num += ctrl->readq.size() + ctrl->writeq.size() + ctrl->pending.size();
           cur_que_readreq_num += ctrl->readq.size() + ctrl->pending.size();
           cur_que_writereq_num += ctrl->writeq.size();
+          is_active = is_active || ctrl->is_active();
         }
         in_queue_req_num_sum += cur_que_req_num;
         in_queue_read_req_num_sum += cur_que_readreq_num;
         in_queue_write_req_num_sum += cur_que_writereq_num;
 
+        if (tick_pool) {
+          // Channels only interact through the response and stats callbacks
+          // and the printed command trace, which are buffered per channel
+          // during the parallel tick and then delivered in channel order,
+          // exactly as the serial loop would.
+          tick_pool->run(ctrls.size(), tick_ctrl);
+          for (auto ctrl : ctrls)
+            ctrl->flush_callbacks();
+        } else {
+          for (auto ctrl : ctrls)
+            ctrl->tick();
+        }
+        if (is_active) {
+          ramulator_active_cycles++;
+        }
+    }
+
+    // Earliest DRAM cycle (in controller clocks) at which any channel has work
+    // to do: a queued request, a completing read, or a due refresh
+    long get_next_event_cycle()
+    {
+        long next = LONG_MAX;
+        for (auto ctrl : ctrls)
+          next = min(next, ctrl->get_next_event_cycle());
+        return next;
+    }
+
+    // Equivalent to calling tick() 'cycles' times before the next event
+    void fast_forward(long cycles)
+    {
+        num_dram_cycles += cycles;
+        num_skipped_dram_cycles += cycles;
+        int cur_que_readreq_num = 0;
+        int cur_que_writereq_num = 0;
         bool is_active = false;
         for (auto ctrl : ctrls) {
+          // only completing reads and held-back writes can be queued while idle
+          cur_que_readreq_num += ctrl->pending.size();
+          cur_que_writereq_num += ctrl->writeq.size();
           is_active = is_active || ctrl->is_active();
-          ctrl->tick();
+          ctrl->fast_forward(cycles);
         }
+        in_queue_req_num_sum += cycles * (cur_que_readreq_num + cur_que_writereq_num);
+        in_queue_read_req_num_sum += cycles * cur_que_readreq_num;
+        in_queue_write_req_num_sum += cycles * cur_que_writereq_num;
         if (is_active) {
-          ramulator_active_cycles++;
+          ramulator_active_cycles += cycles;
         }
     }
 
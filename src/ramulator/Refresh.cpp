@@ -271,6 +271,12 @@ void Refresh<DSARP>::tick_ref() {
   if ((clk - refreshed) >= refresh_interval)
     inject_refresh(b_ref_rank);
 }
+
+// DSARP may pull refreshes in early, so it has to be ticked every cycle
+template<>
+long Refresh<DSARP>::get_next_refresh_cycle() {
+  return clk + 1;
+}
 /**** End DSARP specialization ****/
 
 } /* namespace ramulator */
@@ -104,6 +104,18 @@ public:
     }
   }
 
+  // Earliest refresh clock at which tick_ref() will inject a refresh. Used by
+  // the controller to fast-forward over idle cycles.
+  long get_next_refresh_cycle() {
+    return refreshed + ctrl->channel->spec->speed_entry.nREFI;
+  }
+
+  // Advance the refresh clock over cycles in which tick_ref() would not have
+  // injected anything
+  void fast_forward(long cycles) {
+    clk += cycles;
+  }
+
 private:
   // Keeping track of refresh status of every bank: + means ahead of schedule, - means behind schedule
   vector<vector<int>*> bank_refresh_backlog;
@@ -153,6 +165,7 @@ private:
 // where to look for these definitions when controller calls them!
 template<> Refresh<DSARP>::Refresh(Controller<DSARP>* ctrl);
 template<> void Refresh<DSARP>::tick_ref();
+template<> long Refresh<DSARP>::get_next_refresh_cycle();
 
 } /* namespace ramulator */
 
@@ -70,15 +70,40 @@ ScarabWrapper::~ScarabWrapper() {
   delete mem;
 }
 
-void ScarabWrapper::tick() {
+// Idle DRAM cycles are not ticked one by one. They are accumulated and applied
+// in bulk (mem->fast_forward) right before the next cycle in which something
+// can happen, or before a new request enters the controllers. Returns whether
+// the controllers were actually ticked.
+bool ScarabWrapper::tick() {
+  clk++;
+  if(clk < next_event)
+    return false;
+
+  catch_up(clk - 1);
   mem->tick();
+  mem_clk    = clk;
+  next_event = mem->get_next_event_cycle();
+  return true;
+}
+
+void ScarabWrapper::catch_up(long target) {
+  if(mem_clk < target) {
+    mem->fast_forward(target - mem_clk);
+    mem_clk = target;
+  }
 }
 
 bool ScarabWrapper::send(Request req) {
-  return mem->send(req);
+  // the controllers need an up-to-date clock for the request arrival time
+  catch_up(clk);
+  bool is_sent = mem->send(req);
+  if(is_sent)
+    next_event = min(next_event, mem_clk + 1);
+  return is_sent;
 }
 
 void ScarabWrapper::finish(void) {
+  catch_up(clk);
   mem->finish();
   Stats::statlist.printall();
 }
@@ -98,3 +123,7 @@ int ScarabWrapper::get_num_chips() const {
 int ScarabWrapper::get_chip_row_buffer_size() const {
   return mem->get_chip_row_buffer_size();
 }
+
+long ScarabWrapper::get_next_event_cycle() const {
+  return next_event;
+}
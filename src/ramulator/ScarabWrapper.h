@@ -38,13 +38,18 @@ class ScarabWrapper
 {
 private:
     MemoryBase *mem;
+    long clk = 0;         // DRAM cycles requested through tick()
+    long mem_clk = 0;     // DRAM cycles actually applied to mem
+    long next_event = 0;  // earliest DRAM cycle at which mem has work to do
+    void catch_up(long target);
 public:
     //double tCK;
     ScarabWrapper(const Config& configs, const unsigned int cacheline, void (* stats_callback)(int, int));
     ~ScarabWrapper();
-    void tick();
+    bool tick();
     bool send(Request req);
     void finish(void);
+    long get_next_event_cycle() const;
 
     int get_chip_width() const;
     int get_chip_size()  const;
@@ -0,0 +1,94 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cassert>
+
+#include "TickPool.h"
+
+using namespace ramulator;
+
+// Spins on the generation counter before yielding the host CPU to other
+// threads. Long idle stretches between batches (e.g., no DRAM traffic) then do
+// not keep the workers busy.
+static const int SPINS_BEFORE_YIELD = 1024;
+
+TickPool::TickPool(int num_threads)
+    : num_threads(num_threads), generation(0), num_done(0), stop(false)
+{
+    assert(num_threads >= 1);
+    for (int id = 1; id < num_threads; id++)
+        workers.emplace_back(&TickPool::worker_loop, this, id);
+}
+
+TickPool::~TickPool()
+{
+    stop.store(true, memory_order_release);
+    generation.fetch_add(1, memory_order_acq_rel);
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void TickPool::run(int num_tasks, const function<void(int)>& task)
+{
+    cur_task = &task;
+    cur_num_tasks = num_tasks;
+    num_done.store(0, memory_order_relaxed);
+    generation.fetch_add(1, memory_order_acq_rel);
+
+    run_share(0);
+
+    int spins = 0;
+    while (num_done.load(memory_order_acquire) != num_threads - 1) {
+        if (++spins == SPINS_BEFORE_YIELD) {
+            spins = 0;
+            this_thread::yield();
+        }
+    }
+    cur_task = nullptr;
+}
+
+void TickPool::run_share(int id)
+{
+    for (int i = id; i < cur_num_tasks; i += num_threads)
+        (*cur_task)(i);
+}
+
+void TickPool::worker_loop(int id)
+{
+    long seen = 0;
+    while (true) {
+        int spins = 0;
+        long cur;
+        while ((cur = generation.load(memory_order_acquire)) == seen) {
+            if (++spins == SPINS_BEFORE_YIELD) {
+                spins = 0;
+                this_thread::yield();
+            }
+        }
+        seen = cur;
+        if (stop.load(memory_order_acquire))
+            return;
+
+        run_share(id);
+        num_done.fetch_add(1, memory_order_acq_rel);
+    }
+}
@@ -0,0 +1,74 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __TICK_POOL_H
+#define __TICK_POOL_H
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace ramulator
+{
+
+/*
+ * A small fixed-size pool of threads that runs one batch of independent tasks
+ * per call to run(). It is meant for very short batches issued every memory
+ * cycle (one task per channel controller), so workers spin on a generation
+ * counter instead of sleeping on a condition variable. The calling thread
+ * takes part in every batch.
+ *
+ * Task i is always executed by thread (i % num_threads), which keeps each
+ * channel's state in the same host cache across cycles.
+ */
+class TickPool
+{
+public:
+    TickPool(int num_threads);
+    ~TickPool();
+
+    // Run task(0) ... task(num_tasks - 1) and return once all have finished
+    void run(int num_tasks, const function<void(int)>& task);
+
+    int get_num_threads() const { return num_threads; }
+
+private:
+    int num_threads;
+    vector<thread> workers;
+
+    const function<void(int)>* cur_task = nullptr;
+    int cur_num_tasks = 0;
+
+    atomic<long> generation;
+    atomic<int> num_done;
+    atomic<bool> stop;
+
+    void worker_loop(int id);
+    void run_share(int id);
+};
+
+} /*namespace ramulator*/
+
+#endif /*__TICK_POOL_H*/
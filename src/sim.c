@@ -51,6 +51,7 @@
 #include "debug/pipeview.h"
 #include "dumb_model.h"
 #include "frontend/pin_trace_fe.h"
+#include "interval_model.h"
 #include "model.h"
 #include "optimizer2.h"
 #include "power/power_intf.h"
@@ -694,13 +695,15 @@ void full_sim() {
         any_sim_done      = TRUE;
         check_heartbeat(proc_id, TRUE);
 
-        if(retired_exit[proc_id] && FRONTEND == FE_TRACE) {
+        if(retired_exit[proc_id] && FRONTEND == FE_TRACE &&
+           SIM_MODEL == CMP_MODEL) {
           set_last_sim_param(proc_id);
           // rerun the corresponding benchmark again.
           // (reset retired_exit and reached_exit)
           cmp_init_bogus_sim(proc_id);
         }
-      } else if(sim_done[proc_id] && retired_exit[proc_id]) {
+      } else if(sim_done[proc_id] && retired_exit[proc_id] &&
+                SIM_MODEL == CMP_MODEL) {
         ASSERTM(
           proc_id, FRONTEND == FE_TRACE,
           "Unhandled case: benchmark finished in execution-driven mode\n");
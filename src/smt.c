@@ -0,0 +1,267 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : smt.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Simultaneous multithreading. SMT_THREADS consecutive proc_ids
+ *                are the hardware threads of one physical core; they share the
+ *                fetch stage, the reservation stations, the functional units
+ *                and the reorder buffer.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "cmp_model.h"
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "general.param.h"
+#include "smt.h"
+#include "statistics.h"
+
+/*
+   Every hardware thread keeps the per-proc_id state the simulator already
+   has: its own fetch PC, branch predictor history, register map, node table
+   and statistics. What makes the threads of a core simultaneous is the
+   sharing below:
+
+   - fetch: one thread per core fetches each cycle, chosen round-robin or by
+     ICOUNT (Tullsen et al., ISCA 1996), the thread with the fewest ops in
+     decode, map and the reservation stations.
+   - reservation stations: the sibling threads use the reservation stations
+     of the first thread, so RS capacity is shared (see init_exec_ports).
+   - functional units: each thread keeps its own Func_Unit state, and a unit
+     claimed by one thread is busy for the others until its avail cycle.
+   - reorder buffer: NODE_TABLE_SIZE entries per core, either statically
+     partitioned (SMT_ROB_PARTITION) or shared by all threads.
+
+   The caches and TLBs stay private to each proc_id.
+*/
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_SMT, ##args)
+
+#define SMT_NO_THREAD ((uns)-1)
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Smt_Core_struct {
+  uns      fetch_thread; /* thread allowed to fetch this cycle */
+  uns      next_thread;  /* round-robin priority pointer */
+  Counter* fu_avail;     /* cycle each shared functional unit frees up */
+  uns*     fu_holder;    /* thread that last claimed each functional unit */
+} Smt_Core;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Smt_Core* smt_cores    = NULL;
+static uns       smt_rotation = 0;
+
+DEFINE_ENUM(Smt_Fetch_Policy, SMT_FETCH_POLICY_LIST);
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static Flag smt_can_fetch(uns proc_id);
+static uns  smt_icount(uns proc_id);
+
+/**************************************************************************************/
+/* init_smt: */
+
+void init_smt(void) {
+  if(SMT_THREADS <= 1)
+    return;
+
+  ASSERTM(0, NUM_CORES % SMT_THREADS == 0,
+          "NUM_CORES (%d) must be a multiple of SMT_THREADS (%d)\n", NUM_CORES,
+          SMT_THREADS);
+  ASSERTM(0, !SMT_ROB_PARTITION || NODE_TABLE_SIZE >= SMT_THREADS,
+          "NODE_TABLE_SIZE is too small to partition among the threads\n");
+
+  uns num_cores = NUM_CORES / SMT_THREADS;
+  smt_cores     = (Smt_Core*)calloc(num_cores, sizeof(Smt_Core));
+  for(uns ii = 0; ii < num_cores; ii++) {
+    Smt_Core* core     = &smt_cores[ii];
+    core->fetch_thread = SMT_NO_THREAD;
+    core->next_thread  = 0;
+    core->fu_avail     = (Counter*)calloc(NUM_FUS, sizeof(Counter));
+    core->fu_holder    = (uns*)calloc(NUM_FUS, sizeof(uns));
+  }
+}
+
+/**************************************************************************************/
+/* smt_can_fetch: the thread would fetch this cycle if it owned the fetch
+   stage. The packet it fetches can move into decode unless the first decode
+   stage is still occupied. */
+
+static Flag smt_can_fetch(uns proc_id) {
+  Icache_Stage* ic_stage  = &cmp_model.icache_stage[proc_id];
+  Decode_Stage* dec_stage = &cmp_model.decode_stage[proc_id];
+
+  if(ic_stage->next_state != IC_FETCH)
+    return FALSE;
+  if(!FETCH_OFF_PATH_OPS && ic_stage->off_path && !ic_stage->back_on_path)
+    return FALSE;
+  return ic_stage->sd.op_count == 0 ||
+         dec_stage->sds[DECODE_CYCLES - 1].op_count == 0;
+}
+
+/**************************************************************************************/
+/* smt_icount: ops of the thread in the frontend and the reservation
+   stations */
+
+static uns smt_icount(uns proc_id) {
+  Decode_Stage* dec_stage = &cmp_model.decode_stage[proc_id];
+  Map_Stage*    map_stage = &cmp_model.map_stage[proc_id];
+  uns           count     = cmp_model.node_stage[proc_id].rs_count;
+
+  for(uns ii = 0; ii < DECODE_CYCLES; ii++)
+    count += dec_stage->sds[ii].op_count;
+  for(uns ii = 0; ii < MAP_CYCLES; ii++)
+    count += map_stage->sds[ii].op_count;
+  return count;
+}
+
+/**************************************************************************************/
+/* update_smt: */
+
+void update_smt(void) {
+  if(SMT_THREADS <= 1)
+    return;
+
+  smt_rotation = (smt_rotation + 1) % SMT_THREADS;
+
+  for(uns ii = 0; ii < NUM_CORES / SMT_THREADS; ii++) {
+    Smt_Core* core       = &smt_cores[ii];
+    uns       leader     = ii * SMT_THREADS;
+    uns       best       = SMT_NO_THREAD;
+    uns       best_count = 0;
+
+    /* scan starting at the round-robin pointer so that ICOUNT ties are
+       broken round-robin as well */
+    for(uns jj = 0; jj < SMT_THREADS; jj++) {
+      uns thread  = (core->next_thread + jj) % SMT_THREADS;
+      uns proc_id = leader + thread;
+      if(!smt_can_fetch(proc_id))
+        continue;
+      if(SMT_FETCH_POLICY == SMT_FETCH_ROUND_ROBIN) {
+        best = thread;
+        break;
+      }
+      uns count = smt_icount(proc_id);
+      if(best == SMT_NO_THREAD || count < best_count) {
+        best       = thread;
+        best_count = count;
+      }
+    }
+
+    core->fetch_thread = best;
+    if(best != SMT_NO_THREAD) {
+      core->next_thread = (best + 1) % SMT_THREADS;
+      STAT_EVENT(leader + best, SMT_FETCH_SELECTED);
+      DEBUG(leader + best, "Thread %d fetches (icount %d)\n", best,
+            best_count);
+    }
+  }
+}
+
+/**************************************************************************************/
+/* smt_thread_order: */
+
+uns smt_thread_order(uns idx) {
+  if(SMT_THREADS <= 1)
+    return idx;
+  uns leader = idx - idx % SMT_THREADS;
+  return leader + (idx + smt_rotation) % SMT_THREADS;
+}
+
+/**************************************************************************************/
+/* smt_core_leader: */
+
+uns smt_core_leader(uns proc_id) {
+  return proc_id - proc_id % SMT_THREADS;
+}
+
+/**************************************************************************************/
+/* smt_fetch_blocked: */
+
+Flag smt_fetch_blocked(uns proc_id) {
+  Smt_Core* core = &smt_cores[proc_id / SMT_THREADS];
+  return core->fetch_thread != proc_id % SMT_THREADS;
+}
+
+/**************************************************************************************/
+/* smt_fu_busy: */
+
+Flag smt_fu_busy(uns proc_id, uns fu_id) {
+  Smt_Core* core = &smt_cores[proc_id / SMT_THREADS];
+  ASSERT(proc_id, fu_id < NUM_FUS);
+  return core->fu_holder[fu_id] != proc_id &&
+         cycle_count < core->fu_avail[fu_id];
+}
+
+/**************************************************************************************/
+/* smt_fu_claim: */
+
+void smt_fu_claim(uns proc_id, uns fu_id, Counter avail_cycle) {
+  Smt_Core* core = &smt_cores[proc_id / SMT_THREADS];
+  /* a memory op stalled in the unit since last cycle may find that a sibling
+     updated earlier this cycle took the unit; the sibling keeps it */
+  if(smt_fu_busy(proc_id, fu_id))
+    return;
+  core->fu_holder[fu_id] = proc_id;
+  core->fu_avail[fu_id]  = avail_cycle;
+}
+
+/**************************************************************************************/
+/* smt_fu_release: */
+
+void smt_fu_release(uns proc_id, uns fu_id) {
+  Smt_Core* core = &smt_cores[proc_id / SMT_THREADS];
+  if(core->fu_holder[fu_id] == proc_id)
+    core->fu_avail[fu_id] = MIN2(core->fu_avail[fu_id], cycle_count + 1);
+}
+
+/**************************************************************************************/
+/* smt_node_table_full: */
+
+Flag smt_node_table_full(uns proc_id) {
+  if(SMT_ROB_PARTITION)
+    return cmp_model.node_stage[proc_id].node_count >=
+           NODE_TABLE_SIZE / SMT_THREADS;
+
+  uns leader = smt_core_leader(proc_id);
+  uns total  = 0;
+  for(uns ii = leader; ii < leader + SMT_THREADS; ii++)
+    total += cmp_model.node_stage[ii].node_count;
+  return total >= NODE_TABLE_SIZE;
+}
@@ -0,0 +1,81 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : smt.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Simultaneous multithreading. SMT_THREADS consecutive proc_ids
+ *                are the hardware threads of one physical core; they share the
+ *                fetch stage, the reservation stations, the functional units
+ *                and the reorder buffer.
+ ***************************************************************************************/
+
+#ifndef __SMT_H__
+#define __SMT_H__
+
+#include "globals/enum.h"
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+#define SMT_FETCH_POLICY_LIST(elem) elem(ROUND_ROBIN) elem(ICOUNT)
+
+DECLARE_ENUM(Smt_Fetch_Policy, SMT_FETCH_POLICY_LIST, SMT_FETCH_);
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Initialize the per-core SMT state */
+void init_smt(void);
+
+/* Pick the thread of every core that may fetch this cycle. Call once per
+   cycle before the cores are updated. */
+void update_smt(void);
+
+/* Returns the proc_id that should be updated in the idx-th slot of the
+   cycle. Threads of a core are rotated every cycle so that no thread always
+   gets the first pick of the shared functional units. */
+uns smt_thread_order(uns idx);
+
+/* Returns the first hardware thread of the core that runs proc_id */
+uns smt_core_leader(uns proc_id);
+
+/* Returns TRUE if a sibling thread owns the fetch stage this cycle */
+Flag smt_fetch_blocked(uns proc_id);
+
+/* Returns TRUE if a sibling thread holds functional unit fu_id */
+Flag smt_fu_busy(uns proc_id, uns fu_id);
+
+/* Mark functional unit fu_id busy for the siblings of proc_id until
+   avail_cycle, unless a sibling already holds it */
+void smt_fu_claim(uns proc_id, uns fu_id, Counter avail_cycle);
+
+/* Give functional unit fu_id back after its op was flushed */
+void smt_fu_release(uns proc_id, uns fu_id);
+
+/* Returns TRUE if proc_id cannot issue into the shared reorder buffer */
+Flag smt_node_table_full(uns proc_id);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __SMT_H__ */
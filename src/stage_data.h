@@ -43,6 +43,8 @@ typedef enum Rob_Block_Issue_Reason_enum {
   ROB_BLOCK_ISSUE_NONE          = 0,
   ROB_BLOCK_ISSUE_FULL          = 7,
   ROB_BLOCK_ISSUE_GAP_TOO_LARGE = 8,
+  ROB_BLOCK_ISSUE_LQ_FULL       = 10,
+  ROB_BLOCK_ISSUE_SQ_FULL       = 11,
 } Rob_Block_Issue_Reason;
 
 typedef enum Rob_Stall_Reason_enum {
@@ -0,0 +1,252 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : store_sets.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Store-set memory dependence predictor. Loads wait only for the
+ *                stores their store set predicts; loads that run ahead of a
+ *                conflicting store are charged a violation penalty.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "map.h"
+#include "statistics.h"
+#include "store_sets.h"
+
+/*
+   Store sets (Chrysos and Emer, ISCA 1998). The store set id table (SSIT),
+   indexed by instruction address, maps loads and stores that have conflicted
+   in the past to a common store set id (SSID). The last fetched store table
+   (LFST) remembers, per SSID, the most recently fetched store of the set.
+
+   Scarab computes memory dependences with the oracle (map_mem_dep), so loads
+   always wait for the stores they really read from. The predictor is layered
+   on top of that: a load additionally waits for the store its store set
+   predicts (a false dependence if the load does not read from it), and when
+   an unpredicted oracle dependence is the last source a load waits for, the
+   load would have executed ahead of the store. The frontend cannot re-fetch
+   on-path ops, so such a violation is charged as MEM_DEP_VIOLATION_CYCLES on
+   top of the store's wake up instead of a pipeline flush, and the predictor
+   is trained by putting the load and the store into the same store set.
+*/
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_STORE_SETS, ##args)
+
+#define SSID_INVALID ((uns)-1)
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Lfst_Entry_struct {
+  Op*     op;
+  Counter unique_num; /* detects that op was freed and reused */
+} Lfst_Entry;
+
+typedef struct Store_Sets_struct {
+  uns*        ssit;
+  Lfst_Entry* lfst;
+  uns         next_ssid;
+  Counter     next_clear_cycle;
+} Store_Sets;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Store_Sets* store_sets = NULL;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static uns  ssit_index(Addr pc);
+static void store_sets_clear(uns proc_id, Store_Sets* ss);
+static Op*  lfst_store(Store_Sets* ss, uns ssid);
+static Flag has_src_op(Op* op, Op* src_op);
+
+/**************************************************************************************/
+/* init_store_sets: */
+
+void init_store_sets(void) {
+  if(!STORE_SETS_ON)
+    return;
+
+  ASSERTM(0, (STORE_SETS_SSIT_ENTRIES & (STORE_SETS_SSIT_ENTRIES - 1)) == 0,
+          "STORE_SETS_SSIT_ENTRIES must be a power of two\n");
+  ASSERT(0, STORE_SETS_LFST_ENTRIES > 0);
+
+  store_sets = (Store_Sets*)calloc(NUM_CORES, sizeof(Store_Sets));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Store_Sets* ss = &store_sets[proc_id];
+    ss->ssit = (uns*)malloc(STORE_SETS_SSIT_ENTRIES * sizeof(uns));
+    ss->lfst = (Lfst_Entry*)calloc(STORE_SETS_LFST_ENTRIES,
+                                   sizeof(Lfst_Entry));
+    store_sets_clear(proc_id, ss);
+  }
+}
+
+/**************************************************************************************/
+/* ssit_index: */
+
+static uns ssit_index(Addr pc) {
+  return (pc ^ (pc >> LOG2(STORE_SETS_SSIT_ENTRIES))) &
+         N_BIT_MASK(LOG2(STORE_SETS_SSIT_ENTRIES));
+}
+
+/**************************************************************************************/
+/* store_sets_clear: the SSIT is cleared periodically so that stale store
+   sets do not keep loads waiting forever */
+
+static void store_sets_clear(uns proc_id, Store_Sets* ss) {
+  for(uns ii = 0; ii < STORE_SETS_SSIT_ENTRIES; ii++)
+    ss->ssit[ii] = SSID_INVALID;
+  memset(ss->lfst, 0, STORE_SETS_LFST_ENTRIES * sizeof(Lfst_Entry));
+  ss->next_ssid        = 0;
+  ss->next_clear_cycle = cycle_count + STORE_SETS_CLEAR_INTERVAL;
+  DEBUG(proc_id, "Cleared store sets\n");
+}
+
+/**************************************************************************************/
+/* lfst_store: the last fetched store of a set, if it has not resolved yet */
+
+static Op* lfst_store(Store_Sets* ss, uns ssid) {
+  Lfst_Entry* entry = &ss->lfst[ssid];
+  Op*         op    = entry->op;
+
+  if(!op || !op->op_pool_valid || op->unique_num != entry->unique_num ||
+     op->wake_up_signaled[MEM_DATA_DEP])
+    return NULL;
+  return op;
+}
+
+/**************************************************************************************/
+/* has_src_op: */
+
+static Flag has_src_op(Op* op, Op* src_op) {
+  for(uns ii = 0; ii < op->oracle_info.num_srcs; ii++) {
+    Src_Info* info = &op->oracle_info.src_info[ii];
+    if(info->type == MEM_DATA_DEP && info->unique_num == src_op->unique_num)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/**************************************************************************************/
+/* store_sets_map_store: */
+
+void store_sets_map_store(Op* op) {
+  Store_Sets* ss = &store_sets[op->proc_id];
+
+  if(cycle_count >= ss->next_clear_cycle) {
+    STAT_EVENT(op->proc_id, STORE_SETS_CLEAR);
+    store_sets_clear(op->proc_id, ss);
+  }
+
+  uns ssid = ss->ssit[ssit_index(op->inst_info->addr)];
+  if(ssid == SSID_INVALID)
+    return;
+
+  ss->lfst[ssid].op         = op;
+  ss->lfst[ssid].unique_num = op->unique_num;
+}
+
+/**************************************************************************************/
+/* store_sets_map_load: */
+
+void store_sets_map_load(Op* op) {
+  Store_Sets* ss   = &store_sets[op->proc_id];
+  uns         ssid = ss->ssit[ssit_index(op->inst_info->addr)];
+
+  if(ssid == SSID_INVALID)
+    return;
+
+  Op* store = lfst_store(ss, ssid);
+  if(!store || store->op_num >= op->op_num)
+    return;
+
+  if(!has_src_op(op, store)) {
+    /* the predicted store does not write what the load reads */
+    if(op->oracle_info.num_srcs >= MAX_DEPS)
+      return;
+    add_src_from_op(op, store, MEM_DATA_DEP);
+    STAT_EVENT(op->proc_id, STORE_SETS_FALSE_DEP);
+  }
+  op->mem_dep_pred_unique = store->unique_num;
+  STAT_EVENT(op->proc_id, STORE_SETS_PRED_DEP);
+  DEBUG(op->proc_id, "Load op_num:%s waits for store op_num:%s ssid:%u\n",
+        unsstr64(op->op_num), unsstr64(store->op_num), ssid);
+}
+
+/**************************************************************************************/
+/* store_sets_mem_dep_wake: */
+
+void store_sets_mem_dep_wake(Op* src_op, Op* dep_op) {
+  Store_Sets* ss = &store_sets[dep_op->proc_id];
+
+  /* the load was told to wait for this store */
+  if(dep_op->mem_dep_pred_unique == src_op->unique_num)
+    return;
+  /* the load is still waiting for another source, or that source already
+     made it wait past the store */
+  if(dep_op->srcs_not_rdy_vector || dep_op->rdy_cycle >= src_op->wake_cycle)
+    return;
+
+  DEBUG(dep_op->proc_id,
+        "Violation load op_num:%s store op_num:%s rdy:%s wake:%s\n",
+        unsstr64(dep_op->op_num), unsstr64(src_op->op_num),
+        unsstr64(dep_op->rdy_cycle), unsstr64(src_op->wake_cycle));
+  STAT_EVENT(dep_op->proc_id, MEM_DEP_VIOLATION);
+  dep_op->rdy_cycle = src_op->wake_cycle + MEM_DEP_VIOLATION_CYCLES;
+
+  if(dep_op->off_path)
+    return;
+  STAT_EVENT(dep_op->proc_id, MEM_DEP_VIOLATION_ONPATH);
+
+  /* train: put the load and the store into the same store set */
+  uns* ld_ssid = &ss->ssit[ssit_index(dep_op->inst_info->addr)];
+  uns* st_ssid = &ss->ssit[ssit_index(src_op->inst_info->addr)];
+  if(*ld_ssid == SSID_INVALID && *st_ssid == SSID_INVALID) {
+    *ld_ssid      = ss->next_ssid;
+    *st_ssid      = ss->next_ssid;
+    ss->next_ssid = (ss->next_ssid + 1) % STORE_SETS_LFST_ENTRIES;
+    STAT_EVENT(dep_op->proc_id, STORE_SETS_SSID_ALLOC);
+  } else if(*ld_ssid == SSID_INVALID) {
+    *ld_ssid = *st_ssid;
+  } else if(*st_ssid == SSID_INVALID) {
+    *st_ssid = *ld_ssid;
+  } else if(*ld_ssid != *st_ssid) {
+    /* both belong to sets already: the smaller id wins */
+    *ld_ssid = *st_ssid = MIN2(*ld_ssid, *st_ssid);
+    STAT_EVENT(dep_op->proc_id, STORE_SETS_SSID_MERGE);
+  }
+}
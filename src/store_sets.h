@@ -0,0 +1,57 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : store_sets.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Store-set memory dependence predictor. Loads wait only for the
+ *                stores their store set predicts; loads that run ahead of a
+ *                conflicting store are charged a violation penalty.
+ ***************************************************************************************/
+
+#ifndef __STORE_SETS_H__
+#define __STORE_SETS_H__
+
+#include "globals/global_types.h"
+#include "op.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Allocate the store set tables of every core */
+void init_store_sets(void);
+
+/* Record a mapped store as the last fetched store of its store set */
+void store_sets_map_store(Op* op);
+
+/* Make a mapped load wait for the last fetched store of its store set, if it
+   is still unresolved. Call after the oracle store dependences are added. */
+void store_sets_map_load(Op* op);
+
+/* Called when store src_op wakes up load dep_op through a memory data
+   dependence. Detects loads that would have executed before the store,
+   delays them by the violation penalty and trains the predictor. */
+void store_sets_mem_dep_wake(Op* src_op, Op* dep_op);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __STORE_SETS_H__ */
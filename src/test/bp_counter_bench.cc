@@ -0,0 +1,168 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bp_counter_bench.cc
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Throughput microbenchmark for the gshare/hybridgp pattern
+ *                tables: byte-per-counter vectors (the old layout) against
+ *                Packed_Counter_Table. Both run the same synthetic branch
+ *                stream and must agree on every prediction.
+ ***************************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../bp/template_lib/utils.h"
+
+#define CTR_BITS 2
+#define CTR_MAX ((1u << CTR_BITS) - 1)
+#define CTR_INIT (1u << (CTR_BITS - 1))
+
+namespace {
+
+struct Branch {
+  uint64_t addr;
+  uint32_t bias;  // taken probability out of 1024
+};
+
+/* Synthetic branch-heavy stream: a few thousand static branches spread over
+ * a large code footprint, each with its own bias. */
+std::vector<Branch> make_branches(unsigned num_branches) {
+  std::vector<Branch> branches(num_branches);
+  uint64_t            seed = 12345;
+  for(auto& branch : branches) {
+    seed        = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    branch.addr = 0x400000 + ((seed >> 20) & 0xfffffc);
+    branch.bias = (seed >> 50) & 0x3ff;
+  }
+  return branches;
+}
+
+uint32_t gshare_index(uint64_t addr, uint32_t hist, unsigned hist_length) {
+  return (hist >> (32 - hist_length)) ^
+         ((addr >> 2) & ((1u << hist_length) - 1));
+}
+
+/* The two implementations only differ in the counter storage. */
+struct Byte_Tables {
+  std::vector<uint8_t> sel, glob;
+
+  Byte_Tables(unsigned hist_length) :
+      sel(1u << hist_length, CTR_INIT), glob(1u << hist_length, CTR_INIT) {}
+
+  unsigned get(unsigned table, uint32_t index) const {
+    return table ? glob[index] : sel[index];
+  }
+
+  void update(unsigned table, uint32_t index, bool taken) {
+    uint8_t& ctr = table ? glob[index] : sel[index];
+    ctr          = taken ? (ctr == CTR_MAX ? CTR_MAX : ctr + 1) :
+                  (ctr == 0 ? 0 : ctr - 1);
+  }
+};
+
+struct Packed_Tables {
+  Packed_Counter_Table table;
+
+  Packed_Tables(unsigned hist_length) {
+    table.init(1u << hist_length, 2, CTR_BITS, CTR_INIT);
+  }
+
+  unsigned get(unsigned way, uint32_t index) const {
+    return table.get(index, way);
+  }
+
+  void update(unsigned way, uint32_t index, bool taken) {
+    table.update(index, way, taken);
+  }
+};
+
+/* Runs num_preds branches through a gshare table (way 1) and, hybridgp
+ * style, a selector table read with the same index (way 0). Returns a
+ * checksum of the predictions. */
+template <typename Tables>
+uint64_t run(Tables& tables, const std::vector<Branch>& branches,
+             unsigned hist_length, uint64_t num_preds, double* seconds) {
+  uint64_t checksum = 0;
+  uint64_t seed     = 42;
+  uint32_t hist     = 0;
+  auto     start    = std::chrono::steady_clock::now();
+
+  for(uint64_t ii = 0; ii < num_preds; ii++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    const Branch&  branch = branches[(seed >> 33) & (branches.size() - 1)];
+    const bool     taken  = ((seed >> 20) & 0x3ff) < branch.bias;
+    const uint32_t index  = gshare_index(branch.addr, hist, hist_length);
+    const bool     gpred  = tables.get(1, index) >> (CTR_BITS - 1);
+    const bool     spred  = tables.get(0, index) >> (CTR_BITS - 1);
+
+    checksum = checksum * 31 + (gpred << 1 | spred);
+    tables.update(1, index, taken);
+    if(gpred != spred) {
+      tables.update(0, index, gpred == taken);
+    }
+    hist = (hist >> 1) | ((uint32_t)taken << 31);
+  }
+
+  *seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                           start)
+               .count();
+  return checksum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const unsigned hist_length  = argc > 1 ? atoi(argv[1]) : 20;
+  const unsigned num_branches = argc > 2 ? atoi(argv[2]) : 8192;
+  const uint64_t num_preds    = argc > 3 ? atoll(argv[3]) : 50000000ULL;
+
+  if(num_branches & (num_branches - 1)) {
+    printf("the number of branches must be a power of two\n");
+    return 1;
+  }
+  const auto branches = make_branches(num_branches);
+
+  Byte_Tables   byte_tables(hist_length);
+  Packed_Tables packed_tables(hist_length);
+  double        byte_seconds, packed_seconds;
+
+  const uint64_t byte_sum   = run(byte_tables, branches, hist_length,
+                                num_preds, &byte_seconds);
+  const uint64_t packed_sum = run(packed_tables, branches, hist_length,
+                                  num_preds, &packed_seconds);
+
+  printf("hist_length %u, %u branches, %llu predictions\n", hist_length,
+         num_branches, (unsigned long long)num_preds);
+  printf("byte counters:   %8.1f Mpred/s\n", num_preds / byte_seconds / 1e6);
+  printf("packed counters: %8.1f Mpred/s\n", num_preds / packed_seconds / 1e6);
+
+  if(byte_sum != packed_sum) {
+    printf("FAILED: predictions differ\n");
+    return 1;
+  }
+  printf("predictions match\n");
+  return 0;
+}
@@ -0,0 +1,200 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : sched_fu_test.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Randomized check of oldest_first_sched (node_stage.c) against
+ *                the connected-FU walk it replaced. Both schedule the same
+ *                ready ops onto random FU/RS configurations and must fill
+ *                every FU slot with the same op.
+ ***************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../globals/global_types.h"
+#include "../globals/param_enum_headers.h"
+
+#include "../bp/bp.h"
+#include "../bp/bp.param.h"
+#include "../core.param.h"
+#include "../debug/debug.param.h"
+#include "../exec_ports.h"
+#include "../memory/memory.param.h"
+#include "../node_stage.h"
+#include "../op.h"
+#include "../thread.h"
+
+#define MAX_TEST_FUS 24
+#define MAX_TEST_RS 4
+#define MAX_TEST_OPS 40
+
+/**************************************************************************************/
+/* Parameters and globals node_stage.c and exec_ports.c need to link */
+
+#define DEF_PARAM(name, variable, type, func, def, const) \
+  const type variable = def;
+#include "../bp/bp.param.def"
+#include "../core.param.def"
+#include "../debug/debug.param.def"
+#include "../memory/memory.param.def"
+#undef DEF_PARAM
+
+uns NUM_FUS;
+uns NUM_RS;
+
+void init_exec_ports_fu_eligible(uns, Func_Unit*);
+
+/**************************************************************************************/
+/* old_oldest_first_sched: the scheduler before FU eligibility masks. Walks the
+   FUs connected to the op's RS in fu_id order and takes the first empty slot
+   that can execute the op, otherwise the youngest slot holding an op younger
+   than this one. */
+
+static void old_oldest_first_sched(Op* op, Op** slots, int* op_count) {
+  Reservation_Station* rs                  = &node->rs[op->rs_id];
+  int32                youngest_slot_op_id = -1;
+
+  for(uns32 i = 0; i < rs->num_fus; ++i) {
+    Func_Unit* fu    = rs->connected_fus[i];
+    uns32      fu_id = fu->fu_id;
+
+    if(get_fu_type(op->table_info->op_type, op->table_info->is_simd) &
+       fu->type) {
+      Op* s_op = slots[fu_id];
+      if(!s_op) {
+        slots[fu_id] = op;
+        (*op_count)++;
+        return;
+      } else if(op->op_num < s_op->op_num) {
+        if(youngest_slot_op_id == -1 ||
+           s_op->op_num > slots[youngest_slot_op_id]->op_num)
+          youngest_slot_op_id = fu_id;
+      }
+    }
+  }
+
+  if(youngest_slot_op_id != -1)
+    slots[youngest_slot_op_id] = op;
+}
+
+/**************************************************************************************/
+/* random_config: random FU types and RS connections, set up the way
+   init_exec_ports does */
+
+static void random_config(Func_Unit* fus, Reservation_Station* rs) {
+  NUM_FUS = 1 + rand() % MAX_TEST_FUS;
+  NUM_RS  = 1 + rand() % MAX_TEST_RS;
+
+  for(uns ii = 0; ii < NUM_FUS; ii++) {
+    fus[ii].fu_id = ii;
+    fus[ii].type  = 0;
+    for(uns t = 0; t < FU_TYPE_WIDTH; t++) {
+      if(rand() % 3)
+        fus[ii].type |= 1ull << t;
+    }
+  }
+
+  for(uns ii = 0; ii < NUM_RS; ii++) {
+    uns64 mask = 0;
+    while(!mask)
+      mask = ((uns64)rand() << 31 | rand()) & N_BIT_MASK(NUM_FUS);
+    rs[ii].fu_mask = mask;
+    rs[ii].num_fus = 0;
+    for(uns fu_id = 0; fu_id < NUM_FUS; fu_id++) {
+      if(mask & (1ull << fu_id))
+        rs[ii].connected_fus[rs[ii].num_fus++] = &fus[fu_id];
+    }
+  }
+
+  free(node->fu_eligible);
+  init_exec_ports_fu_eligible(0, fus);
+}
+
+/**************************************************************************************/
+/* run_cycle: schedule one cycle of ready ops with both schedulers */
+
+static Flag run_cycle(Op* ops, Table_Info* table_infos) {
+  Op* old_slots[MAX_TEST_FUS] = {NULL};
+  int old_op_count            = 0;
+  uns num_ops                 = rand() % MAX_TEST_OPS;
+
+  memset(node->sd.ops, 0, MAX_TEST_FUS * sizeof(Op*));
+  node->sd.op_count     = 0;
+  node->sd.max_op_count = NUM_FUS;
+  node->sched_fu_mask   = 0;
+
+  for(uns ii = 0; ii < num_ops; ii++) {
+    Op* op                      = &ops[ii];
+    op->op_num                  = rand() % 1000;
+    op->rs_id                   = rand() % NUM_RS;
+    op->table_info              = &table_infos[ii];
+    op->table_info->op_type     = rand() % NUM_OP_TYPES;
+    op->table_info->is_simd     = rand() % 2;
+    old_oldest_first_sched(op, old_slots, &old_op_count);
+    oldest_first_sched(op);
+  }
+
+  if(old_op_count != node->sd.op_count)
+    return FALSE;
+  for(uns fu_id = 0; fu_id < NUM_FUS; fu_id++) {
+    if(old_slots[fu_id] != node->sd.ops[fu_id])
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* main: args: NUM_CONFIGS CYCLES_PER_CONFIG SEED */
+
+int main(int argc, char** argv) {
+  const uns num_configs = argc > 1 ? atoi(argv[1]) : 20000;
+  const uns num_cycles  = argc > 2 ? atoi(argv[2]) : 20;
+  const uns seed        = argc > 3 ? atoi(argv[3]) : 1;
+
+  static Func_Unit           fus[MAX_TEST_FUS];
+  static Func_Unit*          connected_fus[MAX_TEST_RS][MAX_TEST_FUS];
+  static Reservation_Station rs[MAX_TEST_RS];
+  static Op                  ops[MAX_TEST_OPS];
+  static Table_Info          table_infos[MAX_TEST_OPS];
+
+  srand(seed);
+  node         = (Node_Stage*)calloc(1, sizeof(Node_Stage));
+  node->rs     = rs;
+  node->sd.ops = (Op**)calloc(MAX_TEST_FUS, sizeof(Op*));
+  for(uns ii = 0; ii < MAX_TEST_RS; ii++)
+    rs[ii].connected_fus = connected_fus[ii];
+
+  for(uns config = 0; config < num_configs; config++) {
+    random_config(fus, rs);
+    for(uns cycle = 0; cycle < num_cycles; cycle++) {
+      if(!run_cycle(ops, table_infos)) {
+        printf("FAILED: schedules differ (config %u, cycle %u, seed %u)\n",
+               config, cycle, seed);
+        return 1;
+      }
+    }
+  }
+  printf("%u configs x %u cycles: schedules match\n", num_configs, num_cycles);
+  return 0;
+}
@@ -0,0 +1,78 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : sim_test_stubs.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Globals and debug helpers for the C checks that link single
+ *                simulator source files (build them with --gc-sections so only
+ *                the code under test needs its dependencies).
+ ***************************************************************************************/
+
+#include <stdio.h>
+#include "../debug/debug_print.h"
+#include "../freq.h"
+#include "../globals/assert.h"
+#include "../globals/global_types.h"
+#include "../globals/global_vars.h"
+#include "../globals/utils.h"
+
+/**************************************************************************************/
+/* Global Variables */
+
+FILE* mystdout;
+FILE* mystderr;
+FILE* mystatus;
+
+static Counter sim_test_op_count[MAX_NUM_PROCS];
+static Counter sim_test_inst_count[MAX_NUM_PROCS];
+
+Counter  cycle_count = 0;
+Counter* op_count    = sim_test_op_count;
+Counter* inst_count  = sim_test_inst_count;
+
+/**************************************************************************************/
+/* Debug helpers used by the ASSERT and DEBUG macros */
+
+extern inline void print_backtrace(void);
+
+__attribute__((constructor)) static void init_sim_test_streams(void) {
+  mystdout = stdout;
+  mystderr = stderr;
+  mystatus = stdout;
+}
+
+void breakpoint(const char file[], const int line) {}
+
+Counter freq_time(void) {
+  return 0;
+}
+
+char* unsstr64(uns64 value) {
+  static char buf[32];
+  snprintf(buf, sizeof(buf), "%llu", (unsigned long long)value);
+  return buf;
+}
+
+char* disasm_op(Op* op, Flag wide) {
+  return "";
+}
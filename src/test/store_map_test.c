@@ -0,0 +1,364 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : store_map_test.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Randomized check of the per-line store map in map.c against
+ *                the per-byte map it replaced. A random stream of loads and
+ *                stores is fetched and mapped, retired and recovered (on and
+ *                off path, with flushed stores freed before, after or well
+ *                after the recovery) through the real thread and map code.
+ *                Every load must get the same store sources, in the same
+ *                order, from both maps.
+ ***************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../globals/assert.h"
+#include "../globals/global_types.h"
+#include "../globals/param_enum_headers.h"
+#include "../globals/utils.h"
+
+#include "../core.param.h"
+#include "../debug/debug.param.h"
+#include "../map.h"
+#include "../memory/memory.param.h"
+#include "../op.h"
+#include "../store_sets.h"
+#include "../thread.h"
+
+#define TEST_BASE_ADDR 0x7fff0000
+#define TEST_ADDR_RANGE 192 /* stores and loads start in this range */
+#define TEST_MAX_ADDR (TEST_ADDR_RANGE + 64)
+#define TEST_POOL_SIZE 1024
+
+#define OLD_ENTRY_SIZE 8
+#define OLD_NUM_ENTRIES (TEST_MAX_ADDR / OLD_ENTRY_SIZE)
+
+/**************************************************************************************/
+/* Parameters and globals map.c and thread.c need to link */
+
+#define DEF_PARAM(name, variable, type, func, def, const) \
+  const type variable = def;
+#include "../core.param.def"
+#include "../debug/debug.param.def"
+#include "../memory/memory.param.def"
+#undef DEF_PARAM
+
+Thread_Data* td;
+Op           invalid_op;
+
+uns get_proc_id_from_cmp_addr(Addr addr) {
+  return 0;
+}
+
+/* STORE_SETS_ON is off */
+void store_sets_map_store(Op* op) {}
+void store_sets_map_load(Op* op) {}
+
+/**************************************************************************************/
+/* The per-byte map: one entry per 8 bytes, with an onpath and an offpath op
+   per byte */
+
+typedef struct Old_Map_Entry_struct {
+  Flag valid;
+  Op*  op[2 * OLD_ENTRY_SIZE];
+  uns  flag_mask;
+  uns  store_mask;
+} Old_Map_Entry;
+
+static Old_Map_Entry old_map[OLD_NUM_ENTRIES];
+
+static inline Old_Map_Entry* old_map_entry(Addr va) {
+  ASSERT(0, va >= TEST_BASE_ADDR && va < TEST_BASE_ADDR + TEST_MAX_ADDR);
+  return &old_map[(va - TEST_BASE_ADDR) / OLD_ENTRY_SIZE];
+}
+
+static inline uns old_map_index(Addr va, Flag off_path) {
+  return va % OLD_ENTRY_SIZE + (off_path ? OLD_ENTRY_SIZE : 0);
+}
+
+static void old_update_store_hash(Op* op) {
+  for(Addr va = op->oracle_info.va;
+      va < op->oracle_info.va + op->oracle_info.mem_size; va++) {
+    Old_Map_Entry* entry = old_map_entry(va);
+    uns            ind   = old_map_index(va, op->off_path);
+    if(!entry->valid) {
+      entry->valid      = TRUE;
+      entry->flag_mask  = 0;
+      entry->store_mask = 0;
+    }
+    DEFBIT(entry->flag_mask, va % OLD_ENTRY_SIZE, op->off_path);
+    SETBIT(entry->store_mask, ind);
+    entry->op[ind] = op;
+  }
+}
+
+static void old_delete_store_hash_entry(Op* op) {
+  Addr first = op->oracle_info.va;
+  Addr last  = op->oracle_info.va + op->oracle_info.mem_size - 1;
+
+  for(Addr entry_va = first & ~(Addr)(OLD_ENTRY_SIZE - 1); entry_va <= last;
+      entry_va += OLD_ENTRY_SIZE) {
+    Old_Map_Entry* entry = old_map_entry(entry_va);
+    if(!entry->valid)
+      continue;
+    for(Addr va = MAX2(entry_va, first);
+        va <= MIN2(entry_va + OLD_ENTRY_SIZE - 1, last); va++) {
+      uns ind = old_map_index(va, op->off_path);
+      if(TESTBIT(entry->store_mask, ind) && entry->op[ind] == op)
+        CLRBIT(entry->store_mask, ind);
+    }
+    if(!entry->store_mask)
+      entry->valid = FALSE;
+  }
+}
+
+/* old_add_store_deps: the distinct stores supplying the load's bytes, in the
+   order of the first byte each supplies */
+static uns old_add_store_deps(Op* op, Op** srcs) {
+  uns num_srcs = 0;
+  for(Addr va = op->oracle_info.va;
+      va < op->oracle_info.va + op->oracle_info.mem_size; va++) {
+    Old_Map_Entry* entry = old_map_entry(va);
+    uns            ind;
+    Op*            src_op;
+    uns            ii;
+    if(!entry->valid)
+      continue;
+    ind = old_map_index(va,
+                        TESTBIT(entry->flag_mask, va % OLD_ENTRY_SIZE) != 0);
+    if(!TESTBIT(entry->store_mask, ind))
+      continue;
+    src_op = entry->op[ind];
+    for(ii = 0; ii < num_srcs && srcs[ii] != src_op; ii++)
+      ;
+    if(ii == num_srcs)
+      srcs[num_srcs++] = src_op;
+  }
+  return num_srcs;
+}
+
+static void old_recover_map(void) {
+  for(uns ii = 0; ii < OLD_NUM_ENTRIES; ii++)
+    old_map[ii].flag_mask = 0;
+}
+
+/* old_rebuild_offpath_map: write back the offpath stores left in the
+   sequential op list, like rebuild_offpath_map */
+static void old_rebuild_offpath_map(void) {
+  Op** op_p = (Op**)list_start_head_traversal(&td->seq_op_list);
+  while(op_p && !(*op_p)->off_path)
+    op_p = (Op**)list_next_element(&td->seq_op_list);
+  for(; op_p; op_p = (Op**)list_next_element(&td->seq_op_list)) {
+    if((*op_p)->table_info->mem_type == MEM_ST)
+      old_update_store_hash(*op_p);
+  }
+}
+
+/**************************************************************************************/
+/* Test ops */
+
+static Op         ops[TEST_POOL_SIZE];
+static Table_Info table_infos[TEST_POOL_SIZE];
+static Op*        free_ops[TEST_POOL_SIZE];
+static uns        num_free_ops;
+static Op*        pending_free[TEST_POOL_SIZE];
+static uns        num_pending_free;
+static Counter    next_op_num;
+static Counter    next_unique_num;
+static Flag       off_path;
+
+static const uns store_sizes[] = {1, 2, 4, 8, 16, 32, 64};
+static const uns load_sizes[]  = {1, 2, 4, 8, 16, 32};
+
+/* fetch_op: fetch and map an op, like the icache stage does; FALSE if the
+   maps disagree on a load */
+static Flag fetch_op(void) {
+  Op*  op;
+  Flag is_store = rand() % 2;
+  Op*  old_srcs[MAX_DEPS];
+  uns  num_old_srcs;
+
+  ASSERTM(0, num_free_ops, "Test op pool is empty\n");
+  op = free_ops[--num_free_ops];
+  memset(op, 0, sizeof(Op));
+  op->table_info           = &table_infos[op - ops];
+  op->table_info->mem_type = is_store ? MEM_ST : MEM_LD;
+  op->oracle_info.va       = TEST_BASE_ADDR + rand() % TEST_ADDR_RANGE;
+  op->oracle_info.mem_size = is_store ?
+                               store_sizes[rand() % NUM_ELEMENTS(store_sizes)] :
+                               load_sizes[rand() % NUM_ELEMENTS(load_sizes)];
+  op->op_num               = next_op_num++;
+  op->unique_num           = next_unique_num++;
+  op->off_path             = off_path;
+  op->op_pool_valid        = TRUE;
+  add_to_seq_op_list(td, op);
+  thread_map_op(op);
+  thread_map_mem_dep(op);
+  if(is_store) {
+    old_update_store_hash(op);
+    return TRUE;
+  }
+
+  num_old_srcs = old_add_store_deps(op, old_srcs);
+  if(num_old_srcs != op->oracle_info.num_srcs)
+    return FALSE;
+  for(uns ii = 0; ii < num_old_srcs; ii++) {
+    if(op->oracle_info.src_info[ii].op != old_srcs[ii])
+      return FALSE;
+  }
+  return TRUE;
+}
+
+static void free_test_op(Op* op) {
+  if(op->table_info->mem_type == MEM_ST) {
+    delete_store_hash_entry(op);
+    old_delete_store_hash_entry(op);
+  }
+  op->op_pool_valid        = FALSE;
+  free_ops[num_free_ops++] = op;
+}
+
+/* recover: flush the ops younger than a random offpath op, or all of them
+   (back on path). Flushed stores are freed before or after the recovery, or
+   left for a later step. */
+static void recover(void) {
+  Op*     flushed[TEST_POOL_SIZE];
+  uns     num_flushed = 0, num_off_path = 0;
+  uns     mode        = rand() % 3;
+  Op**    op_p        = (Op**)list_get_head(&td->seq_op_list);
+  Counter op_num      = (*op_p)->op_num - 1; /* all ops flushed */
+
+  for(op_p = (Op**)list_start_head_traversal(&td->seq_op_list); op_p;
+      op_p = (Op**)list_next_element(&td->seq_op_list)) {
+    if(!(*op_p)->off_path)
+      op_num = (*op_p)->op_num;
+    else
+      num_off_path++;
+  }
+  if(num_off_path && rand() % 10 >= 4) {
+    uns pick = rand() % num_off_path;
+    for(op_p = (Op**)list_start_head_traversal(&td->seq_op_list); op_p;
+        op_p = (Op**)list_next_element(&td->seq_op_list)) {
+      if((*op_p)->off_path && !pick--)
+        break;
+    }
+    op_num = (*op_p)->op_num;
+  } else {
+    off_path = FALSE;
+  }
+
+  for(op_p = (Op**)list_start_head_traversal(&td->seq_op_list); op_p;
+      op_p = (Op**)list_next_element(&td->seq_op_list)) {
+    if((*op_p)->op_num > op_num)
+      flushed[num_flushed++] = *op_p;
+  }
+
+  if(mode == 0) {
+    for(uns ii = 0; ii < num_flushed; ii++)
+      free_test_op(flushed[ii]);
+  }
+  recover_seq_op_list(td, op_num);
+  recover_map(op_num);
+  old_recover_map();
+  old_rebuild_offpath_map();
+  if(mode == 1) {
+    for(uns ii = 0; ii < num_flushed; ii++)
+      free_test_op(flushed[ii]);
+  } else if(mode == 2) {
+    for(uns ii = 0; ii < num_flushed; ii++)
+      pending_free[num_pending_free++] = flushed[ii];
+  }
+  next_op_num = op_num + 1;
+}
+
+/* run: one random op stream; FALSE if the maps disagree */
+static Flag run(uns num_steps) {
+  Flag ok = TRUE;
+  Op** op_p;
+
+  off_path         = FALSE;
+  next_op_num      = 1;
+  num_pending_free = 0;
+  num_free_ops     = 0;
+  for(uns ii = 0; ii < TEST_POOL_SIZE; ii++)
+    free_ops[num_free_ops++] = &ops[TEST_POOL_SIZE - 1 - ii];
+
+  for(uns step = 0; ok && step < num_steps; step++) {
+    uns  action = rand() % 100;
+    Op** head_p = (Op**)list_get_head(&td->seq_op_list);
+    Op*  head   = head_p ? *head_p : NULL;
+
+    if(action < 40) {
+      ok = fetch_op();
+    } else if(action < 55 && head && !head->off_path) {
+      remove_from_seq_op_list(td, head);
+      free_test_op(head);
+    } else if(action < 65 && !off_path) {
+      off_path = TRUE;
+    } else if(action < 75 && num_pending_free) {
+      for(uns ii = 0; ii < num_pending_free; ii++)
+        free_test_op(pending_free[ii]);
+      num_pending_free = 0;
+    } else if(action < 90 && off_path && head) {
+      recover();
+    }
+  }
+
+  /* free everything: both maps must end up empty */
+  for(op_p = (Op**)list_start_head_traversal(&td->seq_op_list); op_p;
+      op_p = (Op**)list_next_element(&td->seq_op_list))
+    free_test_op(*op_p);
+  for(uns ii = 0; ii < num_pending_free; ii++)
+    free_test_op(pending_free[ii]);
+  clear_list(&td->seq_op_list);
+  ok = ok && map_data->oracle_mem_hash.count == 0;
+  for(uns ii = 0; ii < OLD_NUM_ENTRIES; ii++)
+    ok = ok && !old_map[ii].valid;
+  return ok;
+}
+
+/**************************************************************************************/
+/* main: args: NUM_RUNS STEPS_PER_RUN SEED */
+
+int main(int argc, char** argv) {
+  const uns num_runs  = argc > 1 ? atoi(argv[1]) : 20000;
+  const uns num_steps = argc > 2 ? atoi(argv[2]) : 500;
+  const uns seed      = argc > 3 ? atoi(argv[3]) : 1;
+
+  srand(seed);
+  td = (Thread_Data*)calloc(1, sizeof(Thread_Data));
+  init_thread(td, NULL, NULL);
+
+  for(uns run_num = 0; run_num < num_runs; run_num++) {
+    if(!run(num_steps)) {
+      printf("FAILED: store sources differ (run %u, seed %u)\n", run_num,
+             seed);
+      return 1;
+    }
+  }
+  printf("%u runs x %u steps: store sources match\n", num_runs, num_steps);
+  return 0;
+}
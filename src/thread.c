@@ -85,7 +85,7 @@ void recover_thread(Thread_Data* td, Addr new_pc, Counter op_num,
             "addr 0x%llx\n",
             new_pc, frontend_next_fetch_addr(td->proc_id));
   }
-  recover_map();
+  recover_map(op_num);
 }
 
 
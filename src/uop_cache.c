@@ -0,0 +1,254 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : uop_cache.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Decoded uop cache between the icache and decode. Fetch blocks
+ *                that hit are delivered without going through the decoders.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "libs/cache_lib.h"
+#include "memory/memory.param.h"
+#include "op.h"
+#include "statistics.h"
+#include "uop_cache.h"
+
+/*
+   The uop cache is indexed by fetch block address. A fetch block starts at the
+   address fetch was steered to and ends after a control flow instruction or
+   at the end of its icache line, so a block always decodes to the same uops.
+   A block takes up to UOP_CACHE_BLOCK_LINES ways of one set, each holding
+   UOP_CACHE_LINE_UOPS uops. Blocks are built as the legacy path decodes them
+   and inserted when they end; a block needing more ways is not cached.
+
+   Each way is a cache_lib entry with a one-byte "line". The key of way k of
+   a block keeps the set index bits of the block address in place and moves
+   the remaining address bits and k into the tag, so all ways of a block map
+   to the same set. A block hits only if all
+   its ways are present.
+*/
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_UOP_CACHE, ##args)
+
+/* sets are indexed by the 32-byte code window the block starts in */
+#define UOP_CACHE_WINDOW_BITS 5
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Uop_Cache_Data_struct {
+  uns num_uops;  /* uops in the block (kept in the block's first way) */
+  uns num_lines; /* ways the block occupies */
+} Uop_Cache_Data;
+
+typedef struct Uop_Cache_struct {
+  Cache cache;
+  uns   set_bits;
+
+  /* fetch block being delivered */
+  Flag blk_active;
+  Flag blk_hit; /* delivered by the uop cache rather than the decoders */
+  Addr blk_start;
+  Addr blk_line;      /* icache line the block starts in */
+  Addr blk_next_addr; /* fetch address that continues the block */
+  uns  blk_uops;
+
+  Flag cycle_hit; /* path the ops of the current fetch cycle came from */
+} Uop_Cache;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Uop_Cache* uop_caches = NULL;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static Addr uop_cache_key(Uop_Cache* uc, Addr block_addr, uns way);
+static Flag uop_cache_lookup(Uop_Cache* uc, Addr block_addr);
+static void uop_cache_insert(Uop_Cache* uc, uns8 proc_id);
+
+/**************************************************************************************/
+/* init_uop_cache: */
+
+void init_uop_cache(void) {
+  if(!UOP_CACHE_ENABLE)
+    return;
+
+  ASSERTM(0, is_power_of_2(UOP_CACHE_SETS),
+          "UOP_CACHE_SETS must be a power of two\n");
+  ASSERTM(0,
+          UOP_CACHE_BLOCK_LINES > 0 &&
+            UOP_CACHE_BLOCK_LINES <= UOP_CACHE_ASSOC,
+          "A fetch block must fit in one uop cache set\n");
+  ASSERTM(0, UOP_CACHE_LINE_UOPS > 0 && UOP_CACHE_LEGACY_WIDTH > 0,
+          "Uop cache lines and the legacy path need a non-zero width\n");
+
+  uop_caches = (Uop_Cache*)calloc(NUM_CORES, sizeof(Uop_Cache));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Uop_Cache* uc = &uop_caches[proc_id];
+    init_cache(&uc->cache, "UOP_CACHE", UOP_CACHE_SETS * UOP_CACHE_ASSOC,
+               UOP_CACHE_ASSOC, 1, sizeof(Uop_Cache_Data), REPL_TRUE_LRU);
+    uc->set_bits = LOG2(UOP_CACHE_SETS);
+  }
+}
+
+/**************************************************************************************/
+/* uop_cache_fetch: */
+
+Flag uop_cache_fetch(uns8 proc_id, Addr fetch_addr, Flag* switched) {
+  Uop_Cache* uc = &uop_caches[proc_id];
+
+  *switched = FALSE;
+  if(uc->blk_active && fetch_addr == uc->blk_next_addr)
+    return uc->blk_hit;
+
+  /* start a new block; one that was redirected away from is not cached */
+  Flag last_hit     = uc->blk_hit;
+  uc->blk_active    = TRUE;
+  uc->blk_start     = fetch_addr;
+  uc->blk_line      = ROUND_DOWN(fetch_addr, ICACHE_LINE_SIZE);
+  uc->blk_next_addr = fetch_addr;
+  uc->blk_uops      = 0;
+  uc->blk_hit       = uop_cache_lookup(uc, fetch_addr);
+
+  STAT_EVENT(proc_id, UOP_CACHE_HIT + !uc->blk_hit);
+  if(uc->blk_hit != last_hit) {
+    *switched = TRUE;
+    STAT_EVENT(proc_id, UOP_CACHE_SWITCH);
+  }
+  DEBUG(proc_id, "Fetch block at 0x%s %s the uop cache\n",
+        hexstr64s(fetch_addr), uc->blk_hit ? "hit" : "missed");
+  return uc->blk_hit;
+}
+
+/**************************************************************************************/
+/* uop_cache_fetch_width: */
+
+uns uop_cache_fetch_width(uns8 proc_id) {
+  return uop_caches[proc_id].blk_hit ?
+           ISSUE_WIDTH :
+           MIN2(UOP_CACHE_LEGACY_WIDTH, ISSUE_WIDTH);
+}
+
+/**************************************************************************************/
+/* uop_cache_fetch_op: */
+
+Flag uop_cache_fetch_op(uns8 proc_id, Op* op) {
+  Uop_Cache* uc = &uop_caches[proc_id];
+  ASSERT(proc_id, uc->blk_active);
+
+  op->uop_cache_hit = uc->blk_hit;
+  uc->cycle_hit     = uc->blk_hit;
+  uc->blk_uops++;
+  STAT_EVENT(proc_id, UOP_CACHE_UOPS + !uc->blk_hit);
+
+  if(!op->eom)
+    return FALSE;
+
+  uc->blk_next_addr = ADDR_PLUS_OFFSET(op->inst_info->addr,
+                                       op->inst_info->trace_info.inst_size);
+  if(op->table_info->cf_type ||
+     ROUND_DOWN(uc->blk_next_addr, ICACHE_LINE_SIZE) != uc->blk_line) {
+    if(!uc->blk_hit)
+      uop_cache_insert(uc, proc_id);
+    uc->blk_active = FALSE;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/**************************************************************************************/
+/* uop_cache_fetch_cycle: */
+
+void uop_cache_fetch_cycle(uns8 proc_id, uns op_count) {
+  if(op_count)
+    STAT_EVENT(proc_id, UOP_CACHE_CYCLE + !uop_caches[proc_id].cycle_hit);
+}
+
+/**************************************************************************************/
+/* uop_cache_key: */
+
+static Addr uop_cache_key(Uop_Cache* uc, Addr block_addr, uns way) {
+  Addr set  = (block_addr >> UOP_CACHE_WINDOW_BITS) & N_BIT_MASK(uc->set_bits);
+  Addr rest = (block_addr >> (UOP_CACHE_WINDOW_BITS + uc->set_bits))
+                << UOP_CACHE_WINDOW_BITS |
+              (block_addr & N_BIT_MASK(UOP_CACHE_WINDOW_BITS));
+  return (rest * UOP_CACHE_BLOCK_LINES + way) << uc->set_bits | set;
+}
+
+/**************************************************************************************/
+/* uop_cache_lookup: */
+
+static Flag uop_cache_lookup(Uop_Cache* uc, Addr block_addr) {
+  Addr            line_addr;
+  Uop_Cache_Data* data = (Uop_Cache_Data*)cache_access(
+    &uc->cache, uop_cache_key(uc, block_addr, 0), &line_addr, TRUE);
+  if(!data)
+    return FALSE;
+
+  for(uns ii = 1; ii < data->num_lines; ii++) {
+    if(!cache_access(&uc->cache, uop_cache_key(uc, block_addr, ii), &line_addr,
+                     TRUE))
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* uop_cache_insert: insert the block that just finished decoding */
+
+static void uop_cache_insert(Uop_Cache* uc, uns8 proc_id) {
+  uns num_lines = (uc->blk_uops + UOP_CACHE_LINE_UOPS - 1) /
+                  UOP_CACHE_LINE_UOPS;
+  if(num_lines > UOP_CACHE_BLOCK_LINES) {
+    STAT_EVENT(proc_id, UOP_CACHE_BLOCK_TOO_BIG);
+    return;
+  }
+
+  for(uns ii = 0; ii < num_lines; ii++) {
+    Addr            line_addr, repl_line_addr;
+    Addr            key  = uop_cache_key(uc, uc->blk_start, ii);
+    Uop_Cache_Data* data = (Uop_Cache_Data*)cache_access(&uc->cache, key,
+                                                         &line_addr, FALSE);
+    if(!data)
+      data = (Uop_Cache_Data*)cache_insert(&uc->cache, proc_id, key,
+                                           &line_addr, &repl_line_addr);
+    data->num_uops  = uc->blk_uops;
+    data->num_lines = num_lines;
+  }
+  STAT_EVENT(proc_id, UOP_CACHE_INSERT);
+}
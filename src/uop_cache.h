@@ -0,0 +1,63 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : uop_cache.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Decoded uop cache between the icache and decode. Fetch blocks
+ *                that hit are delivered without going through the decoders.
+ ***************************************************************************************/
+
+#ifndef __UOP_CACHE_H__
+#define __UOP_CACHE_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Forward Declarations */
+
+struct Op_struct;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Initialize the uop caches of every core */
+void init_uop_cache(void);
+
+/* Called before fetching at fetch_addr. Starts a new fetch block if needed and
+   returns TRUE if the block is delivered by the uop cache. Sets *switched if
+   the block is on a different path than the previous one. */
+Flag uop_cache_fetch(uns8 proc_id, Addr fetch_addr, Flag* switched);
+
+/* Maximum ops per fetch packet on the current path */
+uns uop_cache_fetch_width(uns8 proc_id);
+
+/* Report an op fetched into the current block. Returns TRUE if the op ends
+   the block, in which case the fetch packet must end after it. */
+Flag uop_cache_fetch_op(uns8 proc_id, struct Op_struct* op);
+
+/* Report the ops delivered in a fetch cycle */
+void uop_cache_fetch_cycle(uns8 proc_id, uns op_count);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __UOP_CACHE_H__ */
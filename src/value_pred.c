@@ -0,0 +1,279 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : value_pred.c
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Load value and load address prediction. Confident predictions
+ *                made at map release the consumers of a load, or the load
+ *                itself, before the producer completes; wrong predictions are
+ *                replayed.
+ ***************************************************************************************/
+
+#include "debug/debug_macros.h"
+#include "debug/debug_print.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "statistics.h"
+#include "value_pred.h"
+
+/*
+   One PC-indexed table serves both predictors. Each entry remembers the
+   address of the last instance of the load, the stride between the last two
+   instances and two confidence counters. A prediction is only used once its
+   counter saturates, and a wrong outcome resets the counter.
+
+   - load address prediction: the next address is last address + stride.
+   - load value prediction: last value. The frontends do not carry data
+     values, so a load is considered to return its last value when it reads
+     the same address as its last instance and no store has written the
+     address since. Stores record their op_num in a hashed table of 8-byte
+     granules for this check.
+
+   The tables are trained in order at map with the oracle outcome, which
+   models a predictor whose speculative history is always repaired. Only
+   on-path ops are predicted.
+
+   The outcome of a prediction is known at map, but it only takes effect in
+   the dataflow: a correct value prediction clears the not ready bits of the
+   consumers of the load, a correct address prediction clears the address
+   source bits of the load. A wrong prediction is discovered when the
+   producer completes, and the ops that used the wrong value or address are
+   replayed VALUE_PRED_REPLAY_CYCLES later.
+*/
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_VALUE_PRED, ##args)
+
+#define VP_GRANULE_BITS 3
+#define VP_MAX_GRANULES 64
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Value_Pred_Entry_struct {
+  Addr    pc;          /* tag */
+  Addr    last_addr;   /* address of the last instance */
+  Addr    stride;      /* address difference of the last two instances */
+  Counter last_op_num; /* op_num of the last instance */
+  uns     addr_conf;
+  uns     value_conf;
+} Value_Pred_Entry;
+
+typedef struct Value_Pred_struct {
+  Value_Pred_Entry* table;
+  Counter*          stores; /* op_num of the last store to each granule */
+} Value_Pred;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Value_Pred* value_preds = NULL;
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static uns  vp_index(Addr pc);
+static uns  vp_store_index(Addr granule);
+static uns  vp_num_granules(Op* op);
+static void vp_record_store(Value_Pred* vp, Op* op);
+static Flag vp_stored_since(Value_Pred* vp, Op* op, Counter op_num);
+
+/**************************************************************************************/
+/* init_value_pred: */
+
+void init_value_pred(void) {
+  if(!VALUE_PRED_ON && !ADDR_PRED_ON)
+    return;
+
+  ASSERTM(0, (VALUE_PRED_ENTRIES & (VALUE_PRED_ENTRIES - 1)) == 0,
+          "VALUE_PRED_ENTRIES must be a power of two\n");
+  ASSERTM(0,
+          (VALUE_PRED_STORE_ENTRIES & (VALUE_PRED_STORE_ENTRIES - 1)) == 0,
+          "VALUE_PRED_STORE_ENTRIES must be a power of two\n");
+  ASSERT(0, VALUE_PRED_CONF_BITS > 0 && VALUE_PRED_CONF_BITS < 32);
+
+  value_preds = (Value_Pred*)calloc(NUM_CORES, sizeof(Value_Pred));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Value_Pred* vp = &value_preds[proc_id];
+    vp->table      = (Value_Pred_Entry*)calloc(VALUE_PRED_ENTRIES,
+                                          sizeof(Value_Pred_Entry));
+    vp->stores     = (Counter*)calloc(VALUE_PRED_STORE_ENTRIES,
+                                  sizeof(Counter));
+  }
+}
+
+/**************************************************************************************/
+/* vp_index: */
+
+static uns vp_index(Addr pc) {
+  return (pc ^ (pc >> LOG2(VALUE_PRED_ENTRIES))) &
+         N_BIT_MASK(LOG2(VALUE_PRED_ENTRIES));
+}
+
+/**************************************************************************************/
+/* vp_store_index: */
+
+static uns vp_store_index(Addr granule) {
+  return (granule ^ (granule >> LOG2(VALUE_PRED_STORE_ENTRIES))) &
+         N_BIT_MASK(LOG2(VALUE_PRED_STORE_ENTRIES));
+}
+
+/**************************************************************************************/
+/* vp_num_granules: granules touched by a memory op, capped for long string
+   operations */
+
+static uns vp_num_granules(Op* op) {
+  Addr first = op->oracle_info.va >> VP_GRANULE_BITS;
+  Addr last  = (op->oracle_info.va + MAX2(op->oracle_info.mem_size, 1) - 1) >>
+              VP_GRANULE_BITS;
+  return MIN2(last - first + 1, VP_MAX_GRANULES);
+}
+
+/**************************************************************************************/
+/* vp_record_store: */
+
+static void vp_record_store(Value_Pred* vp, Op* op) {
+  Addr granule = op->oracle_info.va >> VP_GRANULE_BITS;
+  uns  count   = vp_num_granules(op);
+
+  for(uns ii = 0; ii < count; ii++)
+    vp->stores[vp_store_index(granule + ii)] = op->op_num;
+}
+
+/**************************************************************************************/
+/* vp_stored_since: returns TRUE if a store may have written the data of the
+   load after op_num */
+
+static Flag vp_stored_since(Value_Pred* vp, Op* op, Counter op_num) {
+  Addr granule = op->oracle_info.va >> VP_GRANULE_BITS;
+  uns  count   = vp_num_granules(op);
+
+  for(uns ii = 0; ii < count; ii++) {
+    if(vp->stores[vp_store_index(granule + ii)] > op_num)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/**************************************************************************************/
+/* value_pred_map: */
+
+void value_pred_map(Op* op) {
+  if(op->off_path)
+    return;
+
+  Value_Pred* vp = &value_preds[op->proc_id];
+  if(op->table_info->mem_type == MEM_ST) {
+    vp_record_store(vp, op);
+    return;
+  }
+  if(op->table_info->mem_type != MEM_LD)
+    return;
+
+  Addr              pc       = op->inst_info->addr;
+  Addr              va       = op->oracle_info.va;
+  uns               max_conf = N_BIT_MASK(VALUE_PRED_CONF_BITS);
+  Value_Pred_Entry* entry    = &vp->table[vp_index(pc)];
+
+  if(entry->pc != pc) {
+    entry->pc          = pc;
+    entry->last_addr   = va;
+    entry->stride      = 0;
+    entry->last_op_num = op->op_num;
+    entry->addr_conf   = 0;
+    entry->value_conf  = 0;
+    return;
+  }
+
+  if(ADDR_PRED_ON) {
+    Flag correct = entry->last_addr + entry->stride == va;
+    STAT_EVENT(op->proc_id, ADDR_PRED_LOADS);
+    if(entry->addr_conf == max_conf) {
+      op->addr_pred = correct ? VP_PRED_CORRECT : VP_PRED_WRONG;
+      STAT_EVENT(op->proc_id, ADDR_PRED_PREDICTED);
+      STAT_EVENT(op->proc_id, correct ? ADDR_PRED_CORRECT : ADDR_PRED_WRONG);
+    }
+    entry->addr_conf = correct ? MIN2(entry->addr_conf + 1, max_conf) : 0;
+  }
+
+  if(VALUE_PRED_ON && op->table_info->num_dest_regs) {
+    Flag correct = entry->last_addr == va &&
+                   !vp_stored_since(vp, op, entry->last_op_num);
+    STAT_EVENT(op->proc_id, VALUE_PRED_LOADS);
+    if(entry->value_conf == max_conf) {
+      op->value_pred = correct ? VP_PRED_CORRECT : VP_PRED_WRONG;
+      STAT_EVENT(op->proc_id, VALUE_PRED_PREDICTED);
+      STAT_EVENT(op->proc_id, correct ? VALUE_PRED_CORRECT : VALUE_PRED_WRONG);
+    }
+    entry->value_conf = correct ? MIN2(entry->value_conf + 1, max_conf) : 0;
+  }
+
+  DEBUG(op->proc_id, "Load op_num:%s va:%s addr_pred:%d value_pred:%d\n",
+        unsstr64(op->op_num), hexstr64s(va), op->addr_pred, op->value_pred);
+
+  entry->stride      = va - entry->last_addr;
+  entry->last_addr   = va;
+  entry->last_op_num = op->op_num;
+}
+
+/**************************************************************************************/
+/* value_pred_early_ready: */
+
+Flag value_pred_early_ready(Op* src_op, Op* dep_op) {
+  if(src_op->value_pred == VP_PRED_CORRECT) {
+    STAT_EVENT(dep_op->proc_id, VALUE_PRED_EARLY_WAKE);
+    return TRUE;
+  }
+  if(dep_op->addr_pred == VP_PRED_CORRECT) {
+    STAT_EVENT(dep_op->proc_id, ADDR_PRED_EARLY_WAKE);
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/**************************************************************************************/
+/* value_pred_wake: */
+
+void value_pred_wake(Op* src_op, Op* dep_op) {
+  if(src_op->value_pred == VP_PRED_WRONG) {
+    STAT_EVENT(dep_op->proc_id, VALUE_PRED_REPLAY);
+  } else if(dep_op->addr_pred == VP_PRED_WRONG) {
+    STAT_EVENT(dep_op->proc_id, ADDR_PRED_REPLAY);
+  } else {
+    return;
+  }
+
+  DEBUG(dep_op->proc_id, "Replay op_num:%s src op_num:%s wake:%s\n",
+        unsstr64(dep_op->op_num), unsstr64(src_op->op_num),
+        unsstr64(src_op->wake_cycle));
+  dep_op->rdy_cycle = MAX2(dep_op->rdy_cycle,
+                           src_op->wake_cycle + VALUE_PRED_REPLAY_CYCLES);
+}
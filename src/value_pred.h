@@ -0,0 +1,69 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : value_pred.h
+ * Author       : HPS Research Group
+ * Date         : 10/18/2026
+ * Description  : Load value and load address prediction. Confident predictions
+ *                made at map release the consumers of a load, or the load
+ *                itself, before the producer completes; wrong predictions are
+ *                replayed.
+ ***************************************************************************************/
+
+#ifndef __VALUE_PRED_H__
+#define __VALUE_PRED_H__
+
+#include "globals/global_types.h"
+#include "op.h"
+
+/**************************************************************************************/
+/* Types */
+
+/* outcome of a prediction, kept in op->value_pred and op->addr_pred */
+typedef enum Value_Pred_Outcome_enum {
+  VP_PRED_NONE,    /* no confident prediction was made */
+  VP_PRED_CORRECT, /* confident and correct */
+  VP_PRED_WRONG,   /* confident and wrong, verified at execute */
+} Value_Pred_Outcome;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Allocate the prediction tables of every core */
+void init_value_pred(void);
+
+/* Predict the value and the address of a load, or record a store. Call in
+   the map stage before the wake up lists of the op are set. */
+void value_pred_map(Op* op);
+
+/* Returns TRUE if dep_op does not need to wait for its register source
+   src_op: either the value of src_op or the address of dep_op was predicted
+   correctly. */
+Flag value_pred_early_ready(Op* src_op, Op* dep_op);
+
+/* Called when src_op wakes up dep_op through a register dependence. Charges
+   the replay of a wrong value or address prediction. */
+void value_pred_wake(Op* src_op, Op* dep_op);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __VALUE_PRED_H__ */